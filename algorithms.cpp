@@ -2,13 +2,88 @@
 
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <iostream>
+#include <memory>
 #include <ostream>
+#include <random>
 #include "algorithms.h"
+#include "local_search.h"
 #include "dataset.h"
+#include "dataset_catalog.h"
+#include "solver_stats.h"
+#include "trace.h"
 
 using namespace std;
 
+/**
+ * @struct BnBNode
+ * @brief A node of the branch-and-bound search tree.
+ */
+struct BnBNode {
+    unsigned int level;          ///< Position in the ratio order of the next item to decide
+    unsigned int value;
+    unsigned int weight;
+    unsigned int numItems;
+    unsigned long long sumIds;
+    bool took;                   ///< Decision taken for the item at level - 1
+    double bound;
+};
+
+/**
+ * @struct SolverScratch
+ * @brief Working memory of the DP and branch-and-bound solvers.
+ *
+ * One instance exists per thread; solvers resize (never shrink) the buffers they need, so a
+ * thread that solves many instances, e.g. a batch worker, stops allocating after the first few.
+ */
+struct SolverScratch {
+    vector<unsigned int> maxValue;
+    vector<unsigned int> minCount;
+    vector<unsigned int> minSumIDs;
+    vector<unsigned int> order;
+    vector<unsigned long long> prefixWeight;
+    vector<unsigned long long> prefixValue;
+    vector<BnBNode> stack;
+};
+
+static thread_local SolverScratch solverScratch;
+
+/**
+ * @brief Frees the scratch buffers held by the calling thread if they hold more than keepBytes.
+ *
+ * @param keepBytes Capacity the thread may keep for its next solve.
+ */
+void releaseSolverScratch(size_t keepBytes) {
+    const SolverScratch& s = solverScratch;
+    size_t bytes = (s.maxValue.capacity() + s.minCount.capacity() + s.minSumIDs.capacity() + s.order.capacity()) *
+                       sizeof(unsigned int) +
+                   (s.prefixWeight.capacity() + s.prefixValue.capacity()) * sizeof(unsigned long long) +
+                   s.stack.capacity() * sizeof(BnBNode);
+    if (bytes > keepBytes) solverScratch = SolverScratch();
+}
+
+/**
+ * @brief Ends a cancelled run with the best solution known: the partial one the solver left in
+ * usedItems, or the greedy solution if that is better.
+ *
+ * @param value Value of the solution in usedItems.
+ * @param status Optional output, set to Cancelled.
+ * @return Value of the solution left in usedItems.
+ */
+static unsigned int keepBestKnown(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                                  bool usedItems[], unsigned int value, SolveStatus* status) {
+    if (status != nullptr) *status = SolveStatus::Cancelled;
+    unique_ptr<bool[]> greedy(new bool[n]());
+    unsigned int greedyValue = knapsackGreedy(values, weights, n, maxWeight, greedy.get());
+    if (greedyValue <= value) return value;
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = greedy[i];
+    }
+    return greedyValue;
+}
+
 /**
  * @brief Brute-force solution for the 0/1 Knapsack problem.
  * 
@@ -21,24 +96,35 @@ using namespace std;
  * @param n Total number of items.
  * @param maxWeight The maximum total weight the knapsack can carry.
  * @param usedItems Output array indicating which items are selected in the optimal solution.
+ * @param cancel Optional token polled every 4096 subsets.
+ * @param status Optional output: Optimal, or Cancelled (best subset enumerated so far, or the
+ * greedy solution if better, returned).
  * @return The maximum total value for the given constraints.
  */
-unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]) {
+unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                        const CancellationToken* cancel, SolveStatus* status) {
     bool curCandidate[4097];  // all initialized to false
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Solve);
     unsigned int maxValue = 0;
     unsigned int bestNumItems = n + 1;
     unsigned int bestSumPallets = UINT_MAX;
     bool foundSol = false;
+    unsigned long long enumerated = 0;
 
     for (unsigned int i = 0; i < n; i++) {
         curCandidate[i] = false;
     }
 
     while (true) {
+        if ((++enumerated & 4095) == 0 && cancel != nullptr && cancel->isCancelled()) {
+            return keepBestKnown(values, weights, n, maxWeight, usedItems, maxValue, status);
+        }
         unsigned int totalValue = 0;
         unsigned int totalWeight = 0;
         unsigned int numItems = 0;
         unsigned int sumPallets = 0;
+        recorder.subsets(1);
 
         for (unsigned int k = 0; k < n; k++) {
             if (curCandidate[k]) {
@@ -57,6 +143,7 @@ unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned
                 maxValue = totalValue;
                 bestNumItems = numItems;
                 bestSumPallets = sumPallets;
+                recorder.incumbentUpdated();
 
                 for (unsigned int k = 0; k < n; k++) {
                     usedItems[k] = curCandidate[k];
@@ -77,12 +164,7 @@ unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned
         curCandidate[curIndex] = true;
     }
 
-    for (unsigned int i = 0; i < n; i++) {
-        if (usedItems[i]) {
-            cout << i + 1 << endl;
-        }
-    }
-
+    if (status != nullptr) *status = SolveStatus::Optimal;
     return maxValue;
 }
 
@@ -96,6 +178,9 @@ unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned
  * @param n Number of items.
  * @param maxWeight Maximum allowable total weight.
  * @param usedItems Output array indicating selected items.
+ * @param cancel Optional token polled once per DP row.
+ * @param status Optional output: Optimal, or Cancelled (optimum over the rows filled so far, or
+ * the greedy solution if better, returned).
  * @return Maximum value that can be obtained.
  */
 unsigned int knapsackDP(
@@ -103,8 +188,15 @@ unsigned int knapsackDP(
     unsigned int weights[],
     unsigned int n,
     unsigned int maxWeight,
-    bool usedItems[])
+    bool usedItems[],
+    const CancellationToken* cancel,
+    SolveStatus* status)
 {
+    if (n == 0) {
+        if (status != nullptr) *status = SolveStatus::Optimal;
+        return 0;
+    }
+
     // DP arrays
     // maxValue[i][w]: max value for first i items and capacity w
     // minCount[i][w]: min number of items for maxValue[i][w]
@@ -112,6 +204,9 @@ unsigned int knapsackDP(
     unsigned int maxValue[100][1000];
     unsigned int minCount[100][1000];
     unsigned int minSumIDs[100][1000];
+    SolverStatsRecorder recorder;
+    recorder.memory(sizeof(maxValue) + sizeof(minCount) + sizeof(minSumIDs));
+    recorder.phase(SolverPhase::Preprocess);
 
     // Initialize for first item
     for (unsigned int w = 0; w <= maxWeight; w++) {
@@ -126,8 +221,17 @@ unsigned int knapsackDP(
         }
     }
 
-    // Fill dp for other items
+    // Fill dp for other items; a cancelled run keeps the rows filled so far
+    recorder.phase(SolverPhase::Solve);
+    TraceBlocks rows("dp rows", "dp", 64);
+    unsigned int filled = n;
     for (unsigned int i = 1; i < n; i++) {
+        rows.step(i - 1);
+        if (cancel != nullptr && cancel->isCancelled()) {
+            filled = i;
+            break;
+        }
+        recorder.cells(maxWeight + 1);
         for (unsigned int w = 0; w <= maxWeight; w++) {
             // Option 1: don't take item i
             unsigned int val1 = maxValue[i - 1][w];
@@ -160,13 +264,16 @@ unsigned int knapsackDP(
         }
     }
 
+    rows.finish();
+
     // Backtracking
+    recorder.phase(SolverPhase::Reconstruct);
     for (unsigned int i = 0; i < n; i++) {
         usedItems[i] = false;
     }
 
     unsigned int w = maxWeight;
-    for (int i = n - 1; i > 0; i--) {
+    for (int i = filled - 1; i > 0; i--) {
         if (w == 0) break;
 
         if (maxValue[i][w] != maxValue[i - 1][w] ||
@@ -182,27 +289,27 @@ unsigned int knapsackDP(
         usedItems[0] = true;
     }
 
-    // Print chosen items (1-based indexing)
-    cout << "Selected items (1-based indices):" << endl;
-    for (unsigned int i = 0; i < n; i++) {
-        if (usedItems[i]) {
-            cout << (i + 1) << endl;
-        }
+    if (filled < n) {
+        return keepBestKnown(values, weights, n, maxWeight, usedItems, maxValue[filled - 1][maxWeight], status);
     }
-
+    if (status != nullptr) *status = SolveStatus::Optimal;
     return maxValue[n - 1][maxWeight];
 }
 
 /**
  * @brief Dynamic programming solution using vectors instead of static arrays.
  * 
- * Functionally similar to knapsackDP but uses std::vector for flexibility.
+ * Functionally similar to knapsackDP but uses std::vector for flexibility. The tables live in
+ * per-thread scratch buffers, so repeated solves on the same thread reuse their memory.
  * 
  * @param values Array of item values.
  * @param weights Array of item weights.
  * @param n Number of items.
  * @param maxWeight Maximum allowable total weight.
  * @param usedItems Output array indicating selected items.
+ * @param cancel Optional token polled once per DP row.
+ * @param status Optional output: Optimal, or Cancelled (optimum over the rows filled so far, or
+ * the greedy solution if better, returned).
  * @return Maximum value that can be obtained.
  */
 
@@ -211,255 +318,901 @@ unsigned int knapsackDP1(
     unsigned int weights[],
     unsigned int n,
     unsigned int maxWeight,
-    bool usedItems[])
+    bool usedItems[],
+    const CancellationToken* cancel,
+    SolveStatus* status)
 {
-    // DP tables
-    vector<vector<unsigned int>> maxValue(n, vector<unsigned int>(maxWeight + 1, 0));
-    vector<vector<unsigned int>> minCount(n, vector<unsigned int>(maxWeight + 1, UINT_MAX));
-    vector<vector<unsigned int>> minSumIDs(n, vector<unsigned int>(maxWeight + 1, UINT_MAX));
+    if (n == 0) {
+        if (status != nullptr) *status = SolveStatus::Optimal;
+        return 0;
+    }
+
+    // DP tables, stored row-major in this thread's reusable scratch buffers
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    size_t cols = (size_t) maxWeight + 1;
+    recorder.memory(3ULL * n * cols * sizeof(unsigned int));
+    solverScratch.maxValue.assign(n * cols, 0);
+    solverScratch.minCount.assign(n * cols, UINT_MAX);
+    solverScratch.minSumIDs.assign(n * cols, UINT_MAX);
+    auto maxValue = [&](unsigned int i) { return &solverScratch.maxValue[i * cols]; };
+    auto minCount = [&](unsigned int i) { return &solverScratch.minCount[i * cols]; };
+    auto minSumIDs = [&](unsigned int i) { return &solverScratch.minSumIDs[i * cols]; };
 
     // Initialize first row
     for (unsigned int k = 0; k <= maxWeight; k++) {
         if (k >= weights[0]) {
-            maxValue[0][k] = values[0];
-            minCount[0][k] = 1;
-            minSumIDs[0][k] = 0; // pallet id 0 for first item
+            maxValue(0)[k] = values[0];
+            minCount(0)[k] = 1;
+            minSumIDs(0)[k] = 0; // pallet id 0 for first item
         } else {
-            maxValue[0][k] = 0;
-            minCount[0][k] = 0;
-            minSumIDs[0][k] = UINT_MAX;
+            maxValue(0)[k] = 0;
+            minCount(0)[k] = 0;
+            minSumIDs(0)[k] = UINT_MAX;
         }
     }
 
     // Initialize minCount for k=0 in other rows
     for (unsigned int i = 1; i < n; i++) {
-        maxValue[i][0] = 0;
-        minCount[i][0] = 0;
-        minSumIDs[i][0] = UINT_MAX;
+        maxValue(i)[0] = 0;
+        minCount(i)[0] = 0;
+        minSumIDs(i)[0] = UINT_MAX;
     }
 
-    // Fill DP tables with tie-breaks
+    // Fill DP tables with tie-breaks; a cancelled run keeps the rows filled so far
+    recorder.phase(SolverPhase::Solve);
+    TraceBlocks rows("dp rows", "dp", 64);
+    unsigned int filled = n;
     for (unsigned int i = 1; i < n; i++) {
+        rows.step(i - 1);
+        if (cancel != nullptr && cancel->isCancelled()) {
+            filled = i;
+            break;
+        }
+        recorder.cells(maxWeight);
         for (unsigned int k = 1; k <= maxWeight; k++) {
             if (k < weights[i]) {
-                maxValue[i][k] = maxValue[i - 1][k];
-                minCount[i][k] = minCount[i - 1][k];
-                minSumIDs[i][k] = minSumIDs[i - 1][k];
+                maxValue(i)[k] = maxValue(i - 1)[k];
+                minCount(i)[k] = minCount(i - 1)[k];
+                minSumIDs(i)[k] = minSumIDs(i - 1)[k];
             } else {
-                unsigned int valUsing = maxValue[i - 1][k - weights[i]] + values[i];
-                unsigned int cntUsing = minCount[i - 1][k - weights[i]] + 1;
-                unsigned int sumUsing = minSumIDs[i - 1][k - weights[i]] + i;
+                unsigned int valUsing = maxValue(i - 1)[k - weights[i]] + values[i];
+                unsigned int cntUsing = minCount(i - 1)[k - weights[i]] + 1;
+                unsigned int sumUsing = minSumIDs(i - 1)[k - weights[i]] + i;
 
-                unsigned int valNotUsing = maxValue[i - 1][k];
-                unsigned int cntNotUsing = minCount[i - 1][k];
-                unsigned int sumNotUsing = minSumIDs[i - 1][k];
+                unsigned int valNotUsing = maxValue(i - 1)[k];
+                unsigned int cntNotUsing = minCount(i - 1)[k];
+                unsigned int sumNotUsing = minSumIDs(i - 1)[k];
 
                 // Tie-break logic:
                 if (valUsing > valNotUsing ||
                     (valUsing == valNotUsing && cntUsing < cntNotUsing) ||
                     (valUsing == valNotUsing && cntUsing == cntNotUsing && sumUsing < sumNotUsing)) {
-                    maxValue[i][k] = valUsing;
-                    minCount[i][k] = cntUsing;
-                    minSumIDs[i][k] = sumUsing;
+                    maxValue(i)[k] = valUsing;
+                    minCount(i)[k] = cntUsing;
+                    minSumIDs(i)[k] = sumUsing;
                 } else {
-                    maxValue[i][k] = valNotUsing;
-                    minCount[i][k] = cntNotUsing;
-                    minSumIDs[i][k] = sumNotUsing;
+                    maxValue(i)[k] = valNotUsing;
+                    minCount(i)[k] = cntNotUsing;
+                    minSumIDs(i)[k] = sumNotUsing;
                 }
             }
         }
     }
 
+    rows.finish();
+
     // Backtrack to find used items
+    recorder.phase(SolverPhase::Reconstruct);
     for (unsigned int i = 0; i < n; i++) {
         usedItems[i] = false;
     }
     unsigned int remainingWeight = maxWeight;
-    for (int i = n - 1; i > 0; i--) {
+    for (int i = filled - 1; i > 0; i--) {
         if (remainingWeight == 0) break;
 
         // Check if item i was used by comparing values and tie-break arrays
-        if (maxValue[i][remainingWeight] != maxValue[i - 1][remainingWeight] ||
-            minCount[i][remainingWeight] != minCount[i - 1][remainingWeight] ||
-            minSumIDs[i][remainingWeight] != minSumIDs[i - 1][remainingWeight]) {
+        if (maxValue(i)[remainingWeight] != maxValue(i - 1)[remainingWeight] ||
+            minCount(i)[remainingWeight] != minCount(i - 1)[remainingWeight] ||
+            minSumIDs(i)[remainingWeight] != minSumIDs(i - 1)[remainingWeight]) {
             usedItems[i] = true;
             remainingWeight -= weights[i];
         }
     }
-    if (remainingWeight >= weights[0] && maxValue[0][remainingWeight] > 0) {
+    if (remainingWeight >= weights[0] && maxValue(0)[remainingWeight] > 0) {
         usedItems[0] = true;
     }
 
-    // Print chosen items 1-based
-    for (unsigned int i = 0; i < n; i++) {
-        if (usedItems[i]) cout << (i + 1) << endl;
+    if (filled < n) {
+        return keepBestKnown(values, weights, n, maxWeight, usedItems, maxValue(filled - 1)[maxWeight], status);
     }
-
-    return maxValue[n - 1][maxWeight];
+    if (status != nullptr) *status = SolveStatus::Optimal;
+    return maxValue(n - 1)[maxWeight];
 }
 
 /**
- * @brief Comparator for sorting Pallet items by profit-to-weight ratio.
- * 
- * @param a First pallet
- * @param b Second pallet
- * @return True if a has a better ratio than b
+ * @brief Returns true if item a has a strictly better profit-to-weight ratio than item b.
+ *
+ * Uses exact integer cross-multiplication, so no floating-point division is involved.
  */
-bool compare(const Pallet& a, const Pallet& b) {
-    double r1 = (double)a.profit / a.weight;
-    double r2 = (double)b.profit / b.weight;
-    return r1 > r2;
+static bool betterRatio(unsigned int values[], unsigned int weights[], unsigned int a, unsigned int b) {
+    return (unsigned long long)values[a] * weights[b] > (unsigned long long)values[b] * weights[a];
 }
 
 /**
  * @brief Greedy approximation algorithm for the knapsack problem.
- * 
- * Selects items by highest value-to-weight ratio until capacity is full.
- * 
- * @param pallets Vector of Pallet items.
+ *
+ * Instead of sorting all items by profit-to-weight ratio, the critical item (the first item,
+ * in ratio order, that no longer fits) is located with a Balas-Zemel style randomized
+ * partitioning in O(n) expected time: every round partitions the candidate range around a
+ * random pivot ratio, takes the whole better part if it fits and otherwise recurses into it.
+ * Ratios are compared exactly by integer cross-multiplication.
+ *
+ * The items before the critical item form the split solution; the residual capacity is then
+ * filled with any remaining items that fit. The result is the better of this solution and the
+ * most profitable single item, which is guaranteed to be at least half of the optimum.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
  * @param n Number of items.
  * @param maxWeight Maximum allowed weight.
  * @param usedItems Output array indicating selected items.
  * @return Total profit achieved by the greedy algorithm.
  */
-unsigned int knapsackGreedy(vector<Pallet> pallets, unsigned int n, unsigned int maxWeight, bool usedItems[]) {
-    sort(pallets.begin(), pallets.end(), compare);
-    unsigned int maxValue = 0;
-    unsigned int idx = 0;
+unsigned int knapsackGreedy(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]) {
+    // Candidate items: only those that fit on their own
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    vector<unsigned int> idx;
+    idx.reserve(n);
+    unsigned int bestSingle = n;
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = false;
+        if (weights[i] <= maxWeight) {
+            idx.push_back(i);
+            if (bestSingle == n || values[i] > values[bestSingle]) bestSingle = i;
+        }
+    }
+
+    recorder.memory(idx.capacity() * sizeof(unsigned int));
+    recorder.phase(SolverPhase::Solve);
+    unsigned long long capacityLeft = maxWeight;
+    unsigned long long maxValue = 0;
+    unsigned int lo = 0, hi = idx.size();
+    minstd_rand rng(12345);
+    bool criticalFound = false;
+
+    while (lo < hi && !criticalFound) {
+        unsigned int pivot = idx[lo + rng() % (hi - lo)];
+
+        // Three-way partition of [lo, hi): better than pivot | equal ratio | worse
+        unsigned int lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            if (betterRatio(values, weights, idx[i], pivot)) {
+                swap(idx[lt++], idx[i++]);
+            } else if (betterRatio(values, weights, pivot, idx[i])) {
+                swap(idx[i], idx[--gt]);
+            } else {
+                i++;
+            }
+        }
 
-    while (maxWeight > 0 && idx < n) {
-        if (pallets[idx].weight <= maxWeight) {
-            maxValue += pallets[idx].profit;
-            maxWeight -= pallets[idx].weight;
-            usedItems[pallets[idx].pallet] = true;
+        unsigned long long betterWeight = 0;
+        for (unsigned int k = lo; k < lt; k++) betterWeight += weights[idx[k]];
+        if (betterWeight > capacityLeft) {
+            // The critical item is among the better items
+            hi = lt;
+            continue;
         }
-        idx++;
+
+        // Take every better item, then equal-ratio items until one does not fit
+        for (unsigned int k = lo; k < lt; k++) {
+            usedItems[idx[k]] = true;
+            maxValue += values[idx[k]];
+        }
+        capacityLeft -= betterWeight;
+        for (unsigned int k = lt; k < gt; k++) {
+            if (weights[idx[k]] > capacityLeft) {
+                criticalFound = true;
+                break;
+            }
+            usedItems[idx[k]] = true;
+            maxValue += values[idx[k]];
+            capacityLeft -= weights[idx[k]];
+        }
+        lo = gt;
     }
 
-    cout << "Selected pallets IDs:" << endl;
-    for (unsigned int i = 0; i < n; i++) {
-        if (usedItems[i]) {
-            cout << i + 1 << endl;
+    // Fill the residual capacity with the remaining items that still fit
+    for (unsigned int k = 0; k < idx.size() && capacityLeft > 0; k++) {
+        unsigned int item = idx[k];
+        if (!usedItems[item] && weights[item] <= capacityLeft) {
+            usedItems[item] = true;
+            maxValue += values[item];
+            capacityLeft -= weights[item];
         }
     }
 
+    // 1/2-approximation: the best single item may beat the greedy solution
+    if (bestSingle != n && values[bestSingle] > maxValue) {
+        for (unsigned int i = 0; i < n; i++) usedItems[i] = false;
+        usedItems[bestSingle] = true;
+        maxValue = values[bestSingle];
+    }
+
     return maxValue;
 }
 
+/**
+ * @brief Returns true if (value, numItems, sumIds) is preferred over the best solution so far.
+ *
+ * Higher value wins; on equal value fewer items win; then the lower sum of indices.
+ */
+static bool preferredSolution(unsigned int value, unsigned int numItems, unsigned long long sumIds,
+                              unsigned int bestValue, unsigned int bestNumItems, unsigned long long bestSumIds) {
+    return value > bestValue
+        || (value == bestValue && numItems < bestNumItems)
+        || (value == bestValue && numItems == bestNumItems && sumIds < bestSumIds);
+}
+
+/**
+ * @brief Builds a greedy solution by taking items in the given ratio order while they fit.
+ *
+ * @param order Item indices sorted by decreasing profit-to-weight ratio.
+ * @param used Output array marking the chosen items.
+ * @return Total value of the greedy solution.
+ */
+static unsigned int greedyIncumbent(unsigned int values[], unsigned int weights[], const vector<unsigned int>& order,
+                                    unsigned int maxWeight, bool used[]) {
+    unsigned int value = 0;
+    unsigned int remaining = maxWeight;
+    for (unsigned int idx : order) {
+        used[idx] = false;
+        if (weights[idx] <= remaining) {
+            used[idx] = true;
+            remaining -= weights[idx];
+            value += values[idx];
+        }
+    }
+    return value;
+}
+
 /**
  * @brief Branch-and-bound (ILP) solution to the 0/1 knapsack problem.
- * 
- * Prunes branches of the solution tree that cannot yield better results using upper-bound estimates.
- * 
+ *
+ * Items are branched on in decreasing profit-to-weight order and every node is bounded by the
+ * Dantzig (LP relaxation) bound, computed in O(log n) from prefix sums over that order.
+ * Before branching, the incumbent is seeded with the greedy solution (optionally polished by
+ * local search) and/or a caller-supplied solution, so pruning starts at the root.
+ *
+ * The search runs in anytime mode: every improving incumbent is reported through
+ * options.onImprove together with the current optimality gap, and the search stops early once
+ * options.timeLimit seconds or options.nodeLimit nodes are spent (or options.cancel is triggered),
+ * returning the best solution found.
+ *
+ * In the case of equal values, the solution with fewer items is preferred; if still equal,
+ * the one with the lower sum of indices.
+ *
  * @param values Array of item values.
  * @param weights Array of item weights.
  * @param n Number of items.
  * @param maxWeight Maximum allowable weight.
  * @param usedItems Output array marking selected items.
- * @return The optimal value found using branch-and-bound.
+ * @param options Warm start and anytime settings.
+ * @param stats Optional output with node count, optimality flag and final gap.
+ * @return The best value found using branch-and-bound (optimal unless a budget was hit).
  */
-unsigned int knapsackILP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]) {
-    struct Node {
-        unsigned int level;
-        unsigned int value;
-        unsigned int weight;
-        unsigned int decisionsMask;  // bit i = whether item i used
-        double bound;
-    };
+unsigned int knapsackILP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                         const ILPOptions& options, ILPStats* stats) {
+    typedef BnBNode Node;
 
-    // Compute bound for a node given decisions mask
-    auto computeBound = [&](unsigned int level, unsigned int currValue, unsigned int currWeight, unsigned int decisionsMask) -> double {
-        unsigned int totalWeight = currWeight;
-        double bound = (double) currValue;
+    auto start = chrono::steady_clock::now();
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
 
-        for (unsigned int i = level; i < n; i++) {
-            if ((decisionsMask & (1U << i)) != 0) continue;
-            if (totalWeight + weights[i] <= maxWeight) {
-                totalWeight += weights[i];
-                bound += values[i];
-            } else {
-                unsigned int remain = maxWeight - totalWeight;
-                bound += ((double)values[i] / weights[i]) * remain;
-                break;
-            }
+    // Branching order: decreasing profit-to-weight ratio, with prefix sums for the Dantzig bound
+    // (both precomputed when a catalog is bound to the columns; ties keep index order either way)
+    vector<unsigned int>& order = solverScratch.order;
+    vector<unsigned long long>& prefixWeight = solverScratch.prefixWeight;
+    vector<unsigned long long>& prefixValue = solverScratch.prefixValue;
+    const DatasetCatalog* catalog = boundCatalog(values, weights, n, maxWeight);
+    if (catalog != nullptr) {
+        order.assign(catalog->ratioOrder.begin(), catalog->ratioOrder.end());
+        prefixWeight.assign(catalog->prefixWeight.begin(), catalog->prefixWeight.end());
+        prefixValue.assign(catalog->prefixProfit.begin(), catalog->prefixProfit.end());
+    } else {
+        order.resize(n);
+        for (unsigned int i = 0; i < n; i++) order[i] = i;
+        stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+            return betterRatio(values, weights, a, b);
+        });
+        prefixWeight.assign(n + 1, 0);
+        prefixValue.assign(n + 1, 0);
+        for (unsigned int k = 0; k < n; k++) {
+            prefixWeight[k + 1] = prefixWeight[k] + weights[order[k]];
+            prefixValue[k + 1] = prefixValue[k] + values[order[k]];
+        }
+    }
+
+    // Dantzig bound: fill the remaining items in ratio order, then a fraction of the critical item
+    auto computeBound = [&](unsigned int level, unsigned int currValue, unsigned int currWeight) -> double {
+        recorder.boundEvaluated();
+        unsigned long long capacityLeft = maxWeight - currWeight;
+        // Largest k such that items level..k-1 all fit
+        unsigned int lo = level, hi = n;
+        while (lo < hi) {
+            unsigned int mid = lo + (hi - lo + 1) / 2;
+            if (prefixWeight[mid] - prefixWeight[level] <= capacityLeft) lo = mid;
+            else hi = mid - 1;
+        }
+        double bound = (double) currValue + (double) (prefixValue[lo] - prefixValue[level]);
+        if (lo < n) {
+            unsigned long long remain = capacityLeft - (prefixWeight[lo] - prefixWeight[level]);
+            bound += ((double) values[order[lo]] / weights[order[lo]]) * remain;
         }
         return bound;
     };
 
-    // Stack of nodes
-    vector<Node> stack;
+    unsigned int bestValue = 0;
+    unsigned int bestNumItems = 0;
+    unsigned long long bestSumIds = 0;
+    vector<bool> best(n, false);
+
+    // Seeds the incumbent with a candidate solution if it is feasible and preferred
+    auto offerIncumbent = [&](const bool candidate[]) {
+        unsigned long long totalWeight = 0;
+        unsigned int value = 0, numItems = 0;
+        unsigned long long sumIds = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            if (!candidate[i]) continue;
+            totalWeight += weights[i];
+            value += values[i];
+            numItems++;
+            sumIds += i;
+        }
+        if (totalWeight > maxWeight) return;
+        if (preferredSolution(value, numItems, sumIds, bestValue, bestNumItems, bestSumIds)) {
+            recorder.incumbentUpdated();
+            bestValue = value;
+            bestNumItems = numItems;
+            bestSumIds = sumIds;
+            for (unsigned int i = 0; i < n; i++) best[i] = candidate[i];
+        }
+    };
+
+    if (options.greedyWarmStart) {
+        vector<char> warm(n, 0);
+        bool* warmItems = reinterpret_cast<bool*>(warm.data());
+        greedyIncumbent(values, weights, order, maxWeight, warmItems);
+        if (options.improveIncumbent) {
+            localSearch(values, weights, n, maxWeight, warmItems);
+        }
+        offerIncumbent(warmItems);
+    }
+    if (options.incumbent != nullptr) {
+        offerIncumbent(options.incumbent);
+    }
+
+    // Stack of nodes, path[k] holds the decision for order[k] along the current branch
+    vector<Node>& stack = solverScratch.stack;
+    stack.clear();
+    vector<bool> path(n, false);
 
-    // Initialize root node
-    Node root = {0, 0, 0, 0, 0.0};
-    root.bound = computeBound(0, 0, 0, 0);
+    Node root = {0, 0, 0, 0, 0, false, 0.0};
+    root.bound = computeBound(0, 0, 0);
     stack.push_back(root);
+    recorder.nodeCreated();
 
-    unsigned int bestValue = 0;
-    unsigned int bestNumItems = UINT_MAX;
-    unsigned int bestSumIds = UINT_MAX;
-    unsigned int bestDecisionsMask = 0;
+    // Gap between the best open bound and the incumbent
+    auto currentGap = [&]() -> double {
+        double upper = bestValue;
+        for (const Node& node : stack) upper = max(upper, node.bound);
+        return upper > 0 ? (upper - bestValue) / upper : 0.0;
+    };
+
+    if (options.onImprove && bestValue > 0) {
+        options.onImprove(bestValue, currentGap());
+    }
+
+    unsigned long long nodes = 0;
+    bool stopped = false;
 
+    recorder.phase(SolverPhase::Solve);
+    TraceBlocks search("bnb nodes", "bnb", 65536);
     while (!stack.empty()) {
+        search.step(nodes);
+        if (options.nodeLimit != 0 && nodes >= options.nodeLimit) {
+            stopped = true;
+            break;
+        }
+        if (options.timeLimit > 0 && (nodes & 1023) == 0 &&
+            chrono::duration<double>(chrono::steady_clock::now() - start).count() >= options.timeLimit) {
+            stopped = true;
+            break;
+        }
+        if (options.cancel != nullptr && (nodes & 255) == 0 && options.cancel->isCancelled()) {
+            stopped = true;
+            break;
+        }
+
         Node node = stack.back();
         stack.pop_back();
+        nodes++;
+        if (node.level > 0) path[node.level - 1] = node.took;
 
-        if (node.level == n) {
-            // Count items and sum pallet IDs in decisionsMask
-            unsigned int numItems = 0;
-            unsigned int sumIds = 0;
-            for (unsigned int i = 0; i < n; i++) {
-                if ((node.decisionsMask & (1U << i)) != 0) {
-                    numItems++;
-                    sumIds += i;
-                }
-            }
+        // Prune (with a small tolerance so branches that may tie the incumbent are kept)
+        if (node.bound + 1e-9 < bestValue) {
+            recorder.nodePruned();
+            continue;
+        }
+        recorder.nodeExpanded();
 
-            if (node.value > bestValue
-                || (node.value == bestValue && numItems < bestNumItems)
-                || (node.value == bestValue && numItems == bestNumItems && sumIds < bestSumIds)) {
+        if (node.level == n) {
+            if (preferredSolution(node.value, node.numItems, node.sumIds, bestValue, bestNumItems, bestSumIds)) {
+                bool valueImproved = node.value > bestValue;
+                recorder.incumbentUpdated();
                 bestValue = node.value;
-                bestNumItems = numItems;
-                bestSumIds = sumIds;
-                bestDecisionsMask = node.decisionsMask;
+                bestNumItems = node.numItems;
+                bestSumIds = node.sumIds;
+                for (unsigned int k = 0; k < n; k++) best[order[k]] = path[k];
+                if (valueImproved && options.onImprove) {
+                    options.onImprove(bestValue, currentGap());
+                }
             }
             continue;
         }
 
-        // Prune
-        if (node.bound < bestValue) {
-            continue;
+        unsigned int item = order[node.level];
+
+        // Branch 2: Exclude current item (pushed first so the include branch is explored first)
+        Node withoutItem = node;
+        withoutItem.level = node.level + 1;
+        withoutItem.took = false;
+        withoutItem.bound = computeBound(withoutItem.level, withoutItem.value, withoutItem.weight);
+        if (withoutItem.bound + 1e-9 >= bestValue) {
+            stack.push_back(withoutItem);
+            recorder.nodeCreated();
+        } else {
+            recorder.nodePruned();
         }
 
         // Branch 1: Include current item if possible
-        if (node.weight + weights[node.level] <= maxWeight) {
+        if (node.weight + weights[item] <= maxWeight) {
             Node withItem;
             withItem.level = node.level + 1;
-            withItem.value = node.value + values[node.level];
-            withItem.weight = node.weight + weights[node.level];
-            withItem.decisionsMask = node.decisionsMask | (1U << node.level);
-            withItem.bound = computeBound(withItem.level, withItem.value, withItem.weight, withItem.decisionsMask);
-            if (withItem.bound >= bestValue) {
+            withItem.value = node.value + values[item];
+            withItem.weight = node.weight + weights[item];
+            withItem.numItems = node.numItems + 1;
+            withItem.sumIds = node.sumIds + item;
+            withItem.took = true;
+            withItem.bound = node.bound;  // taking an item that fits never changes the LP bound
+            if (withItem.bound + 1e-9 >= bestValue) {
                 stack.push_back(withItem);
+                recorder.nodeCreated();
+            } else {
+                recorder.nodePruned();
             }
         }
+    }
 
-        // Branch 2: Exclude current item
-        Node withoutItem;
-        withoutItem.level = node.level + 1;
-        withoutItem.value = node.value;
-        withoutItem.weight = node.weight;
-        withoutItem.decisionsMask = node.decisionsMask;
-        withoutItem.bound = computeBound(withoutItem.level, withoutItem.value, withoutItem.weight, withoutItem.decisionsMask);
-        if (withoutItem.bound >= bestValue) {
-            stack.push_back(withoutItem);
-        }
+    if (stats != nullptr) {
+        stats->nodes = nodes;
+        stats->optimal = !stopped;
+        stats->gap = stopped ? currentGap() : 0.0;
     }
 
-    // Fill usedItems from bestDecisionsMask
+    search.finish();
+
+    // Fill usedItems from the best solution
+    recorder.phase(SolverPhase::Reconstruct);
+    recorder.memory(stack.capacity() * sizeof(Node) + 2 * prefixWeight.capacity() * sizeof(unsigned long long) +
+                    order.capacity() * sizeof(unsigned int) + n / 4);
     for (unsigned int i = 0; i < n; i++) {
-        usedItems[i] = (bestDecisionsMask & (1U << i)) != 0;
-        if (usedItems[i]) cout << i + 1 << endl;
+        usedItems[i] = best[i];
     }
 
     return bestValue;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Fully polynomial approximation scheme (FPTAS) for the 0/1 knapsack problem.
+ *
+ * Profits are scaled down by K = εP/n and a profit-indexed DP computes, for every scaled
+ * profit q, the minimum weight that reaches it; the best q that fits is then reconstructed.
+ * P is the greedy lower bound on the optimum (at least the largest single profit), so the
+ * rounding loses at most nK = εP <= ε·OPT and the returned value is at least (1 - ε)·OPT.
+ * Using P instead of the largest profit bounds the DP by O(n/ε) columns, which keeps the
+ * memory at O(n²/ε) bits regardless of the capacity or the magnitude of the profits.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum allowable weight.
+ * @param epsilon Accuracy parameter, 0 < epsilon < 1.
+ * @param usedItems Output array marking selected items.
+ * @param upperBound Optional output with a proven upper bound on the optimal value.
+ * @param cancel Optional token polled once per DP row.
+ * @param status Optional output: Feasible, or Cancelled (best solution over the rows filled so
+ * far, or the greedy solution if better, returned; the guarantee no longer holds).
+ * @return Value of the approximate solution, at least (1 - epsilon) times the optimum.
+ */
+unsigned int knapsackFPTAS(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                           double epsilon, bool usedItems[], unsigned int* upperBound,
+                           const CancellationToken* cancel, SolveStatus* status) {
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = false;
+    }
+
+    // Ratio order for the greedy lower bound and the Dantzig upper bound (ties by index, as in
+    // the catalog, so a bound catalog never changes the result)
+    vector<unsigned int> order;
+    order.reserve(n);
+    const DatasetCatalog* catalog = boundCatalog(values, weights, n, maxWeight);
+    for (unsigned int k = 0; k < n; k++) {
+        unsigned int i = catalog != nullptr ? catalog->ratioOrder[k] : k;
+        if (weights[i] <= maxWeight && values[i] > 0) order.push_back(i);
+    }
+    if (catalog == nullptr) {
+        stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+            return betterRatio(values, weights, a, b);
+        });
+    }
+
+    unsigned long long lowerBound = 0;
+    unsigned long long bestSingle = 0;
+    double dantzig = 0.0;
+    unsigned long long filled = 0;
+    bool critical = false;
+    for (unsigned int idx : order) {
+        bestSingle = max(bestSingle, (unsigned long long) values[idx]);
+        if (critical) continue;
+        if (filled + weights[idx] <= maxWeight) {
+            filled += weights[idx];
+            lowerBound += values[idx];
+        } else {
+            dantzig = (double) lowerBound + (double) values[idx] * (maxWeight - filled) / weights[idx];
+            critical = true;
+        }
+    }
+    if (!critical) dantzig = (double) lowerBound;
+    lowerBound = max(lowerBound, bestSingle);
+
+    if (upperBound != nullptr) *upperBound = (unsigned int) dantzig;
+    if (status != nullptr) *status = SolveStatus::Feasible;
+    if (lowerBound == 0) return 0;
+
+    // Scaled profits and the number of DP columns (the optimum is at most the Dantzig bound)
+    unsigned int m = order.size();
+    double K = max(1.0, epsilon * (double) lowerBound / m);
+    vector<unsigned int> scaled(m);
+    for (unsigned int k = 0; k < m; k++) {
+        scaled[k] = (unsigned int) (values[order[k]] / K);
+    }
+    unsigned int Q = (unsigned int) (dantzig / K) + 1;
+
+    // minWeight[q]: minimum weight reaching scaled profit exactly q
+    // taken[k][q]: whether item order[k] is used in that solution (one bit per column)
+    const unsigned long long INF = ULLONG_MAX;
+    unsigned int words = Q / 64 + 1;
+    vector<unsigned long long> minWeight(Q + 1, INF);
+    vector<unsigned long long> taken((unsigned long long) m * words, 0);
+    minWeight[0] = 0;
+    recorder.memory(minWeight.size() * sizeof(unsigned long long) + taken.size() * sizeof(unsigned long long));
+
+    recorder.phase(SolverPhase::Solve);
+    unsigned int reach = 0;
+    bool cancelled = false;
+    for (unsigned int k = 0; k < m; k++) {
+        if (cancel != nullptr && cancel->isCancelled()) {
+            cancelled = true;
+            break;
+        }
+        unsigned int p = scaled[k];
+        if (p == 0) continue;
+        unsigned long long w = weights[order[k]];
+        unsigned long long* row = &taken[(unsigned long long) k * words];
+        reach = min(Q, reach + p);
+        if (reach >= p) recorder.cells(reach - p + 1);
+        for (unsigned int q = reach; q >= p && q > 0; q--) {
+            if (minWeight[q - p] != INF && minWeight[q - p] + w < minWeight[q] && minWeight[q - p] + w <= maxWeight) {
+                minWeight[q] = minWeight[q - p] + w;
+                row[q / 64] |= 1ULL << (q % 64);
+            }
+        }
+    }
+
+    unsigned int q = reach;
+    while (q > 0 && minWeight[q] == INF) q--;
+
+    // Backtracking
+    recorder.phase(SolverPhase::Reconstruct);
+    unsigned int maxValue = 0;
+    for (unsigned int k = m; k-- > 0 && q > 0;) {
+        if (taken[(unsigned long long) k * words + q / 64] & (1ULL << (q % 64))) {
+            usedItems[order[k]] = true;
+            maxValue += values[order[k]];
+            q -= scaled[k];
+        }
+    }
+
+    if (cancelled) return keepBestKnown(values, weights, n, maxWeight, usedItems, maxValue, status);
+    return maxValue;
+}
+
+/**
+ * @brief Meet-in-the-middle solution for the 0/1 knapsack problem.
+ *
+ * The items are split in two halves and all 2^(n/2) subsets of each half are enumerated. The
+ * second half is sorted by weight with a running best, so every subset of the first half is
+ * completed in O(log) by a binary search on the remaining capacity: O(2^(n/2) n) time instead
+ * of the brute force's O(2^n n). Ties are broken like the brute force (fewer items, then the
+ * lower sum of indices), which is possible because that ordering is additive over the halves.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items (at most 62).
+ * @param maxWeight Maximum allowable weight.
+ * @param usedItems Output array indicating selected items.
+ * @param cancel Optional token polled while enumerating and while combining the halves.
+ * @param status Optional output: Optimal, or Cancelled (best combination seen so far, or the greedy
+ * solution if better, returned).
+ * @return Maximum value that can be obtained.
+ */
+unsigned int knapsackMITM(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                          const CancellationToken* cancel, SolveStatus* status) {
+    struct Subset {
+        unsigned long long weight;
+        unsigned int value;
+        unsigned int numItems;
+        unsigned long long sumIds;
+        unsigned long long mask;
+    };
+    auto better = [](const Subset& a, const Subset& b) {
+        return preferredSolution(a.value, a.numItems, a.sumIds, b.value, b.numItems, b.sumIds);
+    };
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    auto enumerate = [&](unsigned int first, unsigned int last) {
+        vector<Subset> subsets = {{0, 0, 0, 0, 0}};
+        subsets.reserve(1ULL << (last - first));
+        for (unsigned int i = first; i < last; i++) {
+            size_t count = subsets.size();
+            if (cancel != nullptr && cancel->isCancelled()) break;
+            for (size_t k = 0; k < count; k++) {
+                Subset s = subsets[k];
+                s.weight += weights[i];
+                if (s.weight > maxWeight) continue;
+                s.value += values[i];
+                s.numItems++;
+                s.sumIds += i;
+                s.mask |= 1ULL << (i - first);
+                subsets.push_back(s);
+            }
+        }
+        return subsets;
+    };
+
+    unsigned int half = n / 2;
+    vector<Subset> left = enumerate(0, half);
+    vector<Subset> right = enumerate(half, n);
+    recorder.subsets(left.size() + right.size());
+    recorder.memory((left.capacity() + right.capacity()) * sizeof(Subset));
+
+    // Sort the right half by weight and keep the best subset among all lighter ones
+    recorder.phase(SolverPhase::Solve);
+    bool cancelled = cancel != nullptr && cancel->isCancelled();
+    if (!cancelled) sort(right.begin(), right.end(), [](const Subset& a, const Subset& b) { return a.weight < b.weight; });
+    for (size_t k = 1; k < right.size() && !cancelled; k++) {
+        if (better(right[k - 1], right[k])) {
+            unsigned long long weight = right[k].weight;
+            right[k] = right[k - 1];
+            right[k].weight = weight;
+        }
+    }
+
+    Subset best = {0, 0, 0, 0, 0};
+    unsigned long long bestRightMask = 0;
+    bool found = false;
+    for (size_t j = 0; j < left.size() && !cancelled; j++) {
+        if ((j & 4095) == 0 && cancel != nullptr && cancel->isCancelled()) {
+            cancelled = true;
+            break;
+        }
+        const Subset& l = left[j];
+        unsigned long long room = maxWeight - l.weight;
+        size_t k = upper_bound(right.begin(), right.end(), room,
+                               [](unsigned long long w, const Subset& s) { return w < s.weight; }) - right.begin();
+        if (k == 0) continue;
+        const Subset& r = right[k - 1];
+        Subset combined = {l.weight + r.weight, l.value + r.value, l.numItems + r.numItems, l.sumIds + r.sumIds, l.mask};
+        if (!found || better(combined, best)) {
+            recorder.incumbentUpdated();
+            found = true;
+            best = combined;
+            bestRightMask = r.mask;
+        }
+    }
+
+    recorder.phase(SolverPhase::Reconstruct);
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = i < half ? (best.mask >> i) & 1ULL : (bestRightMask >> (i - half)) & 1ULL;
+    }
+    if (cancelled) return keepBestKnown(values, weights, n, maxWeight, usedItems, best.value, status);
+    if (status != nullptr) *status = SolveStatus::Optimal;
+    return best.value;
+}
+
+/**
+ * @brief Profit-indexed dynamic programming solution for the 0/1 knapsack problem.
+ *
+ * For every total profit p, minWeight[p] holds the lightest way to reach exactly p; the answer
+ * is the largest p whose weight fits. Runs in O(n P) time for a total profit P and needs one
+ * bit per cell for the reconstruction, so it suits instances with a large capacity but small
+ * profits. Ties between optimal solutions are not broken canonically.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum allowable weight.
+ * @param usedItems Output array indicating selected items.
+ * @param cancel Optional token polled once per DP row.
+ * @param status Optional output: Optimal, or Cancelled (optimum over the rows filled so far, or
+ * the greedy solution if better, returned).
+ * @return Maximum value that can be obtained.
+ */
+unsigned int knapsackProfitDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                              const CancellationToken* cancel, SolveStatus* status) {
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    unsigned long long profitSum = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = false;
+        if (weights[i] <= maxWeight) profitSum += values[i];
+    }
+
+    const unsigned long long INF = ULLONG_MAX;
+    unsigned long long words = profitSum / 64 + 1;
+    vector<unsigned long long> minWeight(profitSum + 1, INF);
+    vector<unsigned long long> taken(n * words, 0);
+    minWeight[0] = 0;
+    recorder.memory((minWeight.size() + taken.size()) * sizeof(unsigned long long));
+
+    recorder.phase(SolverPhase::Solve);
+    unsigned long long reach = 0;
+    bool cancelled = false;
+    TraceBlocks rows("dp rows", "dp", 64);
+    for (unsigned int i = 0; i < n; i++) {
+        rows.step(i);
+        if (cancel != nullptr && cancel->isCancelled()) {
+            cancelled = true;
+            break;
+        }
+        if (weights[i] > maxWeight || values[i] == 0) continue;
+        unsigned long long* row = &taken[i * words];
+        reach += values[i];
+        recorder.cells(reach - values[i] + 1);
+        for (unsigned long long p = reach; p >= values[i]; p--) {
+            unsigned long long from = minWeight[p - values[i]];
+            if (from != INF && from + weights[i] <= maxWeight && from + weights[i] < minWeight[p]) {
+                minWeight[p] = from + weights[i];
+                row[p / 64] |= 1ULL << (p % 64);
+            }
+        }
+    }
+
+    rows.finish();
+
+    unsigned long long p = reach;
+    while (p > 0 && minWeight[p] == INF) p--;
+    unsigned int maxValue = p;
+
+    // Backtracking
+    recorder.phase(SolverPhase::Reconstruct);
+    for (unsigned int i = n; i-- > 0 && p > 0;) {
+        if (taken[i * words + p / 64] & (1ULL << (p % 64))) {
+            usedItems[i] = true;
+            p -= values[i];
+        }
+    }
+    if (cancelled) return keepBestKnown(values, weights, n, maxWeight, usedItems, maxValue, status);
+    if (status != nullptr) *status = SolveStatus::Optimal;
+    return maxValue;
+}
+
+/**
+ * @brief Sparse (Pareto list) dynamic programming solution for the 0/1 knapsack problem.
+ *
+ * Instead of a full table, keeps after each item only the non-dominated states: a state is
+ * dropped when a lighter (or equally heavy) state is at least as good. "Good" orders by value,
+ * then fewer items, then the lower sum of indices, so the result follows the same tie-breaking
+ * rules as knapsackDP. The running time is proportional to the total number of Pareto states,
+ * which is far below n*W on most instances and never above it.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum allowable weight.
+ * @param usedItems Output array indicating selected items.
+ * @param cancel Optional token polled once per item.
+ * @param status Optional output: Optimal, or Cancelled (optimum over the items processed so far,
+ * or the greedy solution if better, returned).
+ * @return Maximum value that can be obtained.
+ */
+unsigned int knapsackSparseDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                              const CancellationToken* cancel, SolveStatus* status) {
+    struct State {
+        unsigned long long weight;
+        unsigned int value;
+        unsigned int numItems;
+        unsigned long long sumIds;
+        long long parent;  // index of the state this one extends, -1 for the empty state
+        int item;          // item added to the parent, -1 if none
+    };
+    auto better = [](const State& a, const State& b) {
+        return preferredSolution(a.value, a.numItems, a.sumIds, b.value, b.numItems, b.sumIds);
+    };
+
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Solve);
+    vector<State> arena = {{0, 0, 0, 0, -1, -1}};
+    vector<long long> current = {0};  // Pareto list, increasing weight and increasing quality
+    vector<long long> extended, merged;
+
+    bool cancelled = false;
+    TraceBlocks rows("pareto rows", "dp", 64);
+    for (unsigned int i = 0; i < n; i++) {
+        rows.step(i);
+        if (cancel != nullptr && cancel->isCancelled()) {
+            cancelled = true;
+            break;
+        }
+        recorder.cells(current.size());
+        extended.clear();
+        for (long long s : current) {
+            if (arena[s].weight + weights[i] > maxWeight) break;
+            State next = arena[s];
+            next.weight += weights[i];
+            next.value += values[i];
+            next.numItems++;
+            next.sumIds += i;
+            next.parent = s;
+            next.item = i;
+            arena.push_back(next);
+            extended.push_back(arena.size() - 1);
+        }
+
+        // Merge by weight and drop dominated states
+        merged.clear();
+        size_t a = 0, b = 0;
+        while (a < current.size() || b < extended.size()) {
+            long long pick;
+            if (b == extended.size()) pick = current[a++];
+            else if (a == current.size()) pick = extended[b++];
+            else if (arena[current[a]].weight < arena[extended[b]].weight) pick = current[a++];
+            else if (arena[extended[b]].weight < arena[current[a]].weight) pick = extended[b++];
+            else pick = better(arena[extended[b]], arena[current[a]]) ? extended[b++] : current[a++];
+
+            if (merged.empty() || better(arena[pick], arena[merged.back()])) {
+                if (!merged.empty() && arena[merged.back()].weight == arena[pick].weight) merged.pop_back();
+                merged.push_back(pick);
+            }
+        }
+        swap(current, merged);
+    }
+    rows.finish();
+
+    recorder.phase(SolverPhase::Reconstruct);
+    recorder.memory(arena.capacity() * sizeof(State) + (current.capacity() + extended.capacity() + merged.capacity()) * sizeof(long long));
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = false;
+    }
+    const State& best = arena[current.back()];
+    for (long long s = current.back(); s >= 0 && arena[s].item >= 0; s = arena[s].parent) {
+        usedItems[arena[s].item] = true;
+    }
+    if (cancelled) return keepBestKnown(values, weights, n, maxWeight, usedItems, best.value, status);
+    if (status != nullptr) *status = SolveStatus::Optimal;
+    return best.value;
+}
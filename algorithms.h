@@ -3,6 +3,8 @@
 //
 
 #include "dataset.h"
+#include "cancellation.h"
+#include <functional>
 #include <vector>
 using namespace std;
 
@@ -17,9 +19,12 @@ using namespace std;
  * @param n Number of items.
  * @param maxWeight Maximum total weight allowed.
  * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
  * @return Maximum total value that fits in the knapsack.
  */
-unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]);
+unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                        const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
 
 /**
  * @brief Dynamic programming solution with static arrays for the knapsack problem.
@@ -29,9 +34,12 @@ unsigned int knapsackBF(unsigned int values[], unsigned int weights[], unsigned
  * @param n Number of items.
  * @param maxWeight Maximum total weight allowed.
  * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
  * @return Maximum total value that fits in the knapsack.
  */
-unsigned int knapsackDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]);
+unsigned int knapsackDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                        const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
 
 /**
  * @brief Dynamic programming solution using std::vector for the knapsack problem.
@@ -41,20 +49,51 @@ unsigned int knapsackDP(unsigned int values[], unsigned int weights[], unsigned
  * @param n Number of items.
  * @param maxWeight Maximum total weight allowed.
  * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
  * @return Maximum total value that fits in the knapsack.
  */
-unsigned int knapsackDP1(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]);
+unsigned int knapsackDP1(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                         const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
 
 /**
- * @brief Greedy heuristic solution for the knapsack problem based on profit-to-weight ratio.
+ * @brief Greedy heuristic for the knapsack problem based on profit-to-weight ratio.
  * 
- * @param pallets Vector of Pallet items.
+ * Finds the critical item in O(n) expected time and returns the better of the greedy
+ * solution and the best single item (a 1/2-approximation).
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
  * @param n Number of items.
  * @param maxWeight Maximum total weight allowed.
  * @param usedItems Output array marking which items are used.
  * @return Total profit obtained by the greedy algorithm.
  */
-unsigned int knapsackGreedy(vector<Pallet> pallets, unsigned int n, unsigned int maxWeight, bool usedItems[]);
+unsigned int knapsackGreedy(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]);
+
+/**
+ * @struct ILPOptions
+ * @brief Warm start and anytime settings for the branch-and-bound solver.
+ */
+struct ILPOptions {
+    bool greedyWarmStart = true;      ///< Seed the incumbent with the greedy heuristic
+    bool improveIncumbent = false;    ///< Polish the greedy warm start with localSearch()
+    const bool* incumbent = nullptr;  ///< Optional caller-supplied solution (e.g. yesterday's loading plan)
+    double timeLimit = 0.0;           ///< Wall-clock budget in seconds (0 = unlimited)
+    unsigned long long nodeLimit = 0; ///< Maximum number of nodes to expand (0 = unlimited)
+    function<void(unsigned int value, double gap)> onImprove; ///< Called with every improving incumbent
+    const CancellationToken* cancel = nullptr; ///< Optional token that stops the search early
+};
+
+/**
+ * @struct ILPStats
+ * @brief Outcome of a branch-and-bound run.
+ */
+struct ILPStats {
+    unsigned long long nodes = 0; ///< Number of nodes expanded
+    bool optimal = false;         ///< True if the search completed, i.e. the result is proven optimal
+    double gap = 0.0;             ///< Relative optimality gap when a budget stopped the search
+};
 
 /**
  * @brief Branch-and-bound (ILP) solution for the knapsack problem.
@@ -64,8 +103,85 @@ unsigned int knapsackGreedy(vector<Pallet> pallets, unsigned int n, unsigned int
  * @param n Number of items.
  * @param maxWeight Maximum total weight allowed.
  * @param usedItems Output array marking which items are used.
+ * @param options Warm start and anytime settings.
+ * @param stats Optional output describing the run.
  * @return Maximum total value found by branch-and-bound.
  */
-unsigned int knapsackILP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]);
+unsigned int knapsackILP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                         const ILPOptions& options = ILPOptions(), ILPStats* stats = nullptr);
+
+/**
+ * @brief FPTAS for the knapsack problem: profit scaling followed by a profit-indexed DP.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param epsilon Accuracy parameter, 0 < epsilon < 1.
+ * @param usedItems Output array marking which items are used.
+ * @param upperBound Optional output with a proven upper bound on the optimal value.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
+ * @return Total value of a solution that is at least (1 - epsilon) times the optimum.
+ */
+unsigned int knapsackFPTAS(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                           double epsilon, bool usedItems[], unsigned int* upperBound = nullptr,
+                           const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+/**
+ * @brief Meet-in-the-middle solution for the knapsack problem (n <= 62).
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackMITM(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                          const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+/**
+ * @brief Profit-indexed dynamic programming (minimum weight per total profit).
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackProfitDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                              const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+/**
+ * @brief Sparse dynamic programming over Pareto-optimal (weight, value) states.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackSparseDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                              const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+/// Scratch a pool worker keeps between jobs; a larger peak is freed after the job
+const size_t workerScratchBytes = 64ULL << 20;
+
+/**
+ * @brief Frees the DP and branch-and-bound scratch buffers cached by the calling thread if they
+ * hold more than keepBytes.
+ *
+ * @param keepBytes Capacity the thread may keep for its next solve (0 = free everything).
+ */
+void releaseSolverScratch(size_t keepBytes = 0);
 
 #endif //ALGORITHMS_H
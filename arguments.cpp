@@ -0,0 +1,49 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include "arguments.h"
+
+using namespace std;
+
+/**
+ * @brief Parses a whole argument as a non-negative integer (strtoull alone accepts "-1" and "4x").
+ *
+ * @param text Argument.
+ * @param limit Largest accepted value.
+ * @param value Output value.
+ * @return True if the argument is a decimal integer in [0, limit].
+ */
+bool parseCount(const string& text, unsigned long long limit, unsigned long long& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) return false;
+    errno = 0;
+    value = strtoull(text.c_str(), nullptr, 10);
+    return errno == 0 && value <= limit;
+}
+
+/**
+ * @brief Parses a whole argument as an integer in [0, UINT32_MAX].
+ *
+ * @param text Argument.
+ * @param value Output value.
+ * @return True if the argument is valid.
+ */
+bool parseCount(const string& text, unsigned int& value) {
+    unsigned long long parsed;
+    if (!parseCount(text, UINT32_MAX, parsed)) return false;
+    value = parsed;
+    return true;
+}
+
+/**
+ * @brief Parses a whole argument as a finite, non-negative number (seconds, fractions, ratios).
+ *
+ * @param text Argument.
+ * @param value Output value.
+ * @return True if the argument is valid.
+ */
+bool parseNonNegative(const string& text, double& value) {
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && isfinite(value) && value >= 0;
+}
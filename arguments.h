@@ -0,0 +1,35 @@
+#include <string>
+using namespace std;
+
+#ifndef ARGUMENTS_H
+#define ARGUMENTS_H
+
+/**
+ * @brief Parses a whole argument as a non-negative integer (strtoull alone accepts "-1" and "4x").
+ *
+ * @param text Argument.
+ * @param limit Largest accepted value.
+ * @param value Output value.
+ * @return True if the argument is a decimal integer in [0, limit].
+ */
+bool parseCount(const string& text, unsigned long long limit, unsigned long long& value);
+
+/**
+ * @brief Parses a whole argument as an integer in [0, UINT32_MAX].
+ *
+ * @param text Argument.
+ * @param value Output value.
+ * @return True if the argument is valid.
+ */
+bool parseCount(const string& text, unsigned int& value);
+
+/**
+ * @brief Parses a whole argument as a finite, non-negative number (seconds, fractions, ratios).
+ *
+ * @param text Argument.
+ * @param value Output value.
+ * @return True if the argument is valid.
+ */
+bool parseNonNegative(const string& text, double& value);
+
+#endif //ARGUMENTS_H
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include "dataset.h"
+#include "data_loader.h"
+#include "algorithms.h"
+#include "batch.h"
+#include "solvers.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief Collects the jobs of a batch run.
+ *
+ * A directory is scanned for Pallets_<id>.csv files with a matching TruckAndPallets_<id>.csv,
+ * and for binary instances (*.knap). Any other path is read as a manifest with one "pallets,truck" pair per line; relative paths
+ * are resolved against the manifest's directory and lines starting with '#' are ignored.
+ *
+ * @param path Directory or manifest file.
+ * @param error Optional output: why the manifest could not be read.
+ * @return Jobs in a stable order.
+ */
+vector<BatchJob> discoverBatchJobs(const string& path, string* error) {
+    vector<BatchJob> jobs;
+    filesystem::path root(path);
+
+    if (filesystem::is_directory(root)) {
+        for (const auto& entry : filesystem::directory_iterator(root)) {
+            string file = entry.path().filename().string();
+            if (entry.path().extension() == ".knap") {
+                jobs.push_back({entry.path().stem().string(), entry.path().string(), ""});
+                continue;
+            }
+            if (file.rfind("Pallets_", 0) != 0 || entry.path().extension() != ".csv") continue;
+            string id = file.substr(8, file.size() - 8 - 4);
+            filesystem::path truck = root / ("TruckAndPallets_" + id + ".csv");
+            if (!filesystem::exists(truck)) continue;
+            jobs.push_back({id, entry.path().string(), truck.string()});
+        }
+        sort(jobs.begin(), jobs.end(), [](const BatchJob& a, const BatchJob& b) { return a.name < b.name; });
+        return jobs;
+    }
+
+    ifstream manifest(path);
+    if (!manifest.is_open()) {
+        if (error != nullptr) *error = "Error opening file: " + path;
+        return jobs;
+    }
+    filesystem::path base = root.parent_path();
+    string line;
+    while (getline(manifest, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        stringstream ss(line);
+        string pallets, truck;
+        getline(ss, pallets, ',');
+        getline(ss, truck, ',');
+        if (pallets.empty() || truck.empty()) continue;
+        filesystem::path palletsPath(pallets), truckPath(truck);
+        if (palletsPath.is_relative()) palletsPath = base / palletsPath;
+        if (truckPath.is_relative()) truckPath = base / truckPath;
+        jobs.push_back({palletsPath.stem().string(), palletsPath.string(), truckPath.string()});
+    }
+    return jobs;
+}
+
+/**
+ * @brief Formats a CSV field, quoting it (with doubled quotes) if it holds a comma, quote or newline.
+ */
+static string csvField(const string& field) {
+    if (field.find_first_of(",\"\r\n") == string::npos) return field;
+    string quoted = "\"";
+    for (char c : field) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * @brief Solves every job on a work-stealing thread pool and writes one CSV line per instance.
+ *
+ * Lines are written as jobs complete (so not necessarily in input order) with the columns
+ * instance, algorithm, status, pallets, capacity, profit, load and wall time in milliseconds
+ * (loading included); the status is ok, load-error, too-large or error (the solver threw).
+ * Instance names are quoted as CSV fields where needed. Because the pool's workers persist, the solvers' per-thread DP and
+ * branch-and-bound scratch buffers are reused from one job to the next; a job that grew them
+ * beyond workerScratchBytes frees them.
+ *
+ * @param jobs Instances to solve.
+ * @param algorithm Name of the solver to use (see knapsackSolvers()).
+ * @param threads Number of worker threads (0 = one per hardware thread).
+ * @param out Stream receiving the header and result lines.
+ * @param error Optional output: why no job could be run (unknown algorithm).
+ * @return Number of jobs that failed.
+ */
+unsigned int runBatch(const vector<BatchJob>& jobs, const string& algorithm, unsigned int threads, ostream& out,
+                      string* error) {
+    const SolverInfo* solver = findSolver(algorithm);
+    if (solver == nullptr) {
+        if (error != nullptr) *error = "Unknown algorithm: " + algorithm;
+        return jobs.size();
+    }
+
+    mutex outLock;
+    unsigned int failures = 0;
+    out << "instance,algorithm,status,pallets,capacity,profit,load,millis\n";
+
+    {
+        ThreadPool pool(threads);
+        for (const BatchJob& job : jobs) {
+            pool.submit([&, solver]() {
+                auto start = chrono::steady_clock::now();
+                vector<Pallet> pallets;
+                Truck truck;
+                // A malformed line makes the parser throw; the job then reports a load error
+                try {
+                    load_instance(job.palletsFile, job.truckFile, pallets, truck);
+                } catch (const exception&) {
+                    pallets.clear();
+                    truck = Truck();
+                }
+                unsigned int n = min<size_t>(truck.pallets, pallets.size());
+                unsigned int maxWeight = truck.capacity;
+
+                string status = "ok";
+                unsigned int profit = 0;
+                unsigned long long load = 0;
+                vector<unsigned int> values(n), weights(n);
+                for (unsigned int i = 0; i < n; i++) {
+                    values[i] = pallets[i].profit;
+                    weights[i] = pallets[i].weight;
+                }
+                if (pallets.empty() || truck.capacity <= 0) {
+                    status = "load-error";
+                } else {
+                    // A solver that throws (e.g. bad_alloc) fails its job, not the whole batch
+                    try {
+                        if (!solver->fits(values.data(), weights.data(), n, maxWeight)) {
+                            status = "too-large";
+                        } else {
+                            vector<char> used(n, 0);
+                            TraceScope trace(solver->name.c_str(), "batch");
+                            profit = solver->solve(values.data(), weights.data(), n, maxWeight, reinterpret_cast<bool*>(used.data()));
+                            for (unsigned int i = 0; i < n; i++) {
+                                if (used[i]) load += weights[i];
+                            }
+                        }
+                    } catch (const exception&) {
+                        status = "error";
+                        profit = 0;
+                        load = 0;
+                    }
+                }
+                // Keep the scratch of typical jobs for reuse, but not the peak of a huge one
+                releaseSolverScratch(workerScratchBytes);
+                double millis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+                ostringstream line;
+                line << csvField(job.name) << "," << solver->name << "," << status << "," << n << "," << maxWeight << ","
+                     << profit << "," << load << "," << millis << "\n";
+                lock_guard<mutex> guard(outLock);
+                if (status != "ok") failures++;
+                out << line.str();
+            });
+        }
+        pool.wait();
+    }
+    out.flush();
+    return failures;
+}
@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+ * @struct BatchJob
+ * @brief One instance of a batch run: a Pallets file and its TruckAndPallets file.
+ */
+struct BatchJob {
+    string name;         ///< Instance name used in the result line
+    string palletsFile;  ///< Path to the Pallets CSV file, or to a binary instance (.knap)
+    string truckFile;    ///< Path to the TruckAndPallets CSV file (empty for binary instances)
+};
+
+/**
+ * @brief Collects the jobs of a batch run.
+ * 
+ * A directory is scanned for Pallets_<id>.csv files with a matching TruckAndPallets_<id>.csv,
+ * and for binary instances (*.knap). Any other path is read as a manifest with one "pallets,truck" pair per line.
+ * 
+ * @param path Directory or manifest file.
+ * @param error Optional output: why the manifest could not be read.
+ * @return Jobs in a stable order.
+ */
+vector<BatchJob> discoverBatchJobs(const string& path, string* error = nullptr);
+
+/**
+ * @brief Solves every job on a work-stealing thread pool and writes one CSV line per instance.
+ * 
+ * @param jobs Instances to solve.
+ * @param algorithm Name of the solver to use (see knapsackSolvers()).
+ * @param threads Number of worker threads (0 = one per hardware thread).
+ * @param out Stream receiving the header and result lines.
+ * @param error Optional output: why no job could be run (unknown algorithm).
+ * @return Number of jobs that failed.
+ */
+unsigned int runBatch(const vector<BatchJob>& jobs, const string& algorithm, unsigned int threads, ostream& out,
+                      string* error = nullptr);
+
+#endif //BATCH_H
@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "dataset.h"
+#include "data_loader.h"
+#include "algorithms.h"
+#include "solver_stats.h"
+#include "batch.h"
+#include "bench.h"
+#include "generator.h"
+#include "json.h"
+
+using namespace std;
+
+/**
+ * @brief What a child process reports back to the benchmark through its pipe.
+ */
+struct RunReport {
+    unsigned int profit;
+    double millis;
+    SolverStats stats;
+    PerfReading perf;
+};
+
+/**
+ * @brief Generates a benchmark instance with capacity half the total weight.
+ */
+static BenchInstance generatedInstance(const string& family, unsigned int n, unsigned int range, unsigned int seed) {
+    GeneratorOptions options;
+    options.family = family;
+    options.n = n;
+    options.range = range;
+    options.seed = seed;
+    BenchInstance instance;
+    instance.name = "gen-" + family + "-" + to_string(n);
+    instance.maxWeight = generateInstance(options, instance.weights, instance.values);
+    return instance;
+}
+
+/**
+ * @brief Loads every instance of the given directories, followed by the generated ones.
+ *
+ * Directories are scanned like a batch run (Pallets_<id>.csv with a matching
+ * TruckAndPallets_<id>.csv, and binary .knap instances); fleet files contribute their first truck.
+ *
+ * @param options Benchmark options (directories and generated).
+ * @return Instances in a stable order.
+ */
+vector<BenchInstance> loadBenchInstances(const BenchOptions& options) {
+    vector<BenchInstance> instances;
+    for (const string& directory : options.directories) {
+        string prefix = filesystem::path(directory).filename().string();
+        for (const BatchJob& job : discoverBatchJobs(directory)) {
+            vector<Pallet> pallets;
+            Truck truck;
+            string error;
+            if (!load_instance(job.palletsFile, job.truckFile, pallets, truck, &error)) {
+                cerr << error << endl;
+                continue;
+            }
+            BenchInstance instance;
+            instance.name = prefix + "/" + job.name;
+            instance.maxWeight = truck.capacity;
+            unsigned int n = min<size_t>(truck.pallets, pallets.size());
+            for (unsigned int i = 0; i < n; i++) {
+                instance.values.push_back(pallets[i].profit);
+                instance.weights.push_back(pallets[i].weight);
+            }
+            instances.push_back(instance);
+        }
+    }
+    if (options.generated) {
+        instances.push_back(generatedInstance("uncorrelated", 10000, 1000, 1));
+        instances.push_back(generatedInstance("weakly-correlated", 1000, 1000, 2));
+        instances.push_back(generatedInstance("strongly-correlated", 200, 1000, 3));
+    }
+    return instances;
+}
+
+/**
+ * @brief Amount of work a solver did according to its statistics, and its unit.
+ *
+ * DP-style solvers count cells, branch-and-bound nodes, brute force and meet-in-the-middle
+ * subsets; anything else falls back to items.
+ */
+static double workUnits(const SolverStats& stats, unsigned int n, string& unit) {
+    if (stats.nodesExpanded > 0) {
+        unit = "nodes";
+        return stats.nodesExpanded;
+    }
+    if (stats.dpCells > 0) {
+        unit = "cells";
+        return stats.dpCells;
+    }
+    if (stats.subsetsEnumerated > 0) {
+        unit = "subsets";
+        return stats.subsetsEnumerated;
+    }
+    unit = "items";
+    return n;
+}
+
+/**
+ * @brief Solves the instance once in the calling (child) process and times the solver alone.
+ */
+static RunReport runOnce(const BenchInstance& instance, const SolverInfo& solver, bool hardwareCounters) {
+    vector<unsigned int> values = instance.values, weights = instance.weights;
+    unsigned int n = values.size();
+    vector<char> used(n, 0);
+    RunReport report;
+    SolverStatsScope scope(&report.stats);
+    unique_ptr<PerfCounters> counters(hardwareCounters ? new PerfCounters() : nullptr);
+    if (counters != nullptr) counters->start();
+    auto start = chrono::steady_clock::now();
+    report.profit = solver.solve(values.data(), weights.data(), n, instance.maxWeight, reinterpret_cast<bool*>(used.data()));
+    report.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (counters != nullptr) report.perf = counters->stop();
+    return report;
+}
+
+/**
+ * @brief Times one solver on one instance, every run in a child process.
+ *
+ * Forking isolates the runs from each other (static DP tables, thread-local scratch, the heap)
+ * and lets wait4() report each run's peak resident set size. A run exceeding the timeout is
+ * killed by SIGALRM and ends the series.
+ *
+ * @param instance Instance to solve.
+ * @param solver Registry entry of the solver.
+ * @param repeats Number of timed runs.
+ * @param timeout Seconds after which a run is killed.
+ * @param hardwareCounters Whether to read perf_event_open counters around the solver call.
+ * @return The timings and their statistics.
+ */
+BenchResult benchmarkSolver(const BenchInstance& instance, const SolverInfo& solver, unsigned int repeats, double timeout,
+                            bool hardwareCounters) {
+    BenchResult result;
+    result.instance = instance.name;
+    result.solver = solver.name;
+    result.n = instance.values.size();
+    result.capacity = instance.maxWeight;
+    result.status = "ok";
+    if (!solver.fits(instance.values.data(), instance.weights.data(), result.n, result.capacity)) {
+        result.status = "too-large";
+        return result;
+    }
+
+    double work = 0;
+    for (unsigned int run = 0; run < repeats; run++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            result.status = "crashed";
+            break;
+        }
+        cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            alarm((unsigned int) ceil(timeout));
+            RunReport report = runOnce(instance, solver, hardwareCounters);
+            ssize_t written = write(fds[1], &report, sizeof(report));
+            _exit(written == sizeof(report) ? 0 : 1);
+        }
+        close(fds[1]);
+        RunReport report;
+        ssize_t got = pid > 0 ? read(fds[0], &report, sizeof(report)) : -1;
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage = {};
+        if (pid > 0) wait4(pid, &status, 0, &usage);
+
+        if (pid > 0 && WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+            result.status = "timeout";
+            break;
+        }
+        if (pid <= 0 || got != sizeof(report) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            result.status = "crashed";
+            break;
+        }
+        result.millis.push_back(report.millis);
+        result.profit = report.profit;
+        result.peakRssKB = max(result.peakRssKB, usage.ru_maxrss);
+        result.stats = report.stats;
+        result.perf = report.perf;
+        work = workUnits(report.stats, result.n, result.unit);
+    }
+
+    if (!result.millis.empty()) {
+        vector<double> sorted = result.millis;
+        sort(sorted.begin(), sorted.end());
+        size_t k = sorted.size();
+        result.medianMillis = k % 2 ? sorted[k / 2] : (sorted[k / 2 - 1] + sorted[k / 2]) / 2;
+        result.p95Millis = sorted[(size_t) ceil(0.95 * k) - 1];
+        if (result.medianMillis > 0) result.throughput = work / (result.medianMillis / 1000);
+    }
+    return result;
+}
+
+/**
+ * @brief Runs every selected solver on every instance.
+ *
+ * @param options Benchmark options.
+ * @param progress Stream receiving one line per finished pair (nullptr = silent).
+ * @return One result per solver and instance.
+ */
+vector<BenchResult> runBenchmark(const BenchOptions& options, ostream* progress) {
+    if (options.hardwareCounters && progress != nullptr) {
+        PerfCounters probe;
+        if (!probe.available()) *progress << "Hardware counters unavailable (" << probe.error() << ")" << endl;
+    }
+    vector<const SolverInfo*> solvers;
+    if (options.solvers.empty()) {
+        for (const SolverInfo& solver : knapsackSolvers()) {
+            solvers.push_back(&solver);
+        }
+    } else {
+        for (const string& name : options.solvers) {
+            const SolverInfo* solver = findSolver(name);
+            if (solver != nullptr) {
+                solvers.push_back(solver);
+            } else if (progress != nullptr) {
+                *progress << "Unknown solver: " << name << endl;
+            }
+        }
+    }
+
+    vector<BenchResult> results;
+    for (const BenchInstance& instance : loadBenchInstances(options)) {
+        for (const SolverInfo* solver : solvers) {
+            results.push_back(benchmarkSolver(instance, *solver, options.repeats, options.timeout, options.hardwareCounters));
+            const BenchResult& r = results.back();
+            if (progress != nullptr) {
+                *progress << r.instance << " " << r.solver << ": " << r.status;
+                if (!r.millis.empty()) *progress << ", median " << r.medianMillis << " ms";
+                *progress << endl;
+            }
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Writes the results as CSV, one line per solver and instance.
+ */
+void writeBenchCSV(const vector<BenchResult>& results, ostream& out) {
+    out << "instance,solver,status,n,capacity,profit,runs,median_ms,p95_ms,peak_rss_kb,throughput,unit,"
+        << "dp_cells,nodes_created,nodes_pruned,nodes_expanded,bound_evaluations,subsets,incumbent_updates,"
+        << "peak_bytes,preprocess_ms,solve_ms,reconstruct_ms,cycles,instructions,ipc,l1d_misses,llc_misses,branch_misses\n";
+    for (const BenchResult& r : results) {
+        const SolverStats& s = r.stats;
+        out << r.instance << "," << r.solver << "," << r.status << "," << r.n << "," << r.capacity << ","
+            << r.profit << "," << r.millis.size() << "," << r.medianMillis << "," << r.p95Millis << ","
+            << r.peakRssKB << "," << r.throughput << "," << r.unit << ","
+            << s.dpCells << "," << s.nodesCreated << "," << s.nodesPruned << "," << s.nodesExpanded << ","
+            << s.boundEvaluations << "," << s.subsetsEnumerated << "," << s.incumbentUpdates << ","
+            << s.peakMemoryBytes << "," << s.preprocessSeconds * 1000 << "," << s.solveSeconds * 1000 << ","
+            << s.reconstructSeconds * 1000;
+        for (int e = 0; e < PerfEventCount; e++) {
+            out << ",";
+            if (r.perf.available((PerfEvent) e)) out << r.perf.value[e];
+            if (e == PerfInstructions) {
+                out << ",";
+                if (r.perf.ipc() >= 0) out << r.perf.ipc();
+            }
+        }
+        out << "\n";
+    }
+}
+
+/**
+ * @brief Writes the results as a JSON document, including the raw samples.
+ *
+ * The document is {"results": [...]} with one object per line of the CSV output, the solver
+ * counters grouped in a "stats" object and the raw "samples_ms", so later runs can be compared
+ * against it.
+ */
+void writeBenchJSON(const vector<BenchResult>& results, ostream& out) {
+    out << "{\"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << (i ? ",\n  " : "\n  ")
+            << "{\"instance\": " << jsonQuote(r.instance) << ", \"solver\": " << jsonQuote(r.solver)
+            << ", \"status\": " << jsonQuote(r.status) << ", \"n\": " << r.n << ", \"capacity\": " << r.capacity << ", \"profit\": " << r.profit
+            << ", \"median_ms\": " << r.medianMillis << ", \"p95_ms\": " << r.p95Millis
+            << ", \"peak_rss_kb\": " << r.peakRssKB << ", \"throughput\": " << r.throughput
+            << ", \"unit\": " << jsonQuote(r.unit) << ", \"samples_ms\": [";
+        for (size_t k = 0; k < r.millis.size(); k++) {
+            out << (k ? ", " : "") << r.millis[k];
+        }
+        out << "], \"stats\": " << solverStatsJSON(r.stats) << ", \"perf\": " << perfJSON(r.perf) << "}";
+    }
+    out << "\n]}\n";
+}
+
+/**
+ * @brief Reads results written by writeBenchJSON.
+ *
+ * @param filename JSON file.
+ * @param results Output results.
+ * @return True on success.
+ */
+bool loadBenchJSON(const string& filename, vector<BenchResult>& results) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    JsonValue document;
+    string error;
+    if (!JsonValue::parse(text, document, &error) || !document["results"].isArray()) {
+        cerr << filename << ": " << (error.empty() ? "no results array" : error) << endl;
+        return false;
+    }
+    for (const JsonValue& item : document["results"].items()) {
+        BenchResult r;
+        r.instance = item["instance"].asString();
+        r.solver = item["solver"].asString();
+        r.status = item["status"].asString();
+        r.n = item["n"].asNumber();
+        r.capacity = item["capacity"].asNumber();
+        r.profit = item["profit"].asNumber();
+        r.medianMillis = item["median_ms"].asNumber();
+        r.p95Millis = item["p95_ms"].asNumber();
+        r.peakRssKB = item["peak_rss_kb"].asNumber();
+        r.throughput = item["throughput"].asNumber();
+        r.unit = item["unit"].asString();
+        for (const JsonValue& sample : item["samples_ms"].items()) {
+            r.millis.push_back(sample.asNumber());
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
+/**
+ * @brief Median of a sample.
+ */
+static double median(vector<double> samples) {
+    sort(samples.begin(), samples.end());
+    size_t k = samples.size();
+    return k % 2 ? samples[k / 2] : (samples[k / 2 - 1] + samples[k / 2]) / 2;
+}
+
+/**
+ * @brief Compares current results with a baseline using a bootstrap interval of the median ratio.
+ *
+ * Both sample sets are resampled with replacement 2000 times; the 2.5th and 97.5th percentiles
+ * of current median / baseline median bound the ratio. A pair regresses when the whole interval
+ * lies above 1 + threshold and the medians differ by more than minMillis, so a handful of noisy
+ * sub-millisecond runs does not fail the gate. A pair that used to finish and now times out or
+ * crashes is always a regression.
+ *
+ * @param baseline Stored results.
+ * @param current Fresh results.
+ * @param threshold Relative slowdown tolerated beyond the noise (0.1 = 10%).
+ * @param minMillis Absolute slowdown of the median below which a pair is never a regression.
+ * @return One comparison per pair in either set.
+ */
+vector<BenchComparison> compareBench(const vector<BenchResult>& baseline, const vector<BenchResult>& current,
+                                     double threshold, double minMillis) {
+    const int resamples = 2000;
+    map<pair<string, string>, const BenchResult*> before;
+    for (const BenchResult& r : baseline) {
+        before[{r.instance, r.solver}] = &r;
+    }
+
+    mt19937 rng(1);
+    vector<BenchComparison> comparisons;
+    for (const BenchResult& now : current) {
+        BenchComparison c;
+        c.instance = now.instance;
+        c.solver = now.solver;
+        c.currentMillis = now.medianMillis;
+        auto it = before.find({now.instance, now.solver});
+        if (it == before.end()) {
+            c.verdict = "new";
+            comparisons.push_back(c);
+            continue;
+        }
+        const BenchResult& old = *it->second;
+        before.erase(it);
+        c.baselineMillis = old.medianMillis;
+
+        if (old.millis.empty() || now.millis.empty()) {
+            bool lost = !old.millis.empty() && now.millis.empty();
+            c.verdict = lost ? "regression" : "same";
+            comparisons.push_back(c);
+            continue;
+        }
+
+        c.ratio = now.medianMillis / max(old.medianMillis, 1e-9);
+        vector<double> ratios(resamples);
+        vector<double> a(old.millis.size()), b(now.millis.size());
+        for (double& ratio : ratios) {
+            for (double& x : a) x = old.millis[rng() % old.millis.size()];
+            for (double& x : b) x = now.millis[rng() % now.millis.size()];
+            ratio = median(b) / max(median(a), 1e-9);
+        }
+        sort(ratios.begin(), ratios.end());
+        c.ciLow = ratios[resamples * 25 / 1000];
+        c.ciHigh = ratios[resamples * 975 / 1000 - 1];
+
+        double slowdown = now.medianMillis - old.medianMillis;
+        if (c.ciLow > 1 + threshold && slowdown > minMillis) {
+            c.verdict = "regression";
+        } else if (c.ciHigh < 1 / (1 + threshold) && -slowdown > minMillis) {
+            c.verdict = "improvement";
+        } else {
+            c.verdict = "same";
+        }
+        comparisons.push_back(c);
+    }
+    for (const auto& [key, old] : before) {
+        BenchComparison c;
+        c.instance = key.first;
+        c.solver = key.second;
+        c.verdict = "missing";
+        c.baselineMillis = old->medianMillis;
+        comparisons.push_back(c);
+    }
+    return comparisons;
+}
+
+/**
+ * @brief Writes the comparisons as CSV.
+ */
+void writeBenchComparison(const vector<BenchComparison>& comparisons, ostream& out) {
+    out << "instance,solver,verdict,baseline_ms,current_ms,ratio,ci_low,ci_high\n";
+    for (const BenchComparison& c : comparisons) {
+        out << c.instance << "," << c.solver << "," << c.verdict << "," << c.baselineMillis << ","
+            << c.currentMillis << "," << c.ratio << "," << c.ciLow << "," << c.ciHigh << "\n";
+    }
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "solvers.h"
+#include "solver_stats.h"
+#include "perf_counters.h"
+using namespace std;
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * @struct BenchInstance
+ * @brief One benchmark instance, loaded from a dataset directory or generated.
+ */
+struct BenchInstance {
+    string name;                  ///< "<directory>/<id>" for dataset files, "gen-<family>-<n>" for generated ones
+    vector<unsigned int> values;  ///< Item profits
+    vector<unsigned int> weights; ///< Item weights
+    unsigned int maxWeight = 0;   ///< Capacity
+};
+
+/**
+ * @struct BenchOptions
+ * @brief What the benchmark runs and how often.
+ */
+struct BenchOptions {
+    unsigned int repeats = 5;      ///< Timed runs per solver and instance
+    double timeout = 30.0;         ///< Seconds after which a single run is killed
+    vector<string> solvers;        ///< Registry names to run (empty = every registered solver)
+    vector<string> directories = {"../datasets", "../datasets-extra"}; ///< Dataset directories
+    bool generated = true;         ///< Also run the built-in generated instances
+    bool hardwareCounters = false; ///< Also read perf_event_open counters around every run
+};
+
+/**
+ * @struct BenchResult
+ * @brief Timings of one solver on one instance.
+ */
+struct BenchResult {
+    string instance;          ///< Instance name
+    string solver;            ///< Registry name of the solver
+    string status;            ///< "ok", "too-large", "timeout" or "crashed"
+    unsigned int n = 0;       ///< Number of items
+    unsigned int capacity = 0;///< Capacity
+    unsigned int profit = 0;  ///< Profit found (last run)
+    vector<double> millis;    ///< Wall time of every completed run, in milliseconds
+    double medianMillis = 0;  ///< Median wall time
+    double p95Millis = 0;     ///< 95th percentile wall time (nearest rank)
+    long peakRssKB = 0;       ///< Largest peak resident set size over the runs, in KiB
+    double throughput = 0;    ///< Units of work per second at the median time
+    string unit;              ///< Unit of work: "cells", "nodes", "subsets" or "items"
+    SolverStats stats;        ///< Solver counters and phase timings of the last run
+    PerfReading perf;         ///< Hardware counters of the last run (all unavailable unless requested)
+};
+
+/**
+ * @brief Loads every instance of the given directories, followed by the generated ones.
+ * 
+ * @param options Benchmark options (directories and generated).
+ * @return Instances in a stable order.
+ */
+vector<BenchInstance> loadBenchInstances(const BenchOptions& options);
+
+/**
+ * @brief Times one solver on one instance, every run in a child process.
+ * 
+ * @param instance Instance to solve.
+ * @param solver Registry entry of the solver.
+ * @param repeats Number of timed runs.
+ * @param timeout Seconds after which a run is killed.
+ * @param hardwareCounters Whether to read perf_event_open counters around the solver call.
+ * @return The timings and their statistics.
+ */
+BenchResult benchmarkSolver(const BenchInstance& instance, const SolverInfo& solver, unsigned int repeats, double timeout,
+                            bool hardwareCounters = false);
+
+/**
+ * @brief Runs every selected solver on every instance.
+ * 
+ * @param options Benchmark options.
+ * @param progress Stream receiving one line per finished pair (nullptr = silent).
+ * @return One result per solver and instance.
+ */
+vector<BenchResult> runBenchmark(const BenchOptions& options, ostream* progress = nullptr);
+
+/**
+ * @brief Writes the results as CSV, one line per solver and instance.
+ */
+void writeBenchCSV(const vector<BenchResult>& results, ostream& out);
+
+/**
+ * @brief Writes the results as a JSON document, including the raw samples.
+ */
+void writeBenchJSON(const vector<BenchResult>& results, ostream& out);
+
+/**
+ * @brief Reads results written by writeBenchJSON.
+ * 
+ * @param filename JSON file.
+ * @param results Output results.
+ * @return True on success.
+ */
+bool loadBenchJSON(const string& filename, vector<BenchResult>& results);
+
+/**
+ * @struct BenchComparison
+ * @brief Outcome of comparing one solver/instance pair with its baseline.
+ */
+struct BenchComparison {
+    string instance;          ///< Instance name
+    string solver;            ///< Registry name of the solver
+    string verdict;           ///< "same", "regression", "improvement", "missing" or "new"
+    double baselineMillis = 0;///< Baseline median
+    double currentMillis = 0; ///< Current median
+    double ratio = 0;         ///< Current median / baseline median
+    double ciLow = 0;         ///< Lower end of the 95% bootstrap interval of the ratio
+    double ciHigh = 0;        ///< Upper end of the 95% bootstrap interval of the ratio
+};
+
+/**
+ * @brief Compares current results with a baseline using a bootstrap interval of the median ratio.
+ * 
+ * @param baseline Stored results.
+ * @param current Fresh results.
+ * @param threshold Relative slowdown tolerated beyond the noise (0.1 = 10%).
+ * @param minMillis Absolute slowdown of the median below which a pair is never a regression.
+ * @return One comparison per pair in either set.
+ */
+vector<BenchComparison> compareBench(const vector<BenchResult>& baseline, const vector<BenchResult>& current,
+                                     double threshold = 0.1, double minMillis = 0.1);
+
+/**
+ * @brief Writes the comparisons as CSV.
+ */
+void writeBenchComparison(const vector<BenchComparison>& comparisons, ostream& out);
+
+#endif //BENCH_H
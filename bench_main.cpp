@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "arguments.h"
+#include "bench.h"
+
+using namespace std;
+
+/**
+ * @brief Entry point of knapsack_bench.
+ *
+ * Usage: knapsack_bench [--repeats N] [--timeout SECONDS] [--solvers a,b,...]
+ * [--datasets DIR]... [--no-generated] [--perf] [--format csv|json] [--output FILE]
+ * [--compare BASELINE.json [--threshold FRACTION] [--min-ms MILLIS]]
+ *
+ * Progress goes to stderr, results to stdout or FILE. --perf adds hardware counters (cycles,
+ * instructions, IPC, cache and branch misses) where perf_event_open is permitted. With --compare
+ * the suite is rerun (on the baseline's solvers unless --solvers is given) and the comparison is
+ * written instead; the exit status is 1 if any pair regressed.
+ */
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    string format = "csv";
+    string output;
+    string baselineFile;
+    double threshold = 0.1;
+    double minMillis = 0.1;
+    bool customDirectories = false;
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (option == "--no-generated") {
+            options.generated = false;
+        } else if (option == "--perf") {
+            options.hardwareCounters = true;
+        } else if (option == "--repeats" && hasValue) {
+            valid = parseCount(argv[++i], options.repeats) && options.repeats > 0;
+        } else if (option == "--timeout" && hasValue) {
+            valid = parseNonNegative(argv[++i], options.timeout) && options.timeout > 0;
+        } else if (option == "--solvers" && hasValue) {
+            stringstream ss(argv[++i]);
+            string name;
+            while (getline(ss, name, ',')) {
+                if (!name.empty()) options.solvers.push_back(name);
+            }
+        } else if (option == "--datasets" && hasValue) {
+            if (!customDirectories) options.directories.clear();
+            customDirectories = true;
+            options.directories.push_back(argv[++i]);
+        } else if (option == "--format" && hasValue) {
+            format = argv[++i];
+            valid = format == "csv" || format == "json";
+        } else if (option == "--output" && hasValue) {
+            output = argv[++i];
+        } else if (option == "--compare" && hasValue) {
+            baselineFile = argv[++i];
+        } else if (option == "--threshold" && hasValue) {
+            valid = parseNonNegative(argv[++i], threshold);
+        } else if (option == "--min-ms" && hasValue) {
+            valid = parseNonNegative(argv[++i], minMillis);
+        } else {
+            cerr << "Unknown option: " << option << endl;
+            return 2;
+        }
+        if (!valid) {
+            cerr << "Invalid value for " << option << ": " << argv[i] << endl;
+            return 2;
+        }
+    }
+
+    vector<BenchResult> baseline;
+    if (!baselineFile.empty()) {
+        if (!loadBenchJSON(baselineFile, baseline)) {
+            cerr << "Error opening file!" << endl;
+            return 1;
+        }
+        if (options.solvers.empty()) {
+            for (const BenchResult& r : baseline) {
+                if (find(options.solvers.begin(), options.solvers.end(), r.solver) == options.solvers.end()) {
+                    options.solvers.push_back(r.solver);
+                }
+            }
+        }
+    }
+
+    vector<BenchResult> results = runBenchmark(options, &cerr);
+    ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            cerr << "Error opening file!" << endl;
+            return 1;
+        }
+    }
+    ostream& out = output.empty() ? cout : file;
+    if (!baselineFile.empty()) {
+        vector<BenchComparison> comparisons = compareBench(baseline, results, threshold, minMillis);
+        writeBenchComparison(comparisons, out);
+        for (const BenchComparison& c : comparisons) {
+            if (c.verdict == "regression") return 1;
+        }
+        return 0;
+    }
+    if (format == "json") {
+        writeBenchJSON(results, out);
+    } else {
+        writeBenchCSV(results, out);
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include <vector>
+#include <algorithm>
+#include <set>
+#include "bin_packing.h"
+#include "solver_stats.h"
+
+using namespace std;
+
+/**
+ * @brief Indices of the items that fit in a truck, sorted by decreasing weight.
+ */
+static vector<unsigned int> decreasingOrder(unsigned int weights[], unsigned int n, unsigned int capacity) {
+    vector<unsigned int> order;
+    order.reserve(n);
+    for (unsigned int i = 0; i < n; i++) {
+        if (weights[i] <= capacity) order.push_back(i);
+    }
+    stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return weights[a] > weights[b]; });
+    return order;
+}
+
+/**
+ * @brief First-Fit-Decreasing bin packing.
+ *
+ * Items are taken by decreasing weight and placed in the first (lowest-numbered) truck with
+ * enough room. The first such truck is found in O(log n) with a segment tree holding the
+ * maximum residual capacity of every range of trucks; unopened trucks hold the full capacity,
+ * so descending to the leftmost leaf that fits either finds an open truck or opens a new one.
+ *
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @return Number of trucks used. Items heavier than the capacity are left out.
+ */
+unsigned int binPackingFFD(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins) {
+    vector<unsigned int> order = decreasingOrder(weights, n, capacity);
+    bins.clear();
+    if (order.empty()) return 0;
+
+    unsigned int leaves = 1;
+    while (leaves < order.size()) leaves *= 2;
+    vector<unsigned int> tree(2 * leaves, capacity);
+
+    for (unsigned int item : order) {
+        unsigned int node = 1;
+        while (node < leaves) {
+            node = tree[2 * node] >= weights[item] ? 2 * node : 2 * node + 1;
+        }
+        unsigned int bin = node - leaves;
+        if (bin == bins.size()) bins.emplace_back();
+        bins[bin].push_back(item);
+        tree[node] -= weights[item];
+        for (node /= 2; node >= 1; node /= 2) {
+            tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+        }
+    }
+    return bins.size();
+}
+
+/**
+ * @brief Best-Fit-Decreasing bin packing.
+ *
+ * Items are taken by decreasing weight and placed in the open truck with the smallest residual
+ * capacity that still fits them, found in O(log n) in an ordered set of (residual, truck) pairs.
+ *
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @return Number of trucks used. Items heavier than the capacity are left out.
+ */
+unsigned int binPackingBFD(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins) {
+    vector<unsigned int> order = decreasingOrder(weights, n, capacity);
+    bins.clear();
+    set<pair<unsigned int, unsigned int>> open;
+
+    for (unsigned int item : order) {
+        auto it = open.lower_bound({weights[item], 0});
+        unsigned int bin;
+        unsigned int residual;
+        if (it == open.end()) {
+            bin = bins.size();
+            bins.emplace_back();
+            residual = capacity;
+        } else {
+            bin = it->second;
+            residual = it->first;
+            open.erase(it);
+        }
+        bins[bin].push_back(item);
+        open.insert({residual - weights[item], bin});
+    }
+    return bins.size();
+}
+
+/**
+ * @brief Lower bounds on the number of trucks.
+ *
+ * L1 is ceil(total weight / capacity). L2 (Martello and Toth) considers, for every threshold
+ * k <= C/2, the items heavier than C - k (one truck each), the items in (C/2, C - k] (one truck
+ * each, with some room left) and the items in [k, C/2], which must go into that leftover room
+ * or into new trucks. Only the distinct weights up to C/2 need to be tried as k, so the bound
+ * is computed in O(n log n) from the sorted weights and their prefix sums.
+ *
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param l1 Optional output with the simple L1 bound.
+ * @return The L2 lower bound.
+ */
+unsigned int binPackingLowerBound(unsigned int weights[], unsigned int n, unsigned int capacity, unsigned int* l1) {
+    vector<unsigned long long> sorted;
+    for (unsigned int i = 0; i < n; i++) {
+        if (weights[i] <= capacity) sorted.push_back(weights[i]);
+    }
+    sort(sorted.begin(), sorted.end());
+    unsigned int m = sorted.size();
+    vector<unsigned long long> prefix(m + 1, 0);
+    for (unsigned int k = 0; k < m; k++) prefix[k + 1] = prefix[k] + sorted[k];
+
+    unsigned long long C = capacity;
+    unsigned long long bound1 = C > 0 ? (prefix[m] + C - 1) / C : 0;
+    if (l1 != nullptr) *l1 = bound1;
+    if (C == 0) return 0;
+
+    // Number of items with weight <= x
+    auto countAtMost = [&](unsigned long long x) -> unsigned int {
+        return upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+    };
+    // Number of items with weight < x
+    auto countBelow = [&](unsigned long long x) -> unsigned int {
+        return lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+    };
+
+    unsigned long long best = bound1;
+    unsigned int halfEnd = countAtMost(C / 2);
+    vector<unsigned long long> thresholds = {0};
+    for (unsigned int k = 0; k < halfEnd; k++) {
+        if (thresholds.back() != sorted[k]) thresholds.push_back(sorted[k]);
+    }
+
+    for (unsigned long long k : thresholds) {
+        unsigned int bigStart = countAtMost(C - k);       // items > C - k
+        unsigned int midStart = halfEnd;                  // items in (C/2, C - k]
+        unsigned int smallStart = countBelow(max(k, 1ULL)); // items in [k, C/2]
+        unsigned long long big = m - bigStart;
+        unsigned long long mid = bigStart - midStart;
+        unsigned long long midWeight = prefix[bigStart] - prefix[midStart];
+        unsigned long long smallWeight = prefix[halfEnd] - prefix[smallStart];
+        unsigned long long room = mid * C - midWeight;
+        unsigned long long extra = smallWeight > room ? (smallWeight - room + C - 1) / C : 0;
+        best = max(best, big + mid + extra);
+    }
+    return best;
+}
+
+/**
+ * @brief Exact branch-and-bound bin packing for small instances.
+ *
+ * Starts from the better of FFD and BFD and stops as soon as it matches the L2 lower bound.
+ * Otherwise items are assigned by decreasing weight to every open truck with room (skipping
+ * trucks with the same residual capacity, which are interchangeable) or to a new truck. A node
+ * is pruned when the open trucks plus ceil((remaining weight - free room) / capacity) cannot
+ * beat the incumbent. The search keeps its path on an explicit stack, so its depth is not limited
+ * by the call stack. It stops with the best packing found so far when the node budget runs out or
+ * the token is cancelled (polled every 256 nodes).
+ *
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @param nodeLimit Maximum number of nodes to explore.
+ * @param optimal Optional output set to true if the result is proven optimal.
+ * @param cancel Optional cancellation token; the best packing found so far is returned.
+ * @return Number of trucks used by the best packing found.
+ */
+unsigned int binPackingExact(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins,
+                             unsigned long long nodeLimit, bool* optimal, const CancellationToken* cancel) {
+    vector<vector<unsigned int>> bfd;
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    unsigned int best = binPackingFFD(weights, n, capacity, bins);
+    if (binPackingBFD(weights, n, capacity, bfd) < best) {
+        best = bfd.size();
+        bins = bfd;
+    }
+    unsigned int lower = binPackingLowerBound(weights, n, capacity);
+    bool complete = true;
+
+    recorder.phase(SolverPhase::Solve);
+    if (best > lower) {
+        vector<unsigned int> order = decreasingOrder(weights, n, capacity);
+        unsigned int m = order.size();
+        vector<unsigned long long> suffix(m + 1, 0);
+        for (unsigned int k = m; k-- > 0;) suffix[k] = suffix[k + 1] + weights[order[k]];
+
+        vector<unsigned long long> residual;
+        vector<unsigned int> assign(m);
+        unsigned long long nodes = 0;
+        bool stopped = false;
+
+        /**
+         * @brief A node being expanded: the trucks open when it was reached, the next branch to
+         * try (open trucks 0..open-1, then open = a new truck) and the truck its item is on
+         * (-1 = none).
+         */
+        struct Frame {
+            unsigned int level;
+            unsigned int open;
+            unsigned int next;
+            int placed;
+            vector<unsigned long long> tried;  ///< Residual capacities already branched on
+        };
+        vector<Frame> stack;
+        stack.reserve(m + 1);
+
+        // Visits a node; pushes it if it has to be expanded
+        auto visit = [&](unsigned int level) {
+            if (best == lower) return;
+            if (++nodes > nodeLimit || (cancel != nullptr && (nodes & 255) == 0 && cancel->isCancelled())) {
+                complete = false;
+                stopped = true;
+                return;
+            }
+            recorder.nodeCreated();
+            if (level == m) {
+                recorder.incumbentUpdated();
+                best = residual.size();
+                bins.assign(best, {});
+                for (unsigned int k = 0; k < m; k++) bins[assign[k]].push_back(order[k]);
+                return;
+            }
+            unsigned long long freeRoom = 0;
+            for (unsigned long long r : residual) freeRoom += r;
+            unsigned long long overflow = suffix[level] > freeRoom ? suffix[level] - freeRoom : 0;
+            recorder.boundEvaluated();
+            if (residual.size() + (overflow + capacity - 1) / capacity >= best) {
+                recorder.nodePruned();
+                return;
+            }
+            recorder.nodeExpanded();
+            stack.push_back({level, (unsigned int) residual.size(), 0, -1, {}});
+        };
+
+        visit(0);
+        while (!stack.empty() && !stopped && best != lower) {
+            Frame& frame = stack.back();
+            unsigned int item = order[frame.level];
+            unsigned int level = frame.level;
+            if (frame.placed >= 0) {
+                if ((unsigned int) frame.placed == frame.open) residual.pop_back();
+                else residual[frame.placed] += weights[item];
+                frame.placed = -1;
+            }
+            if (frame.next > frame.open) {
+                stack.pop_back();
+                continue;
+            }
+            unsigned int b = frame.next++;
+            if (b == frame.open) {
+                if (residual.size() + 1 >= best) continue;
+                residual.push_back(capacity - weights[item]);
+                assign[level] = b;
+                frame.placed = b;
+                visit(level + 1);
+                continue;
+            }
+            if (weights[item] > residual[b]) continue;
+            if (find(frame.tried.begin(), frame.tried.end(), residual[b]) != frame.tried.end()) continue;
+            frame.tried.push_back(residual[b]);
+            residual[b] -= weights[item];
+            assign[level] = b;
+            frame.placed = b;
+            visit(level + 1);
+        }
+    }
+
+    if (optimal != nullptr) *optimal = complete;
+    return best;
+}
@@ -0,0 +1,57 @@
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef BIN_PACKING_H
+#define BIN_PACKING_H
+
+/**
+ * @brief First-Fit-Decreasing bin packing: minimum number of trucks to ship every pallet.
+ * 
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @return Number of trucks used. Items heavier than the capacity are left out.
+ */
+unsigned int binPackingFFD(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins);
+
+/**
+ * @brief Best-Fit-Decreasing bin packing: minimum number of trucks to ship every pallet.
+ * 
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @return Number of trucks used. Items heavier than the capacity are left out.
+ */
+unsigned int binPackingBFD(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins);
+
+/**
+ * @brief Lower bound on the number of trucks (Martello-Toth L2, which dominates L1).
+ * 
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param l1 Optional output with the simple L1 bound, ceil(total weight / capacity).
+ * @return The L2 lower bound.
+ */
+unsigned int binPackingLowerBound(unsigned int weights[], unsigned int n, unsigned int capacity, unsigned int* l1 = nullptr);
+
+/**
+ * @brief Exact branch-and-bound bin packing for small instances.
+ * 
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacity Capacity of every truck.
+ * @param bins Output with the (0-based) item indices loaded on each truck.
+ * @param nodeLimit Maximum number of nodes to explore.
+ * @param optimal Optional output set to true if the result is proven optimal.
+ * @param cancel Optional cancellation token; the best packing found so far is returned.
+ * @return Number of trucks used by the best packing found.
+ */
+unsigned int binPackingExact(unsigned int weights[], unsigned int n, unsigned int capacity, vector<vector<unsigned int>>& bins,
+                             unsigned long long nodeLimit = 5000000, bool* optimal = nullptr,
+                             const CancellationToken* cancel = nullptr);
+
+#endif //BIN_PACKING_H
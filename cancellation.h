@@ -0,0 +1,77 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+/**
+ * @enum SolveStatus
+ * @brief How a solver run ended.
+ */
+enum class SolveStatus {
+    Optimal,    ///< The solver finished and the solution is proven optimal
+    Feasible,   ///< The solver finished with a heuristic (feasible, not proven) solution
+    Cancelled   ///< The run was interrupted; the returned solution is the best one known
+};
+
+/**
+ * @class CancellationToken
+ * @brief Shared flag through which one thread asks solvers running on others to stop, with an
+ * optional deadline and an optional parent token.
+ *
+ * Solvers poll isCancelled() at cheap intervals (per DP row, every few hundred nodes or
+ * subsets) and return their best-known feasible solution as soon as it is set. The token also
+ * reports cancellation once its deadline has passed or its parent is cancelled, so a solver
+ * needs no timer thread to honour a time limit and a caller can tighten an outer request's
+ * deadline for one stage of it.
+ */
+class CancellationToken {
+public:
+    /**
+     * @param seconds Deadline, in seconds from now (0 = none).
+     * @param parent Optional token whose cancellation also cancels this one.
+     */
+    explicit CancellationToken(double seconds = 0, const CancellationToken* parent = nullptr) : parent(parent) {
+        setDeadline(seconds);
+    }
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /**
+     * @brief Requests cancellation of every solver polling this token.
+     */
+    void cancel() { cancelled.store(true, memory_order_relaxed); }
+
+    /**
+     * @brief Sets the deadline, in seconds from now (0 = none).
+     */
+    void setDeadline(double seconds) {
+        deadline.store(seconds > 0 ? now() + (int64_t) (seconds * 1e9) : INT64_MAX, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Whether cancellation was requested, the deadline has passed or the parent is cancelled.
+     */
+    bool isCancelled() const {
+        if (cancelled.load(memory_order_relaxed)) return true;
+        if ((parent != nullptr && parent->isCancelled()) ||
+            (deadline.load(memory_order_relaxed) != INT64_MAX && now() >= deadline.load(memory_order_relaxed))) {
+            cancelled.store(true, memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static int64_t now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    mutable atomic<bool> cancelled{false};
+    atomic<int64_t> deadline{INT64_MAX};  ///< steady_clock nanoseconds, INT64_MAX if none
+    const CancellationToken* parent;
+};
+
+#endif //CANCELLATION_H
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "dataset.h"
+#include "data_loader.h"
+#include "dataset_catalog.h"
+
+using namespace std;
+
+/**
+ * @brief Entry point of knapsack_catalog.
+ *
+ * Usage: knapsack_catalog [--check] <pallets.csv|instance.knap> [truck.csv]
+ *
+ * Builds the sidecar catalog of a dataset (ratio order, prefix sums, totals, weight GCD and
+ * duplicate classes) and writes it next to the pallets file, where the menu, the command line
+ * and the solver daemon pick it up. With --check the existing sidecar is only validated against
+ * the dataset; the exit status is 0 if it is valid and 1 if it is missing or stale.
+ */
+int main(int argc, char* argv[]) {
+    bool check = false;
+    vector<string> files;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--check") check = true;
+        else if (argument.rfind("--", 0) == 0) {
+            cerr << "Unknown option: " << argument << endl;
+            return 2;
+        } else files.push_back(argument);
+    }
+    if (files.empty() || files.size() > 2) {
+        cerr << "Usage: knapsack_catalog [--check] <pallets.csv|instance.knap> [truck.csv]" << endl;
+        return 2;
+    }
+
+    vector<Pallet> pallets;
+    Truck truck;
+    string error;
+    if (!load_instance(files[0], files.size() > 1 ? files[1] : "", pallets, truck, &error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    unsigned int n = min<size_t>(truck.pallets, pallets.size());
+    vector<unsigned int> values(n), weights(n);
+    for (unsigned int i = 0; i < n; i++) {
+        values[i] = pallets[i].profit;
+        weights[i] = pallets[i].weight;
+    }
+
+    string sidecar = catalogPath(files[0]);
+    DatasetCatalog catalog;
+    if (check) {
+        bool valid = loadCatalog(sidecar, values.data(), weights.data(), n, truck.capacity, catalog);
+        cout << sidecar << ": " << (valid ? "valid" : "missing or stale") << endl;
+        return valid ? 0 : 1;
+    }
+
+    buildCatalog(values.data(), weights.data(), n, truck.capacity, catalog);
+    if (!saveCatalog(sidecar, catalog)) {
+        cerr << "Error opening file!" << endl;
+        return 1;
+    }
+    cout << sidecar << ": " << n << " pallets, capacity " << truck.capacity << ", total weight "
+         << catalog.prefixWeight[n] << ", total profit " << catalog.prefixProfit[n] << ", weight GCD "
+         << catalog.weightGcd << ", " << catalog.classes << " distinct pallets" << endl;
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include "arguments.h"
+#include "batch.h"
+#include "cli.h"
+#include "data_loader.h"
+#include "dataset.h"
+#include "json.h"
+#include "knapsack.h"
+#include "server.h"
+#include "solver_select.h"
+#include "solvers.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief Name of a solve status as printed by the command line ("optimal", "feasible", "cancelled").
+ */
+const char* solveStatusName(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::Optimal: return "optimal";
+        case SolveStatus::Feasible: return "feasible";
+        case SolveStatus::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Reads the options of a solve from the command line.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments, without the program name.
+ * @param options Output options.
+ * @return True if every argument was understood (problems are printed to cerr).
+ */
+bool parseCliOptions(int argc, char* argv[], CliOptions& options) {
+    for (int i = 0; i < argc; i++) {
+        string option = argv[i];
+        string value;
+        bool hasValue = false;
+        size_t equals = option.find('=');
+        if (equals != string::npos) {
+            value = option.substr(equals + 1);
+            option = option.substr(0, equals);
+            hasValue = true;
+        } else if (option != "--perf" && i + 1 < argc) {
+            value = argv[++i];
+            hasValue = true;
+        }
+
+        if (option == "--perf" && !hasValue) {
+            options.perf = true;
+        } else if (!hasValue) {
+            cerr << "Unknown option: " << option << endl;
+            return false;
+        } else if (option == "--pallets") {
+            options.palletsFile = value;
+        } else if (option == "--truck") {
+            options.truckFile = value;
+        } else if (option == "--algo") {
+            options.algorithm = value;
+        } else if (option == "--threads") {
+            if (!parseCount(value, options.threads)) {
+                cerr << "Invalid thread count: " << value << endl;
+                return false;
+            }
+        } else if (option == "--time-limit") {
+            if (!parseNonNegative(value, options.timeLimit)) {
+                cerr << "Invalid time limit: " << value << endl;
+                return false;
+            }
+        } else if (option == "--format") {
+            if (value != "json" && value != "csv") {
+                cerr << "Invalid format: " << value << endl;
+                return false;
+            }
+            options.format = value;
+        } else if (option == "--cache") {
+            options.cacheFile = value;
+        } else {
+            cerr << "Unknown option: " << option << endl;
+            return false;
+        }
+    }
+    return !options.palletsFile.empty();
+}
+
+/**
+ * @brief Loads the instance and runs the chosen solver with the given thread count and time limit.
+ *
+ * @param options Solve settings; the algorithm must name a registered solver.
+ * @return The result, with load and solve timings.
+ */
+CliResult solveCli(const CliOptions& options) {
+    const SolverInfo* solver = findSolver(options.algorithm);
+    CliResult result;
+    result.algorithm = solver->name;
+
+    DatasetRegistry datasets;
+    string error;
+    shared_ptr<const LoadedDataset> dataset = datasets.get(options.palletsFile, options.truckFile, nullptr, &result.loadMillis, &error);
+    if (dataset == nullptr) {
+        cerr << error << endl;
+        result.status = "load-error";
+        return result;
+    }
+    SolutionCache cache;
+    if (!options.cacheFile.empty() && !cache.open(options.cacheFile, &error)) {
+        cerr << "Error opening solution cache: " << error << endl;
+    }
+    solveLoaded(*solver, options, *dataset, result, options.cacheFile.empty() ? nullptr : &cache);
+    result.stats.loadSeconds = result.loadMillis / 1000;
+    return result;
+}
+
+/**
+ * @brief Runs a solver on item columns through the library, filling the result's size, status,
+ * profit, timings and counters (not the pallet IDs and weight, which the caller derives from the
+ * solution).
+ *
+ * @param solver Registry entry of the solver.
+ * @param options Thread count, time limit and whether to measure hardware counters.
+ * @param instance Item columns and capacity.
+ * @param solution Output solution.
+ * @param result Output result.
+ * @param cache Optional solution cache, consulted before solving and filled after.
+ */
+void solveColumns(const SolverInfo& solver, const CliOptions& options, const KnapsackInstance& instance,
+                  KnapsackSolution& solution, CliResult& result, SolutionCache* cache) {
+    result.algorithm = solver.name;
+    result.n = instance.n;
+    result.capacity = instance.capacity;
+    Solver library(solver);
+    if (!library.fits(instance)) {
+        result.status = "too-large";
+        return;
+    }
+
+    KnapsackOptions limits;
+    limits.threads = options.threads;
+    limits.timeLimit = options.timeLimit;
+    unique_ptr<PerfCounters> counters;
+    if (options.perf) counters.reset(new PerfCounters());
+    auto solveStart = chrono::steady_clock::now();
+    if (counters) counters->start();
+    SolutionKey key;
+    if (cache != nullptr) {
+        key = solutionKey(library, limits, instance);
+        result.solutionCached = cache->lookup(key, instance, solution);
+    }
+    if (!result.solutionCached) {
+        result.stats = library.solve(instance, limits, solution);
+        if (cache != nullptr) cache->store(key, instance, solution);
+    }
+    if (counters) result.perf = counters->stop();
+    result.solveMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - solveStart).count();
+    result.profit = solution.profit;
+    result.status = solveStatusName(solution.status);
+}
+
+/**
+ * @brief Runs a solver on an instance already in memory, filling everything but the load time.
+ *
+ * @param solver Registry entry of the solver.
+ * @param options Thread count, time limit and whether to measure hardware counters.
+ * @param dataset Pallets and truck of the instance, and its catalog if it has one.
+ * @param result Output result.
+ * @param cache Optional solution cache, consulted before solving and filled after.
+ */
+void solveLoaded(const SolverInfo& solver, const CliOptions& options, const LoadedDataset& dataset, CliResult& result,
+                 SolutionCache* cache) {
+    const vector<Pallet>& pallets = dataset.pallets;
+    const Truck& truck = dataset.truck;
+    unsigned int n = min<size_t>(truck.pallets, pallets.size());
+    vector<unsigned int> values(n), weights(n);
+    for (unsigned int i = 0; i < n; i++) {
+        values[i] = pallets[i].profit;
+        weights[i] = pallets[i].weight;
+    }
+    KnapsackInstance instance(weights, values, truck.capacity);
+    instance.catalog = dataset.catalog.get();
+    KnapsackSolution solution;
+    solveColumns(solver, options, instance, solution, result, cache);
+    for (unsigned int i = 0; i < solution.selected.size(); i++) {
+        if (solution.selected[i]) result.pallets.push_back(pallets[i].pallet);
+    }
+    result.weight = solution.weight;
+}
+
+/**
+ * @brief A result as one JSON object, without a trailing newline.
+ */
+string cliResultJSON(const CliResult& result) {
+    ostringstream out;
+    out << "{\"algorithm\": " << jsonQuote(result.algorithm) << ", \"status\": " << jsonQuote(result.status)
+        << ", \"n\": " << result.n << ", \"capacity\": " << result.capacity << ", \"profit\": " << result.profit
+        << ", \"weight\": " << result.weight << ", \"solution_cached\": " << (result.solutionCached ? "true" : "false")
+        << ", \"pallets\": [";
+    for (size_t k = 0; k < result.pallets.size(); k++) {
+        out << (k ? ", " : "") << result.pallets[k];
+    }
+    out << "], \"timing\": {\"load_ms\": " << result.loadMillis << ", \"solve_ms\": " << result.solveMillis
+        << ", \"total_ms\": " << result.loadMillis + result.solveMillis << "}, \"stats\": " << solverStatsJSON(result.stats)
+        << ", \"perf\": " << perfJSON(result.perf) << "}";
+    return out.str();
+}
+
+/**
+ * @brief Formats a result as one JSON object or as a CSV header and row.
+ *
+ * In CSV the pallet IDs form one field, separated by spaces.
+ *
+ * @param result Result to format.
+ * @param format "json" or "csv".
+ * @return The complete output, newline-terminated.
+ */
+string formatCliResult(const CliResult& result, const string& format) {
+    ostringstream out;
+    if (format == "csv") {
+        out << "algorithm,status,n,capacity,profit,weight,load_ms,solve_ms,pallets\n"
+            << result.algorithm << "," << result.status << "," << result.n << "," << result.capacity << ","
+            << result.profit << "," << result.weight << "," << result.loadMillis << "," << result.solveMillis << ",";
+        for (size_t k = 0; k < result.pallets.size(); k++) {
+            out << (k ? " " : "") << result.pallets[k];
+        }
+        out << "\n";
+        return out.str();
+    }
+    return cliResultJSON(result) + "\n";
+}
+
+/**
+ * @brief Solves one instance and prints the result with a single write.
+ */
+static int runSolve(int argc, char* argv[]) {
+    CliOptions options;
+    if (!parseCliOptions(argc, argv, options)) {
+        cerr << "Usage: --pallets FILE [--truck FILE] [--algo NAME] [--threads N] [--time-limit SECONDS]"
+                " [--format json|csv] [--cache FILE] [--perf]" << endl;
+        return 2;
+    }
+    if (findSolver(options.algorithm) == nullptr) {
+        cerr << "Unknown algorithm: " << options.algorithm << endl;
+        return 2;
+    }
+    CliResult result = solveCli(options);
+    string text = formatCliResult(result, options.format);
+    cout.write(text.data(), text.size());
+    cout.flush();
+    return result.status == "load-error" || result.status == "too-large" ? 1 : 0;
+}
+
+/**
+ * @brief Runs the command line modes.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments, including the program name.
+ * @return Process exit status: 0 on success, 1 on failure, 2 on a usage error.
+ */
+int runCommandLine(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--trace" && argc > 2) {
+        string traceFile = argv[2];
+        argv[2] = argv[0];
+        setTraceThreadName("main");
+        startTrace();
+        int result = runCommandLine(argc - 2, argv + 2);
+        stopTrace();
+        bool written = writeChromeTrace(traceFile);
+        if (!written) cerr << "Error opening file: " << traceFile << endl;
+        return result != 0 ? result : (written ? 0 : 1);
+    }
+    if (mode == "--calibrate" && argc > 2) {
+        return saveCostModel(argv[2], calibrateCostModel()) ? 0 : 1;
+    }
+    if (mode == "--serve") {
+        ServerOptions options;
+        for (int i = 2; i < argc; i += 2) {
+            string option = argv[i];
+            string value = i + 1 < argc ? argv[i + 1] : "";
+            unsigned long long entries = options.cacheEntries;
+            bool valid = i + 1 < argc;
+            if (valid && option == "--socket") options.socketPath = value;
+            else if (valid && option == "--threads") valid = parseCount(value, options.threads);
+            else if (valid && option == "--cache") options.cacheFile = value;
+            else if (valid && option == "--cache-entries") valid = parseCount(value, SIZE_MAX, entries);
+            else valid = false;
+            options.cacheEntries = entries;
+            if (!valid) {
+                cerr << "Usage: --serve [--socket PATH] [--threads N] [--cache FILE] [--cache-entries N]" << endl;
+                return 2;
+            }
+        }
+        return runServer(options);
+    }
+    if (mode == "--batch" && argc > 2) {
+        string algorithm = "dp";
+        unsigned int threads = 0;
+        for (int i = 3; i < argc; i += 2) {
+            string option = argv[i];
+            bool valid = i + 1 < argc;
+            if (valid && option == "--algo") algorithm = argv[i + 1];
+            else if (valid && option == "--threads") valid = parseCount(argv[i + 1], threads);
+            else valid = false;
+            if (!valid) {
+                cerr << "Usage: --batch DIRECTORY|MANIFEST [--algo NAME] [--threads N]" << endl;
+                return 2;
+            }
+        }
+        string error;
+        vector<BatchJob> jobs = discoverBatchJobs(argv[2], &error);
+        unsigned int failures = error.empty() ? runBatch(jobs, algorithm, threads, cout, &error) : 1;
+        if (!error.empty()) cerr << error << endl;
+        return failures == 0 ? 0 : 1;
+    }
+    return runSolve(argc - 1, argv + 1);
+}
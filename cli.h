@@ -0,0 +1,131 @@
+#include <string>
+#include <vector>
+#include "dataset.h"
+#include "dataset_registry.h"
+#include "knapsack.h"
+#include "perf_counters.h"
+#include "solver_stats.h"
+#include "solution_cache.h"
+#include "solvers.h"
+using namespace std;
+
+#ifndef CLI_H
+#define CLI_H
+
+/**
+ * @struct CliOptions
+ * @brief Settings of a non-interactive solve.
+ */
+struct CliOptions {
+    string palletsFile;         ///< Pallets CSV or binary .knap instance
+    string truckFile;           ///< Truck CSV (not needed for .knap instances)
+    string algorithm = "auto";  ///< Solver name (see knapsackSolvers())
+    unsigned int threads = 0;   ///< Threads for the solvers that use them (0 = one per hardware thread)
+    double timeLimit = 0;       ///< Wall-clock budget in seconds (0 = each solver's default)
+    string format = "json";     ///< "json" or "csv"
+    bool perf = false;          ///< Also measure hardware counters
+    string cacheFile;           ///< On-disk solution cache to consult and fill (empty = none)
+};
+
+/**
+ * @struct CliResult
+ * @brief Outcome of a non-interactive solve.
+ */
+struct CliResult {
+    string algorithm;
+    string status;              ///< "optimal", "feasible", "cancelled", "load-error", "too-large" (or "expired" from the server)
+    unsigned int n = 0;
+    unsigned int capacity = 0;
+    unsigned int profit = 0;
+    unsigned long long weight = 0;
+    vector<int> pallets;        ///< IDs of the chosen pallets, in file order
+    bool solutionCached = false; ///< Answered from the solution cache instead of solving
+    double loadMillis = 0;
+    double solveMillis = 0;
+    SolverStats stats;
+    PerfReading perf;
+};
+
+/**
+ * @brief Name of a solve status as printed by the command line ("optimal", "feasible", "cancelled").
+ */
+const char* solveStatusName(SolveStatus status);
+
+/**
+ * @brief Reads the options of a solve from the command line.
+ *
+ * Accepts "--pallets FILE", "--truck FILE", "--algo NAME", "--threads N", "--time-limit SECONDS",
+ * "--format json|csv", "--cache FILE" and "--perf"; values may also be given as "--option=value".
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments, without the program name.
+ * @param options Output options.
+ * @return True if every argument was understood.
+ */
+bool parseCliOptions(int argc, char* argv[], CliOptions& options);
+
+/**
+ * @brief Runs a solver on item columns through the library, filling the result's size, status,
+ * profit, timings and counters (not the pallet IDs and weight, which the caller derives from the
+ * solution).
+ *
+ * @param solver Registry entry of the solver.
+ * @param options Thread count, time limit and whether to measure hardware counters.
+ * @param instance Item columns and capacity.
+ * @param solution Output solution.
+ * @param result Output result.
+ * @param cache Optional solution cache, consulted before solving and filled after.
+ */
+void solveColumns(const SolverInfo& solver, const CliOptions& options, const KnapsackInstance& instance,
+                  KnapsackSolution& solution, CliResult& result, SolutionCache* cache = nullptr);
+
+/**
+ * @brief Runs a solver on an instance already in memory, filling everything but the load time.
+ *
+ * @param solver Registry entry of the solver.
+ * @param options Thread count, time limit and whether to measure hardware counters.
+ * @param dataset Pallets and truck of the instance, and its catalog if it has one.
+ * @param result Output result.
+ * @param cache Optional solution cache, consulted before solving and filled after.
+ */
+void solveLoaded(const SolverInfo& solver, const CliOptions& options, const LoadedDataset& dataset, CliResult& result,
+                 SolutionCache* cache = nullptr);
+
+/**
+ * @brief Loads the instance and runs the chosen solver with the given thread count and time limit.
+ *
+ * @param options Solve settings; the algorithm must name a registered solver.
+ * @return The result, with load and solve timings.
+ */
+CliResult solveCli(const CliOptions& options);
+
+/**
+ * @brief A result as one JSON object, without a trailing newline.
+ */
+string cliResultJSON(const CliResult& result);
+
+/**
+ * @brief Formats a result as one JSON object or as a CSV header and row.
+ *
+ * @param result Result to format.
+ * @param format "json" or "csv".
+ * @return The complete output, newline-terminated.
+ */
+string formatCliResult(const CliResult& result, const string& format);
+
+/**
+ * @brief Runs the command line modes.
+ *
+ * "--pallets FILE [--truck FILE] [...]" solves one instance and prints the result in a single
+ * write, "--batch <directory|manifest> [--algo NAME] [--threads N]" runs a batch,
+ * "--calibrate <file>" calibrates the cost model and "--serve [--socket PATH] [--threads N]
+ * [--cache FILE] [--cache-entries N]" starts the solver daemon (see runServer()). A leading
+ * "--trace <file>" records any of them as Chrome trace JSON.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments, including the program name.
+ * @return Process exit status: 0 on success, 1 on failure, 2 on a usage error.
+ */
+int runCommandLine(int argc, char* argv[]);
+
+#endif //CLI_H
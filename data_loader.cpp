@@ -1,10 +1,11 @@
-#include <iostream>
+#include <cstdint>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include "dataset.h"
 #include "data_loader.h"
+#include "trace.h"
 using namespace std;
 
 /**
@@ -14,15 +15,16 @@ using namespace std;
  * containing pallet ID, profit, and weight, separated by commas.
  * 
  * @param filename Path to the CSV file containing pallet data.
+ * @param error Optional output: why the file could not be loaded.
  * @return Vector of Pallet objects loaded from the file.
  */
-vector<Pallet> load_data_pallets(string filename) {
-
+vector<Pallet> load_data_pallets(string filename, string* error) {
+    TraceScope trace("load pallets", "load");
     ifstream file(filename);
 
     // Check if the file was opened successfully
     if (!file.is_open()) {
-        cerr << "Error opening file!" << endl;
+        if (error != nullptr) *error = "Error opening file: " + filename;
         return {};
     }
 
@@ -34,6 +36,7 @@ vector<Pallet> load_data_pallets(string filename) {
     vector<Pallet> pallets;
 
     while (getline(file, line)) {
+        if (line.find_first_not_of(" \r\t") == string::npos) continue;
         stringstream ss(line);
         string palletid, profit, weight;
 
@@ -57,31 +60,132 @@ vector<Pallet> load_data_pallets(string filename) {
 }
 
 /**
- * @brief Loads truck data from a CSV file.
+ * @brief Loads a fleet of trucks from a CSV file.
  * 
- * The CSV file is expected to have a header line, followed by a single
- * line containing truck capacity and number of pallets, separated by commas.
+ * The CSV file is expected to have a header line, followed by one line per truck
+ * containing its capacity and the number of pallets, separated by commas.
  * 
  * @param filename Path to the CSV file containing truck data.
- * @return Truck object loaded from the file. Returns Truck(0, 0) on error.
+ * @param error Optional output: why the file could not be loaded.
+ * @return Vector with one Truck per data line. Returns an empty vector on error.
  */
-Truck load_data_trucks(string filename) {
+vector<Truck> load_data_fleet(string filename, string* error) {
+    TraceScope trace("load trucks", "load");
     ifstream file(filename);
     if (!file.is_open()) {
-        cerr << "Error opening file!" << endl;
-        return {0, 0};
+        if (error != nullptr) *error = "Error opening file: " + filename;
+        return {};
     }
     string line;
-    int capacity_int, pallets_int;
     getline(file, line); // Skip header
+    vector<Truck> trucks;
     while (getline(file, line)) {
+        if (line.find_first_not_of(" \r\t") == string::npos) continue;
         stringstream ss(line);
         string capacity, pallets;
         getline(ss, capacity, ',');
         getline(ss, pallets, ',');
-        capacity_int = stoi(capacity);
-        pallets_int = stoi(pallets);
+        trucks.push_back(Truck(stoi(capacity), stoi(pallets)));
     }
     file.close();
-    return Truck(capacity_int, pallets_int);
+    return trucks;
+}
+
+/**
+ * @brief Loads truck data from a CSV file.
+ * 
+ * The CSV file is expected to have a header line, followed by a line
+ * containing truck capacity and number of pallets, separated by commas.
+ * For fleet files with several trucks, the first truck is returned.
+ * 
+ * @param filename Path to the CSV file containing truck data.
+ * @param error Optional output: why the file could not be loaded.
+ * @return Truck object loaded from the file. Returns Truck(0, 0) on error.
+ */
+Truck load_data_trucks(string filename, string* error) {
+    vector<Truck> trucks = load_data_fleet(filename, error);
+    if (trucks.empty()) {
+        return {0, 0};
+    }
+    return trucks.front();
+}
+
+/**
+ * @brief Loads a binary instance written by knapsack_gen --format binary.
+ * 
+ * Layout (native little-endian): "KNAP", uint32 version = 1, uint64 n, uint32 capacity,
+ * uint32 weights[n], uint32 profits[n]. Both arrays are read in one block each.
+ * 
+ * @param filename Path to the binary file.
+ * @param pallets Output pallets, with IDs 1..n.
+ * @param truck Output truck (capacity and number of pallets).
+ * @param error Optional output: why the file could not be loaded.
+ * @return True on success.
+ */
+bool load_data_binary(string filename, vector<Pallet>& pallets, Truck& truck, string* error) {
+    TraceScope trace("load binary", "load");
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        if (error != nullptr) *error = "Error opening file: " + filename;
+        return false;
+    }
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t n = 0;
+    uint32_t capacity = 0;
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&n), sizeof(n));
+    file.read(reinterpret_cast<char*>(&capacity), sizeof(capacity));
+    if (!file || string(magic, 4) != "KNAP" || version != 1 || n > INT32_MAX || capacity > INT32_MAX) {
+        if (error != nullptr) *error = "Invalid binary instance: " + filename;
+        return false;
+    }
+
+    vector<uint32_t> weights(n), profits(n);
+    file.read(reinterpret_cast<char*>(weights.data()), n * sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(profits.data()), n * sizeof(uint32_t));
+    if (!file) {
+        if (error != nullptr) *error = "Truncated binary instance: " + filename;
+        return false;
+    }
+    pallets.clear();
+    pallets.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        pallets.push_back(Pallet(i + 1, weights[i], profits[i]));
+    }
+    truck = Truck(capacity, n);
+    return true;
+}
+
+/**
+ * @brief Loads an instance from a pair of CSV files, or from a binary file (.knap).
+ * 
+ * @param palletsFile Pallets CSV file, or binary instance.
+ * @param truckFile TruckAndPallets CSV file (ignored for binary instances).
+ * @param pallets Output pallets.
+ * @param truck Output truck.
+ * @param error Optional output: why the instance could not be loaded (set whenever false is
+ * returned).
+ * @return True if pallets and a truck with positive capacity were loaded.
+ */
+bool load_instance(string palletsFile, string truckFile, vector<Pallet>& pallets, Truck& truck, string* error) {
+    string reason;
+    if (palletsFile.size() >= 5 && palletsFile.compare(palletsFile.size() - 5, 5, ".knap") == 0) {
+        if (!load_data_binary(palletsFile, pallets, truck, &reason)) {
+            if (error != nullptr) *error = reason;
+            return false;
+        }
+    } else {
+        pallets = load_data_pallets(palletsFile, &reason);
+        if (!pallets.empty()) truck = load_data_trucks(truckFile, &reason);
+    }
+    if (pallets.empty() || truck.capacity <= 0) {
+        if (reason.empty()) {
+            reason = pallets.empty() ? "No pallets in " + palletsFile : "No truck with a positive capacity in " + truckFile;
+        }
+        if (error != nullptr) *error = reason;
+        return false;
+    }
+    return true;
 }
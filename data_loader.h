@@ -9,16 +9,50 @@ using namespace std;
  * @brief Loads pallet data from a CSV file.
  * 
  * @param filename Path to the CSV file containing pallet data.
+ * @param error Optional output: why the file could not be loaded.
  * @return Vector of Pallet objects loaded from the file.
  */
-vector<Pallet> load_data_pallets(string filename);
+vector<Pallet> load_data_pallets(string filename, string* error = nullptr);
 
 /**
  * @brief Loads truck data from a CSV file.
  * 
  * @param filename Path to the CSV file containing truck data.
+ * @param error Optional output: why the file could not be loaded.
  * @return Truck object loaded from the file.
  */
-Truck load_data_trucks(string filename);
+Truck load_data_trucks(string filename, string* error = nullptr);
+
+/**
+ * @brief Loads every truck of a fleet from a CSV file with one truck per line.
+ * 
+ * @param filename Path to the CSV file containing truck data.
+ * @param error Optional output: why the file could not be loaded.
+ * @return Vector of Truck objects, one per data line.
+ */
+vector<Truck> load_data_fleet(string filename, string* error = nullptr);
+
+/**
+ * @brief Loads a binary instance written by knapsack_gen --format binary.
+ * 
+ * @param filename Path to the binary file.
+ * @param pallets Output pallets, with IDs 1..n.
+ * @param truck Output truck (capacity and number of pallets).
+ * @param error Optional output: why the file could not be loaded.
+ * @return True on success.
+ */
+bool load_data_binary(string filename, vector<Pallet>& pallets, Truck& truck, string* error = nullptr);
+
+/**
+ * @brief Loads an instance from a pair of CSV files, or from a binary file (.knap).
+ * 
+ * @param palletsFile Pallets CSV file, or binary instance.
+ * @param truckFile TruckAndPallets CSV file (ignored for binary instances).
+ * @param pallets Output pallets.
+ * @param truck Output truck.
+ * @param error Optional output: why the instance could not be loaded.
+ * @return True if pallets and a truck with positive capacity were loaded.
+ */
+bool load_instance(string palletsFile, string truckFile, vector<Pallet>& pallets, Truck& truck, string* error = nullptr);
 
 #endif //DATA_LOADER_H
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <utility>
+#include "dataset_catalog.h"
+#include "hash.h"
+
+using namespace std;
+
+/**
+ * @struct CatalogHeader
+ * @brief First 48 bytes of a sidecar, followed by ratioOrder[n], duplicateClass[n] (u32) and
+ * prefixWeight[n + 1], prefixProfit[n + 1] (u64), in host byte order.
+ */
+struct CatalogHeader {
+    char magic[4];             ///< "KCAT"
+    uint32_t version;          ///< 1
+    uint32_t n;
+    uint32_t capacity;
+    uint32_t weightGcd;
+    uint32_t classes;
+    uint64_t checksum;         ///< instanceChecksum() of the dataset
+    uint64_t payloadChecksum;  ///< xxHash64 of the arrays that follow
+    uint64_t reserved;
+};
+
+static_assert(sizeof(CatalogHeader) == 48, "the catalog header is part of the sidecar format");
+
+/**
+ * @brief Checksum of an instance (xxHash64 of capacity, n and both columns).
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @return The checksum.
+ */
+uint64_t instanceChecksum(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                          unsigned int maxWeight) {
+    uint32_t shape[2] = {maxWeight, n};
+    uint64_t hash = xxHash64(shape, sizeof(shape), 0);
+    hash = xxHash64(weights, (size_t) n * sizeof(unsigned int), hash);
+    return xxHash64(values, (size_t) n * sizeof(unsigned int), hash);
+}
+
+/**
+ * @brief Whether an order lists every item exactly once, by decreasing ratio with ties by index
+ * (the order buildCatalog() produces).
+ */
+static bool isRatioOrder(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                         const vector<unsigned int>& order) {
+    if (order.size() != n) return false;
+    vector<char> seen(n, 0);
+    for (unsigned int k = 0; k < n; k++) {
+        unsigned int item = order[k];
+        if (item >= n || seen[item]) return false;
+        seen[item] = 1;
+        if (k == 0) continue;
+        unsigned int previous = order[k - 1];
+        unsigned long long before = (unsigned long long) values[previous] * weights[item];
+        unsigned long long after = (unsigned long long) values[item] * weights[previous];
+        if (before < after || (before == after && previous > item)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sets a catalog's prefix sums from its ratio order.
+ */
+static void fillPrefixSums(const unsigned int values[], const unsigned int weights[], DatasetCatalog& catalog) {
+    unsigned int n = catalog.ratioOrder.size();
+    catalog.prefixWeight.assign(n + 1, 0);
+    catalog.prefixProfit.assign(n + 1, 0);
+    for (unsigned int k = 0; k < n; k++) {
+        catalog.prefixWeight[k + 1] = catalog.prefixWeight[k] + weights[catalog.ratioOrder[k]];
+        catalog.prefixProfit[k + 1] = catalog.prefixProfit[k] + values[catalog.ratioOrder[k]];
+    }
+}
+
+/**
+ * @brief Computes the catalog of an instance.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @param catalog Output catalog.
+ */
+void buildCatalog(const unsigned int values[], const unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                  DatasetCatalog& catalog) {
+    catalog.n = n;
+    catalog.capacity = maxWeight;
+    catalog.checksum = instanceChecksum(values, weights, n, maxWeight);
+
+    // Exact cross-multiplied ratio comparison, as the solvers use
+    catalog.ratioOrder.resize(n);
+    iota(catalog.ratioOrder.begin(), catalog.ratioOrder.end(), 0);
+    stable_sort(catalog.ratioOrder.begin(), catalog.ratioOrder.end(), [&](unsigned int a, unsigned int b) {
+        return (unsigned long long) values[a] * weights[b] > (unsigned long long) values[b] * weights[a];
+    });
+    fillPrefixSums(values, weights, catalog);
+
+    catalog.weightGcd = maxWeight;
+    for (unsigned int i = 0; i < n; i++) catalog.weightGcd = gcd(catalog.weightGcd, weights[i]);
+
+    map<pair<unsigned int, unsigned int>, unsigned int> classOf;
+    catalog.duplicateClass.resize(n);
+    for (unsigned int i = 0; i < n; i++) {
+        catalog.duplicateClass[i] = classOf.emplace(make_pair(weights[i], values[i]), classOf.size()).first->second;
+    }
+    catalog.classes = classOf.size();
+}
+
+/**
+ * @brief Sidecar file of a dataset: the pallets file followed by ".catalog".
+ */
+string catalogPath(const string& palletsFile) {
+    return palletsFile + ".catalog";
+}
+
+/**
+ * @brief Hash of a catalog's arrays, in file order.
+ */
+static uint64_t payloadChecksum(const DatasetCatalog& catalog) {
+    uint64_t hash = xxHash64(catalog.ratioOrder.data(), catalog.ratioOrder.size() * sizeof(unsigned int), 0);
+    hash = xxHash64(catalog.duplicateClass.data(), catalog.duplicateClass.size() * sizeof(unsigned int), hash);
+    hash = xxHash64(catalog.prefixWeight.data(), catalog.prefixWeight.size() * sizeof(unsigned long long), hash);
+    return xxHash64(catalog.prefixProfit.data(), catalog.prefixProfit.size() * sizeof(unsigned long long), hash);
+}
+
+/**
+ * @brief Writes a catalog as a binary sidecar.
+ *
+ * @param filename Output file.
+ * @param catalog Catalog to write.
+ * @return True if the file was written.
+ */
+bool saveCatalog(const string& filename, const DatasetCatalog& catalog) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    CatalogHeader header = {};
+    copy_n("KCAT", 4, header.magic);
+    header.version = 1;
+    header.n = catalog.n;
+    header.capacity = catalog.capacity;
+    header.weightGcd = catalog.weightGcd;
+    header.classes = catalog.classes;
+    header.checksum = catalog.checksum;
+    header.payloadChecksum = payloadChecksum(catalog);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(catalog.ratioOrder.data()), catalog.ratioOrder.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(catalog.duplicateClass.data()), catalog.duplicateClass.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(catalog.prefixWeight.data()), catalog.prefixWeight.size() * sizeof(unsigned long long));
+    file.write(reinterpret_cast<const char*>(catalog.prefixProfit.data()), catalog.prefixProfit.size() * sizeof(unsigned long long));
+    return (bool) file;
+}
+
+/**
+ * @brief Reads a sidecar, accepting it only if it is intact and was built from this instance.
+ *
+ * Besides the checksums, the ratio order must be a permutation of the items in ratio order and
+ * every class below the class count; the prefix sums are recomputed from the order rather than
+ * trusted, so a self-consistent but wrong sidecar cannot mislead the solvers.
+ *
+ * @param filename Sidecar file.
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @param catalog Output catalog.
+ * @return True if the catalog is valid for the instance.
+ */
+bool loadCatalog(const string& filename, const unsigned int values[], const unsigned int weights[], unsigned int n,
+                 unsigned int maxWeight, DatasetCatalog& catalog) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    CatalogHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || string(header.magic, 4) != "KCAT" || header.version != 1 || header.n != n ||
+        header.capacity != maxWeight || header.checksum != instanceChecksum(values, weights, n, maxWeight)) {
+        return false;
+    }
+
+    catalog.n = n;
+    catalog.capacity = maxWeight;
+    catalog.checksum = header.checksum;
+    catalog.weightGcd = header.weightGcd;
+    catalog.classes = header.classes;
+    catalog.ratioOrder.resize(n);
+    catalog.duplicateClass.resize(n);
+    catalog.prefixWeight.resize(n + 1);
+    catalog.prefixProfit.resize(n + 1);
+    file.read(reinterpret_cast<char*>(catalog.ratioOrder.data()), n * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(catalog.duplicateClass.data()), n * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(catalog.prefixWeight.data()), (n + 1) * sizeof(unsigned long long));
+    file.read(reinterpret_cast<char*>(catalog.prefixProfit.data()), (n + 1) * sizeof(unsigned long long));
+    if (!file || payloadChecksum(catalog) != header.payloadChecksum) return false;
+    if (!isRatioOrder(values, weights, n, catalog.ratioOrder)) return false;
+    for (unsigned int c : catalog.duplicateClass) {
+        if (c >= catalog.classes) return false;
+    }
+    fillPrefixSums(values, weights, catalog);
+    return true;
+}
+
+/**
+ * @brief Whether a catalog describes exactly these columns and capacity.
+ *
+ * Checks the shape and checksum, that the ratio order is a permutation in ratio order and that
+ * the prefix sums follow it; O(n).
+ *
+ * @param catalog Catalog to check.
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @return True if the solvers may use the catalog for this instance.
+ */
+bool catalogMatches(const DatasetCatalog& catalog, const unsigned int values[], const unsigned int weights[],
+                    unsigned int n, unsigned int maxWeight) {
+    if (catalog.n != n || catalog.capacity != maxWeight || catalog.checksum != instanceChecksum(values, weights, n, maxWeight) ||
+        catalog.prefixWeight.size() != (size_t) n + 1 || catalog.prefixProfit.size() != (size_t) n + 1 ||
+        !isRatioOrder(values, weights, n, catalog.ratioOrder)) {
+        return false;
+    }
+    for (unsigned int k = 0; k < n; k++) {
+        if (catalog.prefixWeight[k + 1] != catalog.prefixWeight[k] + weights[catalog.ratioOrder[k]] ||
+            catalog.prefixProfit[k + 1] != catalog.prefixProfit[k] + values[catalog.ratioOrder[k]]) {
+            return false;
+        }
+    }
+    return catalog.prefixWeight[0] == 0 && catalog.prefixProfit[0] == 0;
+}
+
+/**
+ * @brief The thread's bound catalog and the columns it is bound to.
+ */
+struct CatalogBinding {
+    const DatasetCatalog* catalog = nullptr;
+    const unsigned int* values = nullptr;
+    const unsigned int* weights = nullptr;
+};
+
+static CatalogBinding& currentBinding() {
+    static thread_local CatalogBinding binding;
+    return binding;
+}
+
+CatalogScope::CatalogScope(const DatasetCatalog* catalog, const unsigned int values[], const unsigned int weights[]) {
+    CatalogBinding& binding = currentBinding();
+    previous = binding.catalog;
+    previousValues = binding.values;
+    previousWeights = binding.weights;
+    binding = {catalog, values, weights};
+}
+
+CatalogScope::~CatalogScope() {
+    currentBinding() = {previous, previousValues, previousWeights};
+}
+
+/**
+ * @brief The catalog bound to these columns on this thread, or nullptr.
+ */
+const DatasetCatalog* boundCatalog(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                                   unsigned int maxWeight) {
+    const CatalogBinding& binding = currentBinding();
+    if (binding.catalog == nullptr || binding.values != values || binding.weights != weights ||
+        binding.catalog->n != n || binding.catalog->capacity != maxWeight) {
+        return nullptr;
+    }
+    return binding.catalog;
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef DATASET_CATALOG_H
+#define DATASET_CATALOG_H
+
+/**
+ * @struct DatasetCatalog
+ * @brief Derived data of one instance that several solvers would otherwise recompute.
+ *
+ * Built once by knapsack_catalog and stored next to the dataset (see catalogPath()); the
+ * checksum ties it to the exact columns and capacity it was built from.
+ */
+struct DatasetCatalog {
+    unsigned int n = 0;                      ///< Number of items
+    unsigned int capacity = 0;               ///< Truck capacity
+    uint64_t checksum = 0;                   ///< instanceChecksum() of the columns it describes
+    vector<unsigned int> ratioOrder;         ///< All items by decreasing profit/weight ratio, ties by index
+    vector<unsigned long long> prefixWeight; ///< prefixWeight[k] = weight of ratioOrder[0..k); [n] is the total
+    vector<unsigned long long> prefixProfit; ///< prefixProfit[k] = profit of ratioOrder[0..k); [n] is the total
+    unsigned int weightGcd = 0;              ///< GCD of every weight and the capacity
+    vector<unsigned int> duplicateClass;     ///< Items with equal (weight, profit) share a class, numbered by first appearance
+    unsigned int classes = 0;                ///< Number of distinct (weight, profit) pairs
+};
+
+/**
+ * @brief Checksum of an instance (xxHash64 of capacity, n and both columns).
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @return The checksum.
+ */
+uint64_t instanceChecksum(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                          unsigned int maxWeight);
+
+/**
+ * @brief Computes the catalog of an instance.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @param catalog Output catalog.
+ */
+void buildCatalog(const unsigned int values[], const unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                  DatasetCatalog& catalog);
+
+/**
+ * @brief Sidecar file of a dataset: the pallets file followed by ".catalog".
+ */
+string catalogPath(const string& palletsFile);
+
+/**
+ * @brief Writes a catalog as a binary sidecar.
+ *
+ * @param filename Output file.
+ * @param catalog Catalog to write.
+ * @return True if the file was written.
+ */
+bool saveCatalog(const string& filename, const DatasetCatalog& catalog);
+
+/**
+ * @brief Reads a sidecar, accepting it only if it is intact and was built from this instance.
+ *
+ * @param filename Sidecar file.
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @param catalog Output catalog.
+ * @return True if the catalog is valid for the instance.
+ */
+bool loadCatalog(const string& filename, const unsigned int values[], const unsigned int weights[], unsigned int n,
+                 unsigned int maxWeight, DatasetCatalog& catalog);
+
+/**
+ * @brief Whether a catalog describes exactly these columns and capacity (shape, checksum, a
+ * valid ratio order and matching prefix sums).
+ *
+ * @param catalog Catalog to check.
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Truck capacity.
+ * @return True if the solvers may use the catalog for this instance.
+ */
+bool catalogMatches(const DatasetCatalog& catalog, const unsigned int values[], const unsigned int weights[],
+                    unsigned int n, unsigned int maxWeight);
+
+/**
+ * @class CatalogScope
+ * @brief Offers a catalog to the solvers called on this thread with exactly these columns.
+ *
+ * Solvers take plain arrays, so the catalog is bound to the arrays' addresses: a solver sees it
+ * (through boundCatalog()) only when it runs on those arrays with the catalog's n and capacity,
+ * never on a sub-instance. Scopes nest.
+ */
+class CatalogScope {
+public:
+    CatalogScope(const DatasetCatalog* catalog, const unsigned int values[], const unsigned int weights[]);
+    ~CatalogScope();
+    CatalogScope(const CatalogScope&) = delete;
+    CatalogScope& operator=(const CatalogScope&) = delete;
+
+private:
+    const DatasetCatalog* previous;
+    const unsigned int* previousValues;
+    const unsigned int* previousWeights;
+};
+
+/**
+ * @brief The catalog bound to these columns on this thread, or nullptr.
+ */
+const DatasetCatalog* boundCatalog(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                                   unsigned int maxWeight);
+
+#endif //DATASET_CATALOG_H
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "dataset_registry.h"
+#include "data_loader.h"
+
+using namespace std;
+
+/**
+ * @brief Size and modification time of a file (exists is false if it cannot be stat'ed).
+ */
+static FileStamp stampFile(const string& path) {
+    FileStamp stamp;
+    struct stat info;
+    if (path.empty() || stat(path.c_str(), &info) != 0) return stamp;
+    stamp.exists = true;
+    stamp.size = info.st_size;
+    stamp.modifiedNanos = (long long) info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+    return stamp;
+}
+
+/**
+ * @brief Parses a dataset and its sidecar catalog; a dataset holding only an error if the files
+ * cannot be loaded.
+ *
+ * A malformed file (e.g. a non-numeric cell) also yields an error rather than an exception, so
+ * that the failure is neither cached nor rethrown to every caller sharing the parse.
+ */
+static shared_ptr<const LoadedDataset> parseDataset(const string& palletsFile, const string& truckFile) {
+    shared_ptr<LoadedDataset> dataset = make_shared<LoadedDataset>();
+    try {
+        if (!load_instance(palletsFile, truckFile, dataset->pallets, dataset->truck, &dataset->error)) {
+            dataset->pallets.clear();
+            if (dataset->error.empty()) dataset->error = "Could not load " + palletsFile;
+            return dataset;
+        }
+
+        // A stale or damaged sidecar fails its checksum and is ignored
+        if (stampFile(catalogPath(palletsFile)).exists) {
+            unsigned int n = min<size_t>(dataset->truck.pallets, dataset->pallets.size());
+            vector<unsigned int> values(n), weights(n);
+            for (unsigned int i = 0; i < n; i++) {
+                values[i] = dataset->pallets[i].profit;
+                weights[i] = dataset->pallets[i].weight;
+            }
+            shared_ptr<DatasetCatalog> catalog = make_shared<DatasetCatalog>();
+            if (loadCatalog(catalogPath(palletsFile), values.data(), weights.data(), n, dataset->truck.capacity, *catalog)) {
+                dataset->catalog = catalog;
+            }
+        }
+        return dataset;
+    } catch (const exception& e) {
+        dataset->pallets.clear();
+        dataset->error = string("Malformed instance ") + palletsFile + " (" + e.what() + ")";
+        return dataset;
+    }
+}
+
+/**
+ * @brief Returns the parse of a dataset, starting one (inline or on a new thread) if no
+ * up-to-date parse is cached or in flight.
+ *
+ * Replaced and evicted parses are destroyed after the lock is released: the last reference to a
+ * background parse blocks until that parse finishes.
+ */
+shared_future<shared_ptr<const LoadedDataset>> DatasetRegistry::find(const string& palletsFile, const string& truckFile,
+                                                                     bool background, bool& started) {
+    string key = palletsFile + '\n' + truckFile;
+    FileStamp pallets = stampFile(palletsFile);
+    FileStamp truck = stampFile(truckFile);
+    FileStamp catalog = stampFile(catalogPath(palletsFile));
+    vector<shared_future<shared_ptr<const LoadedDataset>>> dropped;
+    lock_guard<mutex> guard(lock);
+    auto found = entries.find(key);
+    if (found != entries.end() && found->second.pallets == pallets && found->second.truck == truck &&
+        found->second.catalog == catalog) {
+        started = false;
+        found->second.lastUse = ++uses;
+        return found->second.load;
+    }
+    started = true;
+    if (found == entries.end()) {
+        // Drop the least recently used finished parses; parses in flight stay until they are done
+        while (entries.size() >= maxEntries) {
+            auto oldest = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.load.wait_for(chrono::seconds(0)) == future_status::timeout) continue;
+                if (oldest == entries.end() || it->second.lastUse < oldest->second.lastUse) oldest = it;
+            }
+            if (oldest == entries.end()) break;
+            dropped.push_back(move(oldest->second.load));
+            entries.erase(oldest);
+        }
+    }
+    Entry& entry = entries[key];
+    if (entry.load.valid()) dropped.push_back(move(entry.load));
+    entry.pallets = pallets;
+    entry.truck = truck;
+    entry.catalog = catalog;
+    entry.lastUse = ++uses;
+    entry.load = async(background ? launch::async : launch::deferred, parseDataset, palletsFile, truckFile).share();
+    return entry.load;
+}
+
+/**
+ * @brief Returns a dataset, parsing it unless an up-to-date parse is cached or in flight.
+ *
+ * @param palletsFile Pallets CSV or binary .knap instance.
+ * @param truckFile Truck CSV (ignored for .knap instances).
+ * @param cached Optional output: true if no parse was started by this call.
+ * @param loadMillis Optional output: time spent in this call, parsing or waiting.
+ * @param error Optional output: why the dataset could not be loaded.
+ * @return The dataset, or nullptr if it could not be loaded.
+ */
+shared_ptr<const LoadedDataset> DatasetRegistry::get(const string& palletsFile, const string& truckFile, bool* cached,
+                                                     double* loadMillis, string* error) {
+    auto start = chrono::steady_clock::now();
+    bool started;
+    shared_future<shared_ptr<const LoadedDataset>> load = find(palletsFile, truckFile, false, started);
+    // A deferred parse runs here, in the first caller to wait on it
+    shared_ptr<const LoadedDataset> dataset = load.get();
+    if (!dataset->error.empty()) {
+        if (error != nullptr) *error = dataset->error;
+        lock_guard<mutex> guard(lock);
+        auto found = entries.find(palletsFile + '\n' + truckFile);
+        if (found != entries.end() && found->second.load.valid() &&
+            found->second.load.wait_for(chrono::seconds(0)) == future_status::ready && !found->second.load.get()->error.empty()) {
+            entries.erase(found);
+        }
+        dataset = nullptr;
+    }
+    if (cached != nullptr) *cached = !started;
+    if (loadMillis != nullptr) *loadMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return dataset;
+}
+
+/**
+ * @brief Starts parsing a dataset on a background thread, unless it is cached or in flight.
+ *
+ * @param palletsFile Pallets CSV or binary .knap instance.
+ * @param truckFile Truck CSV (ignored for .knap instances).
+ */
+void DatasetRegistry::prefetch(const string& palletsFile, const string& truckFile) {
+    bool started;
+    find(palletsFile, truckFile, true, started);
+}
@@ -0,0 +1,101 @@
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dataset.h"
+#include "dataset_catalog.h"
+using namespace std;
+
+#ifndef DATASET_REGISTRY_H
+#define DATASET_REGISTRY_H
+
+/**
+ * @struct LoadedDataset
+ * @brief A parsed instance, shared read-only by everyone that uses it.
+ */
+struct LoadedDataset {
+    vector<Pallet> pallets;
+    Truck truck;
+    shared_ptr<const DatasetCatalog> catalog;  ///< Valid sidecar catalog (see catalogPath()), if any
+    string error;                              ///< Why the files could not be loaded (empty on success)
+};
+
+/**
+ * @struct FileStamp
+ * @brief What a cached parse was read from: a file's size and modification time.
+ */
+struct FileStamp {
+    bool exists = false;
+    long long size = 0;
+    long long modifiedNanos = 0;
+
+    bool operator==(const FileStamp& other) const {
+        return exists == other.exists && size == other.size && modifiedNanos == other.modifiedNanos;
+    }
+};
+
+/**
+ * @class DatasetRegistry
+ * @brief Parsed datasets keyed by their file paths, reparsed only when a file's size or
+ * modification time changes. A sidecar catalog next to the pallets file is loaded with the
+ * dataset when it matches it (and a new or rebuilt sidecar also triggers a reload).
+ *
+ * A load may run in the background (prefetch()); get() then waits for it instead of parsing
+ * again. Files that fail to load are not kept, so a request after fixing them succeeds. At most
+ * maxEntries parses are kept; the least recently used finished one is dropped to make room.
+ * Thread-safe.
+ */
+class DatasetRegistry {
+public:
+    /**
+     * @param maxEntries Most datasets kept in memory (parses in flight are never dropped).
+     */
+    explicit DatasetRegistry(size_t maxEntries = 64) : maxEntries(maxEntries) {}
+    DatasetRegistry(const DatasetRegistry&) = delete;
+    DatasetRegistry& operator=(const DatasetRegistry&) = delete;
+
+    /**
+     * @brief Returns a dataset, parsing it unless an up-to-date parse is cached or in flight.
+     *
+     * @param palletsFile Pallets CSV or binary .knap instance.
+     * @param truckFile Truck CSV (ignored for .knap instances).
+     * @param cached Optional output: true if no parse was started by this call.
+     * @param loadMillis Optional output: time spent in this call, parsing or waiting.
+     * @param error Optional output: why the dataset could not be loaded.
+     * @return The dataset, or nullptr if it could not be loaded.
+     */
+    shared_ptr<const LoadedDataset> get(const string& palletsFile, const string& truckFile, bool* cached = nullptr,
+                                        double* loadMillis = nullptr, string* error = nullptr);
+
+    /**
+     * @brief Starts parsing a dataset on a background thread, unless it is cached or in flight.
+     *
+     * @param palletsFile Pallets CSV or binary .knap instance.
+     * @param truckFile Truck CSV (ignored for .knap instances).
+     */
+    void prefetch(const string& palletsFile, const string& truckFile);
+
+private:
+    /**
+     * @brief A parse, finished or in flight, and the stamps of the files it reads.
+     */
+    struct Entry {
+        FileStamp pallets;
+        FileStamp truck;
+        FileStamp catalog;
+        shared_future<shared_ptr<const LoadedDataset>> load;
+        unsigned long long lastUse = 0;  ///< Value of uses when the entry was last returned
+    };
+
+    shared_future<shared_ptr<const LoadedDataset>> find(const string& palletsFile, const string& truckFile,
+                                                        bool background, bool& started);
+
+    size_t maxEntries;
+    unsigned long long uses = 0;
+    mutex lock;
+    map<string, Entry> entries;
+};
+
+#endif //DATASET_REGISTRY_H
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include "generator.h"
+
+using namespace std;
+
+/** Spanner instances: number of spanner items and largest multiplier. */
+static const unsigned int spannerItems = 2;
+static const unsigned int spannerMultiplier = 10;
+
+/** Profit-ceiling instances: profits are the weight rounded up to a multiple of this. */
+static const unsigned int ceilingStep = 3;
+
+/**
+ * @brief Names of the supported instance families (Pisinger's classic classes).
+ */
+const vector<string>& generatorFamilies() {
+    static const vector<string> families = {
+        "uncorrelated", "weakly-correlated", "strongly-correlated", "inverse-strongly-correlated",
+        "subset-sum", "spanner", "profit-ceiling",
+    };
+    return families;
+}
+
+/**
+ * @brief One step of splitmix64; consecutive calls give independent 64-bit values.
+ */
+static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Item of a basic (non-spanner) family, drawn from the given generator state.
+ */
+static void basicItem(const string& family, unsigned int range, uint64_t& state, unsigned int& weight, unsigned int& profit) {
+    unsigned int spread = max(1u, range / 10);
+    if (family == "inverse-strongly-correlated") {
+        profit = 1 + splitmix(state) % range;
+        weight = profit + spread;
+        return;
+    }
+    weight = 1 + splitmix(state) % range;
+    if (family == "uncorrelated") {
+        profit = 1 + splitmix(state) % range;
+    } else if (family == "weakly-correlated") {
+        long long p = (long long) weight - spread + (long long) (splitmix(state) % (2ULL * spread + 1));
+        profit = (unsigned int) max(1LL, p);
+    } else if (family == "subset-sum") {
+        profit = weight;
+    } else if (family == "profit-ceiling") {
+        profit = ceilingStep * ((weight + ceilingStep - 1) / ceilingStep);
+    } else {
+        profit = weight + spread;
+    }
+}
+
+/**
+ * @brief Checks the options: known family, 1 <= n <= 1e9, and coefficients that fit an int.
+ *
+ * The largest coefficient is about 1.1 R (2.2 R for spanner instances), which must stay below
+ * INT_MAX because pallets store ints.
+ *
+ * @param options Options to check.
+ * @param error Output describing the first problem.
+ * @return True if the options are valid.
+ */
+bool validGeneratorOptions(const GeneratorOptions& options, string& error) {
+    const vector<string>& families = generatorFamilies();
+    if (find(families.begin(), families.end(), options.family) == families.end()) {
+        error = "unknown family " + options.family;
+        return false;
+    }
+    if (options.n == 0 || options.n > 1000000000ULL) {
+        error = "n must be between 1 and 1e9";
+        return false;
+    }
+    if (options.range == 0 || options.range > 900000000U) {
+        error = "range must be between 1 and 9e8";
+        return false;
+    }
+    if (options.capacityRatio <= 0) {
+        error = "capacity ratio must be positive";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Generates item i.
+ *
+ * Every item is derived from its own splitmix64 stream seeded with (seed, i), so instances can be
+ * streamed (or regenerated) in any order without keeping them in memory. Spanner items multiply
+ * one of a few base items, strongly correlated and scaled down by 2/m, by a random a in [1, m].
+ *
+ * @param options Instance parameters.
+ * @param i Item index.
+ * @param weight Output weight.
+ * @param profit Output profit.
+ */
+void generateItem(const GeneratorOptions& options, unsigned long long i, unsigned int& weight, unsigned int& profit) {
+    uint64_t state = options.seed * 0xD1B54A32D192ED03ULL + i;
+    splitmix(state);
+    if (options.family != "spanner") {
+        basicItem(options.family, options.range, state, weight, profit);
+        return;
+    }
+    unsigned int k = splitmix(state) % spannerItems;
+    unsigned int a = 1 + splitmix(state) % spannerMultiplier;
+    uint64_t spannerState = options.seed * 0xD1B54A32D192ED03ULL + UINT64_MAX - k;
+    splitmix(spannerState);
+    unsigned int w, p;
+    basicItem("strongly-correlated", options.range, spannerState, w, p);
+    weight = a * ((2 * w + spannerMultiplier - 1) / spannerMultiplier);
+    profit = a * ((2 * p + spannerMultiplier - 1) / spannerMultiplier);
+}
+
+/**
+ * @brief Capacity for a total weight: the configured fraction, at least 1, at most INT_MAX.
+ */
+static unsigned int capacityFor(const GeneratorOptions& options, unsigned long long totalWeight) {
+    double capacity = options.capacityRatio * (double) totalWeight;
+    return (unsigned int) max(1.0, min(capacity, (double) INT_MAX));
+}
+
+/**
+ * @brief Generates a whole instance in memory.
+ *
+ * @return The capacity.
+ */
+unsigned int generateInstance(const GeneratorOptions& options, vector<unsigned int>& weights, vector<unsigned int>& profits) {
+    weights.resize(options.n);
+    profits.resize(options.n);
+    unsigned long long total = 0;
+    for (unsigned long long i = 0; i < options.n; i++) {
+        generateItem(options, i, weights[i], profits[i]);
+        total += weights[i];
+    }
+    return capacityFor(options, total);
+}
+
+/**
+ * @brief Streams an instance to a Pallets CSV file and its TruckAndPallets CSV file.
+ *
+ * Lines are formatted into a 1 MiB buffer with to_chars, so only the buffer is ever in memory.
+ *
+ * @return True on success.
+ */
+bool writeInstanceCSV(const GeneratorOptions& options, const string& palletsFile, const string& truckFile) {
+    ofstream pallets(palletsFile, ios::binary);
+    if (!pallets.is_open()) return false;
+    pallets << "Pallet,Weight,Profit\n";
+
+    vector<char> buffer(1 << 20);
+    size_t used = 0;
+    unsigned long long total = 0;
+    for (unsigned long long i = 0; i < options.n; i++) {
+        if (buffer.size() - used < 64) {
+            pallets.write(buffer.data(), used);
+            used = 0;
+        }
+        unsigned int weight, profit;
+        generateItem(options, i, weight, profit);
+        total += weight;
+        char* p = buffer.data() + used;
+        char* end = buffer.data() + buffer.size();
+        p = to_chars(p, end, i + 1).ptr;
+        *p++ = ',';
+        p = to_chars(p, end, weight).ptr;
+        *p++ = ',';
+        p = to_chars(p, end, profit).ptr;
+        *p++ = '\n';
+        used = p - buffer.data();
+    }
+    pallets.write(buffer.data(), used);
+    if (!pallets) return false;
+
+    ofstream truck(truckFile);
+    if (!truck.is_open()) return false;
+    truck << "Capacity,Pallets\n" << capacityFor(options, total) << "," << options.n << "\n";
+    return (bool) truck;
+}
+
+/**
+ * @brief Streams an instance to the binary format read by load_data_binary().
+ *
+ * Weights are written in a first pass (which also sums them), profits in a second pass that
+ * regenerates the items, and the capacity is patched into the header at the end.
+ *
+ * @return True on success.
+ */
+bool writeInstanceBinary(const GeneratorOptions& options, const string& filename) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    uint32_t version = 1;
+    uint64_t n = options.n;
+    uint32_t capacity = 0;
+    file.write("KNAP", 4);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    streampos capacityOffset = file.tellp();
+    file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+
+    vector<uint32_t> chunk(1 << 16);
+    unsigned long long total = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (unsigned long long first = 0; first < n; first += chunk.size()) {
+            size_t count = min<unsigned long long>(chunk.size(), n - first);
+            for (size_t k = 0; k < count; k++) {
+                unsigned int weight, profit;
+                generateItem(options, first + k, weight, profit);
+                chunk[k] = pass == 0 ? weight : profit;
+                if (pass == 0) total += weight;
+            }
+            file.write(reinterpret_cast<const char*>(chunk.data()), count * sizeof(uint32_t));
+        }
+    }
+
+    capacity = capacityFor(options, total);
+    file.seekp(capacityOffset);
+    file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+    return (bool) file;
+}
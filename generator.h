@@ -0,0 +1,71 @@
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+/**
+ * @struct GeneratorOptions
+ * @brief Parameters of a synthetic instance.
+ */
+struct GeneratorOptions {
+    string family = "uncorrelated"; ///< One of generatorFamilies()
+    unsigned long long n = 1000;     ///< Number of items
+    unsigned int range = 1000;       ///< Coefficient range R: weights (or profits) are drawn from [1, R]
+    unsigned long long seed = 1;     ///< Seed; item i only depends on (seed, i)
+    double capacityRatio = 0.5;      ///< Capacity as a fraction of the total weight (capped at INT_MAX)
+};
+
+/**
+ * @brief Names of the supported instance families (Pisinger's classic classes).
+ * 
+ * uncorrelated, weakly-correlated, strongly-correlated, inverse-strongly-correlated, subset-sum,
+ * spanner and profit-ceiling.
+ */
+const vector<string>& generatorFamilies();
+
+/**
+ * @brief Checks the options: known family, 1 <= n <= 1e9, and coefficients that fit an int.
+ * 
+ * @param options Options to check.
+ * @param error Output describing the first problem.
+ * @return True if the options are valid.
+ */
+bool validGeneratorOptions(const GeneratorOptions& options, string& error);
+
+/**
+ * @brief Generates item i.
+ * 
+ * @param options Instance parameters.
+ * @param i Item index.
+ * @param weight Output weight.
+ * @param profit Output profit.
+ */
+void generateItem(const GeneratorOptions& options, unsigned long long i, unsigned int& weight, unsigned int& profit);
+
+/**
+ * @brief Generates a whole instance in memory.
+ * 
+ * @return The capacity.
+ */
+unsigned int generateInstance(const GeneratorOptions& options, vector<unsigned int>& weights, vector<unsigned int>& profits);
+
+/**
+ * @brief Streams an instance to a Pallets CSV file and its TruckAndPallets CSV file.
+ * 
+ * @return True on success.
+ */
+bool writeInstanceCSV(const GeneratorOptions& options, const string& palletsFile, const string& truckFile);
+
+/**
+ * @brief Streams an instance to the binary format read by load_data_binary().
+ * 
+ * Layout (native little-endian): "KNAP", uint32 version = 1, uint64 n, uint32 capacity,
+ * uint32 weights[n], uint32 profits[n].
+ * 
+ * @return True on success.
+ */
+bool writeInstanceBinary(const GeneratorOptions& options, const string& filename);
+
+#endif //GENERATOR_H
@@ -0,0 +1,83 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "arguments.h"
+#include "generator.h"
+#include "shared_instance.h"
+
+using namespace std;
+
+/**
+ * @brief Entry point of knapsack_gen.
+ *
+ * Usage: knapsack_gen [--family NAME] [--n N] [--range R] [--seed S] [--capacity-ratio F]
+ * [--format csv|binary|shm] [--output PATH] [--id ID]
+ *
+ * CSV instances are written as PATH/Pallets_<ID>.csv and PATH/TruckAndPallets_<ID>.csv (PATH is a
+ * directory, default "."), so batch runs and the benchmark pick them up; binary instances are
+ * written to the file PATH (default instance.knap); shm instances are placed in the POSIX shared
+ * memory segment PATH (default /knapsack-<ID>) for the solver daemon.
+ */
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    string format = "csv";
+    string output;
+    string id = "gen";
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        bool valid = true;
+        if (option == "--family") options.family = value;
+        else if (option == "--n") valid = parseCount(value, UINT64_MAX, options.n);
+        else if (option == "--range") valid = parseCount(value, options.range);
+        else if (option == "--seed") valid = parseCount(value, UINT64_MAX, options.seed);
+        else if (option == "--capacity-ratio") valid = parseNonNegative(value, options.capacityRatio);
+        else if (option == "--format") format = value;
+        else if (option == "--output") output = value;
+        else if (option == "--id") id = value;
+        else {
+            cerr << "Unknown option: " << option << endl;
+            return 2;
+        }
+        if (!valid) {
+            cerr << "Invalid value for " << option << ": " << value << endl;
+            return 2;
+        }
+    }
+
+    if (format != "csv" && format != "binary" && format != "shm") {
+        cerr << "Invalid value for --format: " << format << endl;
+        return 2;
+    }
+    string error;
+    if (!validGeneratorOptions(options, error)) {
+        cerr << error << endl;
+        return 2;
+    }
+    bool ok;
+    if (format == "binary") {
+        ok = writeInstanceBinary(options, output.empty() ? "instance.knap" : output);
+    } else if (format == "shm") {
+        vector<unsigned int> weights, profits;
+        unsigned int capacity = generateInstance(options, weights, profits);
+        ok = createSharedInstance(output.empty() ? "/knapsack-" + id : output, weights.data(), profits.data(),
+                                  weights.size(), capacity, &error);
+        if (!ok) {
+            cerr << error << endl;
+            return 1;
+        }
+    } else {
+        filesystem::path directory(output.empty() ? "." : output);
+        ok = writeInstanceCSV(options, (directory / ("Pallets_" + id + ".csv")).string(),
+                              (directory / ("TruckAndPallets_" + id + ".csv")).string());
+    }
+    if (!ok) {
+        cerr << "Error opening file!" << endl;
+        return 1;
+    }
+    return 0;
+}
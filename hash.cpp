@@ -0,0 +1,72 @@
+#include <cstring>
+#include "hash.h"
+
+using namespace std;
+
+static const uint64_t PRIME1 = 11400714785074694791ULL;
+static const uint64_t PRIME2 = 14029467366897019727ULL;
+static const uint64_t PRIME3 = 1609587929392839161ULL;
+static const uint64_t PRIME4 = 9650029242287828579ULL;
+static const uint64_t PRIME5 = 2870177450012600261ULL;
+
+static uint64_t rotl(uint64_t x, int bits) { return (x << bits) | (x >> (64 - bits)); }
+
+static uint64_t read64(const char* p) {
+    uint64_t value;
+    memcpy(&value, p, 8);
+    return value;
+}
+
+static uint32_t read32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return value;
+}
+
+static uint64_t xxRound(uint64_t acc, uint64_t input) { return rotl(acc + input * PRIME2, 31) * PRIME1; }
+
+static uint64_t xxMerge(uint64_t acc, uint64_t value) { return (acc ^ xxRound(0, value)) * PRIME1 + PRIME4; }
+
+/**
+ * @brief xxHash64 of a byte range (the reference algorithm; values match other implementations
+ * on little-endian hosts).
+ *
+ * @param data First byte.
+ * @param length Number of bytes.
+ * @param seed Seed; different seeds give independent hashes.
+ * @return The 64-bit hash.
+ */
+uint64_t xxHash64(const void* data, size_t length, uint64_t seed) {
+    const char* p = static_cast<const char*>(data);
+    const char* end = p + length;
+    uint64_t h;
+    if (length >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2, v2 = seed + PRIME2, v3 = seed, v4 = seed - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = xxRound(v1, read64(p));
+            v2 = xxRound(v2, read64(p + 8));
+            v3 = xxRound(v3, read64(p + 16));
+            v4 = xxRound(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = xxMerge(h, v1);
+        h = xxMerge(h, v2);
+        h = xxMerge(h, v3);
+        h = xxMerge(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+    h += length;
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ xxRound(0, read64(p)), 27) * PRIME1 + PRIME4;
+    if (p + 4 <= end) {
+        h = rotl(h ^ (uint64_t) read32(p) * PRIME1, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) h = rotl(h ^ (uint64_t) (unsigned char) *p * PRIME5, 11) * PRIME1;
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
@@ -0,0 +1,19 @@
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+#ifndef HASH_H
+#define HASH_H
+
+/**
+ * @brief xxHash64 of a byte range (the reference algorithm; values match other implementations
+ * on little-endian hosts).
+ *
+ * @param data First byte.
+ * @param length Number of bytes.
+ * @param seed Seed; different seeds give independent hashes.
+ * @return The 64-bit hash.
+ */
+uint64_t xxHash64(const void* data, size_t length, uint64_t seed = 0);
+
+#endif //HASH_H
@@ -0,0 +1,240 @@
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include "json.h"
+
+using namespace std;
+
+/**
+ * @class JsonParser
+ * @brief Recursive-descent parser over one document.
+ */
+class JsonParser {
+public:
+    explicit JsonParser(const string& text) : text(text) {}
+
+    bool parseDocument(JsonValue& value) {
+        skipSpace();
+        if (!parseValue(value, 0)) return false;
+        skipSpace();
+        if (pos != text.size()) return fail("trailing characters");
+        return true;
+    }
+
+    string error;
+
+private:
+    const string& text;
+    size_t pos = 0;
+
+    bool fail(const string& message) {
+        if (error.empty()) error = message + " at offset " + to_string(pos);
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) pos++;
+    }
+
+    bool literal(const char* word) {
+        size_t length = char_traits<char>::length(word);
+        if (text.compare(pos, length, word) != 0) return fail("invalid literal");
+        pos += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        if (depth > 64) return fail("nesting too deep");
+        if (pos >= text.size()) return fail("unexpected end");
+        char c = text[pos];
+        if (c == '{') return parseObject(value, depth);
+        if (c == '[') return parseArray(value, depth);
+        if (c == '"') {
+            value.kind = JsonValue::String;
+            return parseString(value.text);
+        }
+        if (c == 't' || c == 'f') {
+            value.kind = JsonValue::Boolean;
+            value.boolean = c == 't';
+            return literal(c == 't' ? "true" : "false");
+        }
+        if (c == 'n') {
+            value.kind = JsonValue::Null;
+            return literal("null");
+        }
+        return parseNumber(value);
+    }
+
+    /**
+     * @brief Skips a run of digits; false if there is none.
+     */
+    bool digits() {
+        size_t start = pos;
+        while (pos < text.size() && isdigit((unsigned char) text[pos])) pos++;
+        return pos > start;
+    }
+
+    /**
+     * @brief Parses a number in JSON's grammar (strtod alone also takes "inf", "0x1F" and "01").
+     */
+    bool parseNumber(JsonValue& value) {
+        size_t start = pos;
+        if (pos < text.size() && text[pos] == '-') pos++;
+        if (pos < text.size() && text[pos] == '0') {
+            pos++;
+        } else if (pos >= text.size() || text[pos] < '1' || text[pos] > '9' || !digits()) {
+            pos = start;
+            return fail("invalid value");
+        }
+        if (pos < text.size() && text[pos] == '.') {
+            pos++;
+            if (!digits()) return fail("invalid number");
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            pos++;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+            if (!digits()) return fail("invalid number");
+        }
+        value.kind = JsonValue::Number;
+        value.number = strtod(text.substr(start, pos - start).c_str(), nullptr);
+        return true;
+    }
+
+    bool parseString(string& out) {
+        pos++;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) break;
+            char e = text[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case '"': case '\\': case '/': out += e; break;
+                case 'u': {
+                    if (pos + 4 > text.size()) return fail("truncated escape");
+                    string hex = text.substr(pos, 4);
+                    if (hex.find_first_not_of("0123456789abcdefABCDEF") != string::npos) return fail("invalid escape");
+                    unsigned long code = strtoul(hex.c_str(), nullptr, 16);
+                    out += code < 0x80 ? (char) code : '?';
+                    pos += 4;
+                    break;
+                }
+                default: return fail("invalid escape");
+            }
+        }
+        if (pos >= text.size()) return fail("unterminated string");
+        pos++;
+        return true;
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        value.kind = JsonValue::Array;
+        pos++;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ']') {
+            pos++;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            value.elements.emplace_back();
+            if (!parseValue(value.elements.back(), depth + 1)) return false;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return true;
+            } else {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        value.kind = JsonValue::Object;
+        pos++;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') {
+            pos++;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            if (pos >= text.size() || text[pos] != '"') return fail("expected key");
+            string key;
+            if (!parseString(key)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') return fail("expected ':'");
+            pos++;
+            skipSpace();
+            if (!parseValue(value.fields[key], depth + 1)) return false;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                return true;
+            } else {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+};
+
+/**
+ * @brief Parses a complete JSON document.
+ *
+ * @param text Document text.
+ * @param value Output value.
+ * @param error Optional output describing the first syntax error.
+ * @return True if the whole text is one valid value.
+ */
+bool JsonValue::parse(const string& text, JsonValue& value, string* error) {
+    JsonParser parser(text);
+    value = JsonValue();
+    bool ok = parser.parseDocument(value);
+    if (!ok && error != nullptr) *error = parser.error;
+    return ok;
+}
+
+/**
+ * @brief Member of an object, or a null value if it is missing (or this is not an object).
+ */
+const JsonValue& JsonValue::operator[](const string& key) const {
+    static const JsonValue missing;
+    auto it = fields.find(key);
+    return it == fields.end() ? missing : it->second;
+}
+
+/**
+ * @brief Quotes and escapes a string for inclusion in a JSON document.
+ */
+string jsonQuote(const string& text) {
+    string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
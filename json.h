@@ -0,0 +1,68 @@
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef JSON_H
+#define JSON_H
+
+/**
+ * @class JsonValue
+ * @brief A parsed JSON value: null, boolean, number, string, array or object.
+ *
+ * Just enough JSON for the tools' own files and protocols: numbers are doubles, objects keep
+ * their keys sorted, and \\u escapes outside ASCII are not decoded.
+ */
+class JsonValue {
+public:
+    enum Type { Null, Boolean, Number, String, Array, Object };
+
+    /**
+     * @brief Parses a complete JSON document.
+     * 
+     * @param text Document text.
+     * @param value Output value.
+     * @param error Optional output describing the first syntax error.
+     * @return True if the whole text is one valid value.
+     */
+    static bool parse(const string& text, JsonValue& value, string* error = nullptr);
+
+    Type type() const { return kind; }
+    bool isNull() const { return kind == Null; }
+    bool isNumber() const { return kind == Number; }
+    bool isString() const { return kind == String; }
+    bool isArray() const { return kind == Array; }
+    bool isObject() const { return kind == Object; }
+
+    bool asBool(bool fallback = false) const { return kind == Boolean ? boolean : fallback; }
+    double asNumber(double fallback = 0) const { return kind == Number ? number : fallback; }
+    const string& asString() const { return text; }
+    const vector<JsonValue>& items() const { return elements; }
+    const map<string, JsonValue>& members() const { return fields; }
+
+    /**
+     * @brief Member of an object, or a null value if it is missing (or this is not an object).
+     */
+    const JsonValue& operator[](const string& key) const;
+
+    /**
+     * @brief Whether an object has the member.
+     */
+    bool has(const string& key) const { return fields.count(key) != 0; }
+
+private:
+    friend class JsonParser;
+    Type kind = Null;
+    bool boolean = false;
+    double number = 0;
+    string text;
+    vector<JsonValue> elements;
+    map<string, JsonValue> fields;
+};
+
+/**
+ * @brief Quotes and escapes a string for inclusion in a JSON document.
+ */
+string jsonQuote(const string& text);
+
+#endif //JSON_H
@@ -0,0 +1,78 @@
+#include "algorithms.h"
+#include "knapsack.h"
+#include "local_search.h"
+#include "metaheuristics.h"
+
+using namespace std;
+
+/**
+ * @brief The solver registered under a name (see knapsackSolvers()), or nullptr.
+ */
+unique_ptr<Solver> Solver::create(const string& name) {
+    const SolverInfo* info = findSolver(name);
+    if (info == nullptr) return nullptr;
+    return unique_ptr<Solver>(new Solver(*info));
+}
+
+/**
+ * @brief Solves an instance.
+ *
+ * @param instance Instance to solve.
+ * @param options Threads, time limit and cancellation token.
+ * @param solution Output solution.
+ * @return Work counters and phase timings of this solve.
+ */
+SolverStats Solver::solve(const KnapsackInstance& instance, const KnapsackOptions& options, KnapsackSolution& solution) const {
+    SolverStats stats;
+    SolverStatsScope scope(&stats);
+    // A catalog that does not describe these columns would mislead ILP and FPTAS; it is ignored
+    const DatasetCatalog* matching = nullptr;
+    if (instance.catalog != nullptr &&
+        catalogMatches(*instance.catalog, instance.profits, instance.weights, instance.n, instance.capacity)) {
+        matching = instance.catalog;
+    }
+    CatalogScope catalog(matching, instance.profits, instance.weights);
+
+    // The solvers take mutable arrays but never write their inputs
+    unsigned int* values = const_cast<unsigned int*>(instance.profits);
+    unsigned int* weights = const_cast<unsigned int*>(instance.weights);
+    unsigned int n = instance.n;
+    unsigned int maxWeight = instance.capacity;
+    solution.selected.assign(n, 0);
+    bool* usedItems = reinterpret_cast<bool*>(solution.selected.data());
+    solution.status = info->exact ? SolveStatus::Optimal : SolveStatus::Feasible;
+
+    // An empty instance is trivially solved, and several solvers index the first item
+    if (n == 0) {
+        solution.profit = 0;
+        solution.weight = 0;
+        solution.status = SolveStatus::Optimal;
+        return stats;
+    }
+
+    // Exact solvers and FPTAS stop at the deadline; the heuristics take the limit as their budget
+    CancellationToken deadline(options.timeLimit, options.cancel);
+    const string& name = info->name;
+    if (name == "ga" || name == "sa") {
+        MetaheuristicOptions meta;
+        meta.timeLimit = options.timeLimit > 0 ? options.timeLimit : 1.0;
+        meta.threads = options.threads;
+        meta.cancel = options.cancel;
+        solution.profit = name == "ga" ? knapsackGenetic(values, weights, n, maxWeight, usedItems, meta)
+                                       : knapsackAnnealing(values, weights, n, maxWeight, usedItems, meta);
+        if (options.cancel != nullptr && options.cancel->isCancelled()) solution.status = SolveStatus::Cancelled;
+    } else if (name == "greedy-ls") {
+        knapsackGreedy(values, weights, n, maxWeight, usedItems);
+        solution.profit = localSearch(values, weights, n, maxWeight, usedItems,
+                                      options.timeLimit > 0 ? options.timeLimit : 0.05, options.threads, options.cancel);
+        if (options.cancel != nullptr && options.cancel->isCancelled()) solution.status = SolveStatus::Cancelled;
+    } else {
+        solution.profit = info->solveCancellable(values, weights, n, maxWeight, usedItems, &deadline, &solution.status);
+    }
+
+    solution.weight = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (usedItems[i]) solution.weight += weights[i];
+    }
+    return stats;
+}
@@ -0,0 +1,103 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "cancellation.h"
+#include "dataset_catalog.h"
+#include "solver_stats.h"
+#include "solvers.h"
+using namespace std;
+
+#ifndef KNAPSACK_H
+#define KNAPSACK_H
+
+/**
+ * Embedding API of the knapsack library: instances and solutions live in memory and nothing is
+ * read from or written to the console, so services can call the solvers directly.
+ */
+
+/**
+ * @struct KnapsackInstance
+ * @brief A single-truck instance. The columns are borrowed, not copied, so the caller keeps them
+ * alive (and unchanged) during the solve; solvers only read them.
+ */
+struct KnapsackInstance {
+    const unsigned int* weights = nullptr;  ///< Item weights
+    const unsigned int* profits = nullptr;  ///< Item profits
+    unsigned int n = 0;                     ///< Number of items
+    unsigned int capacity = 0;              ///< Truck capacity
+    const DatasetCatalog* catalog = nullptr; ///< Optional precomputed indexes of these columns (ignored unless catalogMatches())
+
+    KnapsackInstance() = default;
+    KnapsackInstance(const unsigned int* weights, const unsigned int* profits, unsigned int n, unsigned int capacity)
+        : weights(weights), profits(profits), n(n), capacity(capacity) {}
+    KnapsackInstance(const vector<unsigned int>& weights, const vector<unsigned int>& profits, unsigned int capacity)
+        : weights(weights.data()), profits(profits.data()), n(weights.size()), capacity(capacity) {}
+};
+
+/**
+ * @struct KnapsackOptions
+ * @brief Settings of a solve, honoured by the solvers that support them.
+ */
+struct KnapsackOptions {
+    unsigned int threads = 1;  ///< Threads for local search and the metaheuristics (0 = one per hardware thread)
+    double timeLimit = 0;      ///< Wall-clock budget in seconds (0 = each solver's default)
+    const CancellationToken* cancel = nullptr;  ///< Optional token through which the caller stops the solve
+};
+
+/**
+ * @struct KnapsackSolution
+ * @brief Chosen items and how the solve ended.
+ */
+struct KnapsackSolution {
+    vector<char> selected;                       ///< selected[i] != 0 if item i is loaded
+    unsigned int profit = 0;                     ///< Total profit of the chosen items
+    unsigned long long weight = 0;               ///< Total weight of the chosen items
+    SolveStatus status = SolveStatus::Feasible;  ///< Optimal, feasible, or cancelled (best-known solution)
+};
+
+/**
+ * @class Solver
+ * @brief One solver of the registry behind a common solve call.
+ *
+ * The time limit is a deadline for the exact solvers and FPTAS: they poll it (per DP row, every
+ * few hundred nodes or thousand subsets) and, once it passes or the caller's token is cancelled,
+ * return their best-known feasible solution with status Cancelled. Local search and the
+ * metaheuristics take the limit as their budget and end Feasible, unless the token stops them.
+ */
+class Solver {
+public:
+    explicit Solver(const SolverInfo& info) : info(&info) {}
+
+    /**
+     * @brief The solver registered under a name (see knapsackSolvers()), or nullptr.
+     */
+    static unique_ptr<Solver> create(const string& name);
+
+    const string& name() const { return info->name; }
+    bool exact() const { return info->exact; }
+
+    /**
+     * @brief Whether the solver can handle an instance (its size and memory); solve() does not check.
+     */
+    bool fits(const KnapsackInstance& instance) const {
+        return info->fits(instance.profits, instance.weights, instance.n, instance.capacity);
+    }
+
+    /**
+     * @brief Solves an instance.
+     *
+     * Thread-safe: concurrent calls may share a Solver. An empty instance (n = 0) is answered
+     * with profit 0, Optimal, without running the solver.
+     *
+     * @param instance Instance to solve.
+     * @param options Threads and time limit.
+     * @param solution Output solution.
+     * @return Work counters and phase timings of this solve.
+     */
+    SolverStats solve(const KnapsackInstance& instance, const KnapsackOptions& options, KnapsackSolution& solution) const;
+
+private:
+    const SolverInfo* info;
+};
+
+#endif //KNAPSACK_H
@@ -0,0 +1,199 @@
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "local_search.h"
+#include "solver_stats.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @struct Move
+ * @brief A candidate local-search move: items in `out` leave the solution, items in `in` enter it.
+ *
+ * Unused slots hold UINT32_MAX. The gain is the (positive) profit delta of the move.
+ */
+struct Move {
+    long long gain = 0;
+    unsigned int out[2] = {UINT32_MAX, UINT32_MAX};
+    unsigned int in[2] = {UINT32_MAX, UINT32_MAX};
+};
+
+/**
+ * @brief Index over the items outside the solution answering "most profitable item with
+ * weight <= cap", optionally excluding one item.
+ *
+ * Items are sorted by weight with a running maximum of value; the runner-up is kept as well so
+ * that a single excluded item can be skipped without a second search.
+ */
+struct OutsideIndex {
+    vector<unsigned int> weight;   ///< Sorted weights of the outside items
+    vector<unsigned int> best;     ///< best[k]: most profitable item among the first k+1
+    vector<unsigned int> second;   ///< second[k]: runner-up among the first k+1 (UINT32_MAX if none)
+
+    void build(unsigned int values[], unsigned int weights[], const vector<unsigned int>& items) {
+        vector<unsigned int> sorted = items;
+        sort(sorted.begin(), sorted.end(), [&](unsigned int a, unsigned int b) { return weights[a] < weights[b]; });
+        weight.resize(sorted.size());
+        best.resize(sorted.size());
+        second.resize(sorted.size());
+        unsigned int b1 = UINT32_MAX, b2 = UINT32_MAX;
+        for (size_t k = 0; k < sorted.size(); k++) {
+            unsigned int item = sorted[k];
+            if (b1 == UINT32_MAX || values[item] > values[b1]) {
+                b2 = b1;
+                b1 = item;
+            } else if (b2 == UINT32_MAX || values[item] > values[b2]) {
+                b2 = item;
+            }
+            weight[k] = weights[item];
+            best[k] = b1;
+            second[k] = b2;
+        }
+    }
+
+    unsigned int query(unsigned long long cap, unsigned int exclude = UINT32_MAX) const {
+        size_t k = upper_bound(weight.begin(), weight.end(), cap) - weight.begin();
+        if (k == 0) return UINT32_MAX;
+        return best[k - 1] != exclude ? best[k - 1] : second[k - 1];
+    }
+};
+
+/**
+ * @brief Improves a feasible knapsack solution with add, 1-swap and 2-swap moves.
+ *
+ * Every round rebuilds an index over the items outside the solution, then the worker threads
+ * split the items inside the solution between them and evaluate, using incremental weight and
+ * profit deltas:
+ *  - add: insert an outside item that fits in the slack;
+ *  - 1-swap (add/drop): replace inside item i by an outside item j;
+ *  - 2-swap: replace i by two outside items j, k, or replace two inside items i, k by j.
+ * The best improving move found by any thread is applied. The search stops at a local optimum,
+ * when the time budget is spent, after maxMoves moves or when the token is cancelled (polled
+ * with the deadline); the solution stays feasible throughout. Ties between moves go to the
+ * lowest thread and the first move found, so a run bounded only by moves is reproducible.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Input/output array marking which items are used; must be feasible.
+ * @param timeLimit Time budget in seconds (0 = no limit).
+ * @param threads Number of worker threads (0 = one per hardware thread).
+ * @param cancel Optional cancellation token.
+ * @param maxMoves Maximum number of improving moves to apply (0 = no limit).
+ * @return Total value of the improved solution.
+ */
+unsigned int localSearch(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                         bool usedItems[], double timeLimit, unsigned int threads, const CancellationToken* cancel,
+                         unsigned long long maxMoves) {
+    auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double>(timeLimit));
+    auto expired = [&]() {
+        return (timeLimit > 0 && chrono::steady_clock::now() >= deadline) || (cancel != nullptr && cancel->isCancelled());
+    };
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    unsigned long long totalWeight = 0;
+    unsigned long long totalValue = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (usedItems[i]) {
+            totalWeight += weights[i];
+            totalValue += values[i];
+        }
+    }
+    if (totalWeight > maxWeight) return totalValue;
+
+    vector<unsigned int> inside, outside;
+    OutsideIndex index;
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Solve);
+
+    for (unsigned long long moves = 0; (maxMoves == 0 || moves < maxMoves) && !expired(); moves++) {
+        inside.clear();
+        outside.clear();
+        for (unsigned int i = 0; i < n; i++) {
+            if (usedItems[i]) inside.push_back(i);
+            else if (weights[i] <= maxWeight) outside.push_back(i);
+        }
+        if (outside.empty()) break;
+        index.build(values, weights, outside);
+        unsigned long long slack = maxWeight - totalWeight;
+        unsigned int active = (unsigned int) max<size_t>(1, min<size_t>(threads, inside.size()));
+
+        // Evaluate the moves of one share of the inside items
+        auto evaluate = [&](unsigned int first, Move& bestMove) {
+            TraceScope trace("evaluate moves", "local search", "first", first);
+            auto consider = [&](long long gain, unsigned int o1, unsigned int o2, unsigned int i1, unsigned int i2) {
+                if (gain > bestMove.gain) {
+                    bestMove.gain = gain;
+                    bestMove.out[0] = o1; bestMove.out[1] = o2;
+                    bestMove.in[0] = i1; bestMove.in[1] = i2;
+                }
+            };
+
+            if (first == 0) {
+                unsigned int j = index.query(slack);
+                if (j != UINT32_MAX) consider(values[j], UINT32_MAX, UINT32_MAX, j, UINT32_MAX);
+            }
+
+            for (size_t a = first; a < inside.size(); a += active) {
+                if (expired()) return;
+                unsigned int i = inside[a];
+                unsigned long long room = slack + weights[i];
+
+                // 1-swap
+                unsigned int j = index.query(room);
+                if (j != UINT32_MAX) consider((long long) values[j] - values[i], i, UINT32_MAX, j, UINT32_MAX);
+
+                // 2-swap: i out, j and k in
+                for (unsigned int j2 : outside) {
+                    if (weights[j2] > room) continue;
+                    unsigned int k = index.query(room - weights[j2], j2);
+                    if (k == UINT32_MAX) continue;
+                    consider((long long) values[j2] + values[k] - values[i], i, UINT32_MAX, j2, k);
+                }
+
+                // 2-swap: i and k out, j in
+                for (size_t b = a + 1; b < inside.size(); b++) {
+                    unsigned int k = inside[b];
+                    unsigned int j3 = index.query(room + weights[k]);
+                    if (j3 == UINT32_MAX) continue;
+                    consider((long long) values[j3] - values[i] - values[k], i, k, j3, UINT32_MAX);
+                }
+            }
+        };
+
+        vector<Move> bestMoves(active);
+        vector<thread> workers;
+        for (unsigned int t = 1; t < active; t++) {
+            workers.emplace_back(evaluate, t, ref(bestMoves[t]));
+        }
+        evaluate(0, bestMoves[0]);
+        for (thread& worker : workers) worker.join();
+
+        Move bestMove;
+        for (const Move& move : bestMoves) {
+            if (move.gain > bestMove.gain) bestMove = move;
+        }
+        if (bestMove.gain <= 0) break;
+        recorder.incumbentUpdated();
+
+        for (unsigned int item : bestMove.out) {
+            if (item == UINT32_MAX) continue;
+            usedItems[item] = false;
+            totalWeight -= weights[item];
+            totalValue -= values[item];
+        }
+        for (unsigned int item : bestMove.in) {
+            if (item == UINT32_MAX) continue;
+            usedItems[item] = true;
+            totalWeight += weights[item];
+            totalValue += values[item];
+        }
+    }
+
+    return totalValue;
+}
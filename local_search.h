@@ -0,0 +1,30 @@
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+/**
+ * @brief Improves a feasible knapsack solution with add, 1-swap and 2-swap moves.
+ * 
+ * Can be applied after any heuristic. Candidate moves are evaluated in parallel and the best
+ * improving move is applied each round until no move improves, the time or move budget runs out
+ * or the token is cancelled. With a move budget and no time limit the result is deterministic.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Input/output array marking which items are used; must be feasible.
+ * @param timeLimit Time budget in seconds (0 = no limit).
+ * @param threads Number of worker threads (0 = one per hardware thread).
+ * @param cancel Optional cancellation token.
+ * @param maxMoves Maximum number of improving moves to apply (0 = no limit).
+ * @return Total value of the improved solution.
+ */
+unsigned int localSearch(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                         bool usedItems[], double timeLimit = 0.05, unsigned int threads = 0,
+                         const CancellationToken* cancel = nullptr, unsigned long long maxMoves = 0);
+
+#endif //LOCAL_SEARCH_H
@@ -1,9 +1,19 @@
-#include <iostream>
-
 #include "menu.h"
+#include "cli.h"
+
+using namespace std;
 
-int main() {
+/**
+ * @brief Entry point: the interactive menu, or a command line mode (see runCommandLine()):
+ * a single solve with "--pallets FILE [--truck FILE] [--algo NAME] [--threads N]
+ * [--time-limit SECONDS] [--format json|csv]", a batch run with "--batch", a cost model
+ * calibration with "--calibrate" or the solver daemon with "--serve", each optionally recorded
+ * with a leading "--trace <file>".
+ */
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        return runCommandLine(argc, argv);
+    }
     menu();
     return 0;
 }
-
@@ -1,12 +1,38 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "dataset.h"
+#include "dataset_registry.h"
 #include "data_loader.h"
 #include "menu.h"
 #include "algorithms.h"
+#include "local_search.h"
+#include "metaheuristics.h"
+#include "multi_knapsack.h"
+#include "bin_packing.h"
+#include "solver_select.h"
+#include "portfolio.h"
 using namespace std;
 
+/**
+ * @brief Prints the 1-based IDs of the selected pallets, one per line, flushing once at the end.
+ *
+ * @param usedItems Array marking which items are used.
+ * @param n Number of items.
+ */
+static void printSelected(const bool usedItems[], unsigned int n) {
+    cout << "Selected pallets IDs:\n";
+    for (unsigned int i = 0; i < n; i++) {
+        if (usedItems[i]) {
+            cout << i + 1 << '\n';
+        }
+    }
+    cout.flush();
+}
+
 /**
  * @brief Displays the interactive menu to the user to select dataset and algorithm,
  * loads the data, runs the selected knapsack algorithm, and outputs the result.
@@ -23,6 +49,8 @@ void menu() {
     string pallets_filename;
     string trucks_filename;
     unsigned int res = 0;
+    // Parsed datasets survive across iterations; a file is parsed again only if it changed
+    DatasetRegistry datasets;
     while (true) {
         cout << "Welcome to the menu. If you would like to exit at any time, just press 0." << endl;
         cout << "Please select the dataset that you would like to use:" << endl;
@@ -45,11 +73,35 @@ void menu() {
                 trucks_filename = "../datasets-extra/TruckAndPallets_0" + to_string(dataset) + ".csv";
             }
         }
-        vector<Pallet> pallets;
-        Truck truck;
-        pallets = load_data_pallets(pallets_filename);
-        truck = load_data_trucks(trucks_filename);
-        unsigned int n = truck.pallets;
+        // Parse in the background while the user picks the algorithm
+        datasets.prefetch(pallets_filename, trucks_filename);
+        cout << "\nNow select the algorithmic approach you would like to use to solve this problem" << endl;
+        cout << "1. Brute-Force Approach" << endl;
+        cout << "2. Dynamic Programming Approach" << endl;
+        cout << "3. Approximation Approach" << endl;
+        cout << "4. ILP Approach" << endl;
+        cout << "5. FPTAS Approach (guaranteed approximation)" << endl;
+        cout << "6. Metaheuristic Approach (genetic algorithm / simulated annealing)" << endl;
+        cout << "7. Whole-Fleet Loading (all trucks in the file)" << endl;
+        cout << "8. Minimum Number of Trucks (bin packing)" << endl;
+        cout << "9. Automatic (fastest exact method by cost model)" << endl;
+        cout << "10. Portfolio (race exact methods on threads)" << endl;
+        cout << "Please enter your choice: ";
+        cin >> choice;
+        if (choice == 0) {
+            cout << "exiting..." << endl;
+            exit(0);
+        }
+        string error;
+        shared_ptr<const LoadedDataset> data = datasets.get(pallets_filename, trucks_filename, nullptr, nullptr, &error);
+        if (data == nullptr) {
+            cout << error << endl;
+            cout << "The dataset could not be loaded, please try again." << endl;
+            continue;
+        }
+        const vector<Pallet>& pallets = data->pallets;
+        const Truck& truck = data->truck;
+        unsigned int n = min<size_t>(truck.pallets, pallets.size());
         unsigned int values[n];
         unsigned int weights[n];
         for (unsigned int i = 0; i < n; i++) {
@@ -58,44 +110,163 @@ void menu() {
         }
         unsigned int maxWeight = truck.capacity;
         bool usedItems[n];
-        for (int i = 0; i < n; i++) {
+        for (unsigned int i = 0; i < n; i++) {
             usedItems[i] = false;
         }
-        cout << "\nNow select the algorithmic approach you would like to use to solve this problem" << endl;
-        cout << "1. Brute-Force Approach" << endl;
-        cout << "2. Dynamic Programming Approach" << endl;
-        cout << "3. Approximation Approach" << endl;
-        cout << "4. ILP Approach" << endl;
-        cout << "Please enter your choice: ";
-        cin >> choice;
+        // Solvers that sort by ratio use the dataset's sidecar catalog, if it has a valid one
+        CatalogScope catalog(data->catalog.get(), values, weights);
         switch (choice) {
-            case 0: {
-                cout << "exiting..." << endl;
-                exit(0);
-            }
             case 1: {
                 res = knapsackBF(values, weights, n, maxWeight, usedItems);
+                printSelected(usedItems, n);
                 cout << "\nThe best solution is " << res << endl;
                 break;
             }
             case 2: {
-                if (maxWeight <= 1000 && n <= 100) {
+                if (maxWeight < 1000 && n <= 100) {
                     res = knapsackDP(values, weights, n, maxWeight, usedItems);
                 } else {
                     res = knapsackDP1(values, weights, n, maxWeight, usedItems);
                 }
+                printSelected(usedItems, n);
                 cout << "\nThe best solution is " << res << endl;
                 break;
             }
             case 3: {
-                res = knapsackGreedy(pallets, n, maxWeight, usedItems);
+                res = knapsackGreedy(values, weights, n, maxWeight, usedItems);
+                cout << "\nThe greedy solution is " << res << endl;
+                res = localSearch(values, weights, n, maxWeight, usedItems);
+                printSelected(usedItems, n);
                 cout << "\nThe best solution is " << res << endl;
                 break;
             }
-            case 4:
-                res = knapsackILP(values, weights, n, maxWeight, usedItems);
+            case 4: {
+                ILPOptions options;
+                options.onImprove = [](unsigned int value, double gap) {
+                    cout << "Incumbent " << value << " (gap " << gap * 100 << "%)" << endl;
+                };
+                ILPStats stats;
+                res = knapsackILP(values, weights, n, maxWeight, usedItems, options, &stats);
+                printSelected(usedItems, n);
                 cout << "\nThe best solution is " << res << endl;
+                if (!stats.optimal) {
+                    cout << "Search stopped early, remaining gap " << stats.gap * 100 << "%" << endl;
+                }
+                break;
+            }
+            case 5: {
+                double epsilon;
+                cout << "Please enter the accuracy epsilon (0 < epsilon < 1): ";
+                cin >> epsilon;
+                if (!(epsilon > 0 && epsilon < 1)) {
+                    cout << "Invalid epsilon, please try again." << endl;
+                    break;
+                }
+                unsigned int upperBound = 0;
+                res = knapsackFPTAS(values, weights, n, maxWeight, epsilon, usedItems, &upperBound);
+                printSelected(usedItems, n);
+                // The result is at least (1 - epsilon) * OPT, so OPT <= res / (1 - epsilon)
+                unsigned int guaranteed = min(upperBound, (unsigned int) (res / (1 - epsilon)));
+                cout << "\nThe best solution is " << res << endl;
+                cout << "Guaranteed: the optimum is at most " << guaranteed
+                     << " (within " << epsilon * 100 << "% of optimal)" << endl;
+                break;
+            }
+            case 6: {
+                int engine;
+                MetaheuristicOptions options;
+                options.progress = &cout;
+                cout << "1. Genetic algorithm\n2. Parallel-tempering simulated annealing" << endl;
+                cout << "Please enter your choice: ";
+                cin >> engine;
+                cout << "Time budget in seconds: ";
+                cin >> options.timeLimit;
+                cout << "Random seed: ";
+                cin >> options.seed;
+                if (engine == 1) {
+                    res = knapsackGenetic(values, weights, n, maxWeight, usedItems, options);
+                } else {
+                    res = knapsackAnnealing(values, weights, n, maxWeight, usedItems, options);
+                }
+                printSelected(usedItems, n);
+                cout << "\nThe best solution is " << res << endl;
+                break;
+            }
+            case 7: {
+                vector<Truck> fleet = load_data_fleet(trucks_filename);
+                vector<unsigned int> capacities;
+                for (const Truck& t : fleet) {
+                    capacities.push_back(t.capacity);
+                }
+                vector<vector<unsigned int>> loads;
+                bool optimal = false;
+                res = knapsackMultiple(values, weights, n, capacities, loads, 2000000, &optimal);
+                for (unsigned int t = 0; t < loads.size(); t++) {
+                    unsigned int load = 0;
+                    for (unsigned int item : loads[t]) {
+                        load += weights[item];
+                    }
+                    cout << "Truck " << t + 1 << " (capacity " << capacities[t] << ", load " << load << "):";
+                    for (unsigned int item : loads[t]) {
+                        cout << " " << item + 1;
+                    }
+                    cout << endl;
+                }
+                cout << "\nThe best solution is " << res << (optimal ? " (optimal)" : " (best found)") << endl;
                 break;
+            }
+            case 8: {
+                for (unsigned int i = 0; i < n; i++) {
+                    if (weights[i] > maxWeight) {
+                        cout << "Pallet " << i + 1 << " is heavier than the truck capacity and can never be shipped." << endl;
+                    }
+                }
+                unsigned int l1 = 0;
+                unsigned int l2 = binPackingLowerBound(weights, n, maxWeight, &l1);
+                vector<vector<unsigned int>> bins;
+                unsigned int ffd = binPackingFFD(weights, n, maxWeight, bins);
+                unsigned int bfd = binPackingBFD(weights, n, maxWeight, bins);
+                cout << "Lower bounds: L1 = " << l1 << ", L2 = " << l2 << endl;
+                cout << "First-Fit-Decreasing: " << ffd << " trucks" << endl;
+                cout << "Best-Fit-Decreasing: " << bfd << " trucks" << endl;
+                bool optimal = false;
+                res = binPackingExact(weights, n, maxWeight, bins, 5000000, &optimal);
+                for (unsigned int b = 0; b < bins.size(); b++) {
+                    cout << "Truck " << b + 1 << ":";
+                    for (unsigned int item : bins[b]) {
+                        cout << " " << item + 1;
+                    }
+                    cout << endl;
+                }
+                cout << "\nThe minimum number of trucks is " << res << (optimal ? " (optimal)" : " (best found)") << endl;
+                break;
+            }
+            case 9: {
+                InstanceFeatures features = computeFeatures(values, weights, n, maxWeight);
+                for (const CostEstimate& estimate : estimateCosts(features, activeCostModel())) {
+                    cout << estimate.solver << ": ";
+                    if (estimate.applicable) {
+                        cout << estimate.seconds << " s, " << estimate.bytes / 1e6 << " MB" << endl;
+                    } else {
+                        cout << "not applicable" << endl;
+                    }
+                }
+                cout << "Selected: " << selectSolver(features, activeCostModel()) << endl;
+                res = knapsackAuto(values, weights, n, maxWeight, usedItems);
+                printSelected(usedItems, n);
+                cout << "\nThe best solution is " << res << endl;
+                break;
+            }
+            case 10: {
+                string winner;
+                auto start = chrono::steady_clock::now();
+                res = knapsackPortfolio(values, weights, n, maxWeight, usedItems, &winner);
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                printSelected(usedItems, n);
+                cout << "\nThe best solution is " << res << endl;
+                cout << "Won by " << winner << " in " << seconds << " s" << endl;
+                break;
+            }
             default:
                 cout << "Invalid choice, please try again." << endl;
         }
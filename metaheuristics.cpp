@@ -0,0 +1,453 @@
+#include <vector>
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include "metaheuristics.h"
+#include "solver_stats.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @struct Chromosome
+ * @brief A candidate solution stored as a compact bitset, with its cached value and weight.
+ */
+struct Chromosome {
+    vector<unsigned long long> bits;
+    unsigned long long value = 0;
+    unsigned long long weight = 0;
+
+    bool get(unsigned int i) const { return (bits[i >> 6] >> (i & 63)) & 1ULL; }
+    void set(unsigned int i) { bits[i >> 6] |= 1ULL << (i & 63); }
+    void clear(unsigned int i) { bits[i >> 6] &= ~(1ULL << (i & 63)); }
+
+    /**
+     * @brief Returns true if this solution is better: higher value, then lower weight.
+     */
+    bool betterThan(const Chromosome& other) const {
+        return value > other.value || (value == other.value && weight < other.weight);
+    }
+};
+
+/**
+ * @struct Problem
+ * @brief Instance data shared read-only by all islands, plus the ratio order used for repair.
+ */
+struct Problem {
+    unsigned int* values;
+    unsigned int* weights;
+    unsigned int n;
+    unsigned long long maxWeight;
+    unsigned int words;
+    vector<unsigned int> byRatio; ///< Items that fit on their own, by decreasing profit/weight ratio
+    vector<unsigned int> minWeightFrom; ///< minWeightFrom[k]: lightest item among byRatio[k..]
+
+    Problem(unsigned int v[], unsigned int w[], unsigned int count, unsigned int capacity)
+        : values(v), weights(w), n(count), maxWeight(capacity), words(count / 64 + 1) {
+        for (unsigned int i = 0; i < n; i++) {
+            if (weights[i] <= maxWeight) byRatio.push_back(i);
+        }
+        sort(byRatio.begin(), byRatio.end(), [&](unsigned int a, unsigned int b) {
+            return (unsigned long long) values[a] * weights[b] > (unsigned long long) values[b] * weights[a];
+        });
+        minWeightFrom.assign(byRatio.size() + 1, UINT32_MAX);
+        for (size_t k = byRatio.size(); k-- > 0;) {
+            minWeightFrom[k] = min(minWeightFrom[k + 1], weights[byRatio[k]]);
+        }
+    }
+
+    Chromosome empty() const {
+        Chromosome c;
+        c.bits.assign(words, 0);
+        return c;
+    }
+
+    /**
+     * @brief Recomputes the value and weight of a chromosome from its bits.
+     */
+    void evaluate(Chromosome& c) const {
+        c.value = 0;
+        c.weight = 0;
+        for (unsigned int w = 0; w < words; w++) {
+            unsigned long long word = c.bits[w];
+            while (word != 0) {
+                unsigned int i = w * 64 + __builtin_ctzll(word);
+                c.value += values[i];
+                c.weight += weights[i];
+                word &= word - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Ratio-driven repair: drops the worst-ratio items until the chromosome is feasible,
+     * then adds the best-ratio items that still fit.
+     */
+    void repair(Chromosome& c) const {
+        for (size_t k = byRatio.size(); k-- > 0 && c.weight > maxWeight;) {
+            unsigned int i = byRatio[k];
+            if (c.get(i)) {
+                c.clear(i);
+                c.value -= values[i];
+                c.weight -= weights[i];
+            }
+        }
+        for (size_t k = 0; k < byRatio.size(); k++) {
+            if (c.weight + minWeightFrom[k] > maxWeight) break;
+            unsigned int i = byRatio[k];
+            if (!c.get(i) && c.weight + weights[i] <= maxWeight) {
+                c.set(i);
+                c.value += values[i];
+                c.weight += weights[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Random feasible chromosome: each item is drawn with a probability that roughly
+     * fills the capacity, then repaired.
+     */
+    Chromosome random(mt19937_64& rng) const {
+        Chromosome c = empty();
+        unsigned long long totalWeight = 0;
+        for (unsigned int i : byRatio) totalWeight += weights[i];
+        double p = totalWeight > 0 ? min(1.0, (double) maxWeight / totalWeight) : 1.0;
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        for (unsigned int i : byRatio) {
+            if (coin(rng) < p) c.set(i);
+        }
+        evaluate(c);
+        repair(c);
+        return c;
+    }
+};
+
+/**
+ * @struct GeneticIsland
+ * @brief One GA population: tournament selection, uniform crossover on bitset words,
+ * single-item mutation, ratio-driven repair and elitism.
+ */
+struct GeneticIsland {
+    const Problem* problem;
+    mt19937_64 rng;
+    vector<Chromosome> population;
+    vector<Chromosome> next;
+    size_t bestIndex = 0;
+
+    GeneticIsland(const Problem& p, unsigned long long seed, unsigned int size, bool seedGreedy)
+        : problem(&p), rng(seed) {
+        for (unsigned int k = 0; k < max(2u, size); k++) {
+            if (k == 0 && seedGreedy) {
+                Chromosome greedy = p.empty();
+                p.repair(greedy);
+                population.push_back(greedy);
+            } else {
+                population.push_back(p.random(rng));
+            }
+        }
+        next = population;
+        updateBest();
+    }
+
+    void updateBest() {
+        bestIndex = 0;
+        for (size_t k = 1; k < population.size(); k++) {
+            if (population[k].betterThan(population[bestIndex])) bestIndex = k;
+        }
+    }
+
+    const Chromosome& best() const { return population[bestIndex]; }
+
+    const Chromosome& tournament() {
+        const Chromosome& a = population[rng() % population.size()];
+        const Chromosome& b = population[rng() % population.size()];
+        return a.betterThan(b) ? a : b;
+    }
+
+    void step() {
+        next[0] = population[bestIndex];
+        for (size_t k = 1; k < next.size(); k++) {
+            const Chromosome& a = tournament();
+            const Chromosome& b = tournament();
+            Chromosome& child = next[k];
+            for (unsigned int w = 0; w < problem->words; w++) {
+                unsigned long long mask = rng();
+                child.bits[w] = (a.bits[w] & mask) | (b.bits[w] & ~mask);
+            }
+            problem->evaluate(child);
+            if (!problem->byRatio.empty()) {
+                unsigned int i = problem->byRatio[rng() % problem->byRatio.size()];
+                if (child.get(i)) {
+                    child.clear(i);
+                    child.value -= problem->values[i];
+                    child.weight -= problem->weights[i];
+                } else {
+                    child.set(i);
+                    child.value += problem->values[i];
+                    child.weight += problem->weights[i];
+                }
+            }
+            problem->repair(child);
+        }
+        swap(population, next);
+        updateBest();
+    }
+
+    void immigrate(const Chromosome& migrant) {
+        size_t worst = 0;
+        for (size_t k = 1; k < population.size(); k++) {
+            if (population[worst].betterThan(population[k])) worst = k;
+        }
+        if (migrant.betterThan(population[worst])) {
+            population[worst] = migrant;
+            updateBest();
+        }
+    }
+};
+
+/**
+ * @struct TemperingIsland
+ * @brief Parallel tempering: replicas annealed at a ladder of fixed temperatures, with
+ * Metropolis exchanges between neighbouring temperatures after every step.
+ */
+struct TemperingIsland {
+    const Problem* problem;
+    mt19937_64 rng;
+    vector<Chromosome> replicas;  ///< replicas[0] is the coldest
+    vector<double> temperatures;
+    Chromosome bestSolution;
+    unsigned int movesPerStep;
+    unsigned long long steps = 0;
+    vector<unsigned int> removed;
+
+    TemperingIsland(const Problem& p, unsigned long long seed, unsigned int size, bool seedGreedy)
+        : problem(&p), rng(seed) {
+        unsigned int count = max(2u, min(size, 16u));
+        double meanValue = 0;
+        for (unsigned int i : p.byRatio) meanValue += p.values[i];
+        meanValue = p.byRatio.empty() ? 1.0 : max(1.0, meanValue / p.byRatio.size());
+        double hot = meanValue, cold = meanValue * 1e-3;
+        for (unsigned int k = 0; k < count; k++) {
+            temperatures.push_back(cold * pow(hot / cold, (double) k / (count - 1)));
+            if (k == 0 && seedGreedy) {
+                Chromosome greedy = p.empty();
+                p.repair(greedy);
+                replicas.push_back(greedy);
+            } else {
+                replicas.push_back(p.random(rng));
+            }
+        }
+        movesPerStep = max(100u, min(p.n, 10000u));
+        bestSolution = replicas[0];
+        for (const Chromosome& r : replicas) {
+            if (r.betterThan(bestSolution)) bestSolution = r;
+        }
+    }
+
+    const Chromosome& best() const { return bestSolution; }
+
+    /**
+     * @brief One Metropolis move: drop a random item, or add one and drop random items until it fits.
+     */
+    void move(Chromosome& c, double temperature) {
+        const vector<unsigned int>& items = problem->byRatio;
+        unsigned int j = items[rng() % items.size()];
+        uniform_real_distribution<double> coin(0.0, 1.0);
+
+        if (c.get(j)) {
+            if (coin(rng) < exp(-(double) problem->values[j] / temperature)) {
+                c.clear(j);
+                c.value -= problem->values[j];
+                c.weight -= problem->weights[j];
+            }
+            return;
+        }
+
+        removed.clear();
+        c.set(j);
+        c.value += problem->values[j];
+        c.weight += problem->weights[j];
+        long long delta = problem->values[j];
+        unsigned int tries = 0;
+        while (c.weight > problem->maxWeight && tries < 64) {
+            unsigned int i = items[rng() % items.size()];
+            tries++;
+            if (i == j || !c.get(i)) continue;
+            c.clear(i);
+            c.value -= problem->values[i];
+            c.weight -= problem->weights[i];
+            delta -= problem->values[i];
+            removed.push_back(i);
+        }
+        bool accept = c.weight <= problem->maxWeight &&
+                      (delta >= 0 || coin(rng) < exp((double) delta / temperature));
+        if (!accept) {
+            c.clear(j);
+            c.value -= problem->values[j];
+            c.weight -= problem->weights[j];
+            for (unsigned int i : removed) {
+                c.set(i);
+                c.value += problem->values[i];
+                c.weight += problem->weights[i];
+            }
+        }
+    }
+
+    void step() {
+        if (problem->byRatio.empty()) return;
+        for (size_t k = 0; k < replicas.size(); k++) {
+            for (unsigned int m = 0; m < movesPerStep; m++) move(replicas[k], temperatures[k]);
+            if (replicas[k].betterThan(bestSolution)) bestSolution = replicas[k];
+        }
+        // Replica exchange between neighbours, alternating even and odd pairs
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        for (size_t k = steps % 2; k + 1 < replicas.size(); k += 2) {
+            double exponent = ((double) replicas[k + 1].value - (double) replicas[k].value) *
+                              (1.0 / temperatures[k] - 1.0 / temperatures[k + 1]);
+            if (exponent >= 0 || coin(rng) < exp(exponent)) swap(replicas[k], replicas[k + 1]);
+        }
+        steps++;
+    }
+
+    void immigrate(const Chromosome& migrant) {
+        if (migrant.betterThan(replicas[0])) replicas[0] = migrant;
+        if (migrant.betterThan(bestSolution)) bestSolution = migrant;
+    }
+};
+
+/**
+ * @brief Runs one island per thread with periodic ring migration and returns the best solution.
+ *
+ * Islands synchronize on a barrier every migrationInterval generations: each publishes its best
+ * solution, the last thread to arrive checks the budgets and reports progress, and then every
+ * island takes in its predecessor's migrant. Outboxes are double-buffered by phase so that a
+ * fast island never overwrites a migrant that is still being read.
+ */
+template <typename Island>
+static unsigned int runIslands(const char* name, unsigned int values[], unsigned int weights[], unsigned int n,
+                               unsigned int maxWeight, bool usedItems[], const MetaheuristicOptions& options) {
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&]() { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+
+    Problem problem(values, weights, n, maxWeight);
+    unsigned int threads = options.threads != 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    unsigned long long generations = options.generations;
+    if (options.timeLimit <= 0 && generations == 0) generations = 1000;
+    unsigned int interval = max(1u, options.migrationInterval);
+
+    vector<Island> islands;
+    for (unsigned int t = 0; t < threads; t++) {
+        islands.emplace_back(problem, options.seed + 7919ULL * t, options.populationSize, t == 0);
+    }
+
+    vector<Chromosome> outbox[2] = {vector<Chromosome>(threads), vector<Chromosome>(threads)};
+    unsigned long long done = 0;
+    double lastProgress = 0;
+    bool stop = false;
+
+    auto onPhase = [&]() noexcept {
+        done += interval;
+        if (generations != 0) done = min(done, generations);
+        double now = elapsed();
+        if (options.progress != nullptr && options.progressInterval > 0 && now - lastProgress >= options.progressInterval) {
+            lastProgress = now;
+            unsigned long long best = 0;
+            for (const Island& island : islands) best = max(best, island.best().value);
+            *options.progress << "[" << name << "] " << fixed << setprecision(2) << now << "s  generation " << done
+                 << "  best " << best << defaultfloat << endl;
+        }
+        stop = (options.timeLimit > 0 && now >= options.timeLimit) || (generations != 0 && done >= generations) ||
+               (options.cancel != nullptr && options.cancel->isCancelled());
+    };
+    barrier sync(threads, onPhase);
+
+    auto worker = [&](unsigned int t) {
+        // Island 0 runs on the calling thread, which keeps its own name
+        if (t != 0 && traceEnabled()) setTraceThreadName(string(name) + " island " + to_string(t));
+        for (unsigned long long phase = 0;; phase++) {
+            unsigned long long block = generations != 0 ? min<unsigned long long>(interval, generations - phase * interval)
+                                                        : interval;
+            {
+                TraceScope trace("generations", "island", "phase", phase);
+                for (unsigned long long g = 0; g < block; g++) {
+                    if ((options.timeLimit > 0 && elapsed() >= options.timeLimit) ||
+                        (options.cancel != nullptr && options.cancel->isCancelled())) break;
+                    islands[t].step();
+                }
+            }
+            outbox[phase % 2][t] = islands[t].best();
+            TraceScope migration("migration", "island", "phase", phase);
+            sync.arrive_and_wait();
+            if (stop) break;
+            islands[t].immigrate(outbox[phase % 2][(t + threads - 1) % threads]);
+        }
+    };
+
+    recorder.phase(SolverPhase::Solve);
+    vector<thread> workers;
+    for (unsigned int t = 1; t < threads; t++) workers.emplace_back(worker, t);
+    worker(0);
+    for (thread& w : workers) w.join();
+
+    recorder.phase(SolverPhase::Reconstruct);
+    const Chromosome* best = &islands[0].best();
+    for (const Island& island : islands) {
+        if (island.best().betterThan(*best)) best = &island.best();
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = best->get(i);
+    }
+
+    return best->value;
+}
+
+/**
+ * @brief Island-model genetic algorithm for the knapsack problem.
+ *
+ * Each thread evolves an independent population of bitset chromosomes (tournament selection,
+ * uniform crossover, single-item mutation, elitism); infeasible children are fixed by a
+ * ratio-driven repair operator. Every migrationInterval generations the best individual of each
+ * island replaces the worst individual of the next island in a ring. The first island is seeded
+ * with the greedy solution.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param options Engine settings.
+ * @return Total value of the best solution found.
+ */
+unsigned int knapsackGenetic(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                             bool usedItems[], const MetaheuristicOptions& options) {
+    return runIslands<GeneticIsland>("GA", values, weights, n, maxWeight, usedItems, options);
+}
+
+/**
+ * @brief Parallel-tempering simulated annealing for the knapsack problem.
+ *
+ * Each thread anneals a ladder of replicas at geometrically spaced temperatures (from the mean
+ * item profit down to a thousandth of it) and exchanges neighbouring replicas with the usual
+ * Metropolis criterion. Moves drop a random item, or add one and drop random items until the
+ * load fits. Islands pass their best solution to the next island's coldest replica on migration.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param options Engine settings.
+ * @return Total value of the best solution found.
+ */
+unsigned int knapsackAnnealing(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                               bool usedItems[], const MetaheuristicOptions& options) {
+    return runIslands<TemperingIsland>("PT", values, weights, n, maxWeight, usedItems, options);
+}
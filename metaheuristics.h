@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef METAHEURISTICS_H
+#define METAHEURISTICS_H
+
+/**
+ * @struct MetaheuristicOptions
+ * @brief Settings shared by the genetic algorithm and parallel-tempering annealing engines.
+ *
+ * With a fixed seed, thread count and generation limit (and no time limit) runs are reproducible.
+ */
+struct MetaheuristicOptions {
+    double timeLimit = 1.0;              ///< Wall-clock budget in seconds (0 = no limit)
+    unsigned long long generations = 0;  ///< Generations / exchange steps per island (0 = no limit)
+    unsigned int threads = 0;            ///< Number of islands, one per thread (0 = one per hardware thread)
+    unsigned long long seed = 42;        ///< Seed of the random number generators
+    unsigned int populationSize = 64;    ///< Individuals per GA island / replicas per annealing island
+    unsigned int migrationInterval = 25; ///< Generations between migrations to the next island
+    double progressInterval = 0.5;       ///< Seconds between progress lines (0 = silent)
+    ostream* progress = nullptr;         ///< Stream receiving the progress lines (nullptr = silent)
+    const CancellationToken* cancel = nullptr; ///< Optional token that stops the run early
+};
+
+/**
+ * @brief Island-model genetic algorithm for the knapsack problem.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param options Engine settings.
+ * @return Total value of the best solution found.
+ */
+unsigned int knapsackGenetic(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                             bool usedItems[], const MetaheuristicOptions& options = MetaheuristicOptions());
+
+/**
+ * @brief Parallel-tempering simulated annealing for the knapsack problem.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param options Engine settings.
+ * @return Total value of the best solution found.
+ */
+unsigned int knapsackAnnealing(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                               bool usedItems[], const MetaheuristicOptions& options = MetaheuristicOptions());
+
+#endif //METAHEURISTICS_H
@@ -0,0 +1,235 @@
+#include <vector>
+#include <algorithm>
+#include "multi_knapsack.h"
+#include "solver_stats.h"
+#include "local_search.h"
+
+using namespace std;
+
+/// Improving moves the local search may apply per truck in the repair step
+static const unsigned long long repairMoves = 64;
+
+/**
+ * @brief Greedy + repair heuristic for the multiple knapsack problem.
+ *
+ * Items are placed in decreasing ratio order on the truck with the least residual capacity that
+ * still fits them (best fit). An item that fits nowhere is repaired in by shifting one item of some
+ * truck to another truck with room. Finally every truck is improved by local search over its own
+ * load plus the pallets left on the dock, bounded by a move budget rather than a time budget so
+ * that the result does not depend on the machine or its load.
+ *
+ * @param order Items by decreasing profit-to-weight ratio.
+ * @param assign Output truck index per item (-1 = not loaded).
+ * @param cancel Optional cancellation token, which cuts the local search short.
+ * @return Total value loaded.
+ */
+static unsigned long long greedyRepair(unsigned int values[], unsigned int weights[], unsigned int n,
+                                       const vector<unsigned int>& capacities, const vector<unsigned int>& order,
+                                       vector<int>& assign, const CancellationToken* cancel) {
+    unsigned int m = capacities.size();
+    vector<unsigned long long> residual(capacities.begin(), capacities.end());
+    assign.assign(n, -1);
+
+    for (unsigned int item : order) {
+        int bestTruck = -1;
+        for (unsigned int t = 0; t < m; t++) {
+            if (weights[item] <= residual[t] && (bestTruck < 0 || residual[t] < residual[bestTruck])) {
+                bestTruck = t;
+            }
+        }
+        if (bestTruck >= 0) {
+            assign[item] = bestTruck;
+            residual[bestTruck] -= weights[item];
+            continue;
+        }
+
+        // Repair: move one loaded item i from truck t to truck u so that the new item fits on t
+        bool placed = false;
+        for (unsigned int i = 0; i < n && !placed; i++) {
+            if (assign[i] < 0) continue;
+            unsigned int t = assign[i];
+            if (weights[item] > residual[t] + weights[i]) continue;
+            for (unsigned int u = 0; u < m; u++) {
+                if (u == t || weights[i] > residual[u]) continue;
+                residual[u] -= weights[i];
+                residual[t] = residual[t] + weights[i] - weights[item];
+                assign[i] = u;
+                assign[item] = t;
+                placed = true;
+                break;
+            }
+        }
+    }
+
+    // Per-truck local search over the truck's load and the unassigned items
+    for (unsigned int t = 0; t < m; t++) {
+        vector<unsigned int> pool;
+        for (unsigned int i = 0; i < n; i++) {
+            if (assign[i] == (int) t || (assign[i] < 0 && weights[i] <= capacities[t])) pool.push_back(i);
+        }
+        if (pool.empty()) continue;
+        vector<unsigned int> subValues(pool.size()), subWeights(pool.size());
+        vector<char> used(pool.size());
+        for (size_t k = 0; k < pool.size(); k++) {
+            subValues[k] = values[pool[k]];
+            subWeights[k] = weights[pool[k]];
+            used[k] = assign[pool[k]] == (int) t;
+        }
+        localSearch(subValues.data(), subWeights.data(), pool.size(), capacities[t],
+                    reinterpret_cast<bool*>(used.data()), 0, 1, cancel, repairMoves);
+        for (size_t k = 0; k < pool.size(); k++) {
+            assign[pool[k]] = used[k] ? (int) t : -1;
+        }
+    }
+
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (assign[i] >= 0) total += values[i];
+    }
+    return total;
+}
+
+/**
+ * @brief Multiple knapsack solver: assigns pallets across a fleet of trucks.
+ *
+ * An incumbent is first built with the greedy + repair heuristic. If a node budget is given, a
+ * depth-first branch-and-bound then assigns items in decreasing ratio order to each truck that
+ * has room, or leaves them out. Nodes are bounded with the surrogate relaxation, which merges
+ * all trucks into a single knapsack of their total residual capacity and takes its Dantzig
+ * bound (items heavier than every residual capacity are skipped). Trucks whose residual
+ * capacity equals that of a truck already tried at the same node are interchangeable and are
+ * skipped. The search keeps its path on an explicit stack, so its depth is not limited by the
+ * call stack. When the budget runs out or the token is cancelled (polled every 256 nodes) the
+ * best assignment found so far is returned.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacities Capacity of each truck.
+ * @param loads Output with, for every truck, the (0-based) indices of the items loaded on it.
+ * @param nodeLimit Branch-and-bound node budget (0 = greedy+repair heuristic only).
+ * @param optimal Optional output set to true if the result is proven optimal.
+ * @param cancel Optional cancellation token; the best assignment found so far is returned.
+ * @return Total value loaded on the fleet.
+ */
+unsigned int knapsackMultiple(unsigned int values[], unsigned int weights[], unsigned int n,
+                              const vector<unsigned int>& capacities, vector<vector<unsigned int>>& loads,
+                              unsigned long long nodeLimit, bool* optimal, const CancellationToken* cancel) {
+    unsigned int m = capacities.size();
+    SolverStatsRecorder recorder;
+    recorder.phase(SolverPhase::Preprocess);
+    vector<unsigned int> order(n);
+    for (unsigned int i = 0; i < n; i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        return (unsigned long long) values[a] * weights[b] > (unsigned long long) values[b] * weights[a];
+    });
+
+    vector<int> bestAssign;
+    unsigned long long bestValue = greedyRepair(values, weights, n, capacities, order, bestAssign, cancel);
+    bool complete = nodeLimit > 0;
+
+    recorder.phase(SolverPhase::Solve);
+    if (nodeLimit > 0 && m > 0) {
+        vector<unsigned long long> residual(capacities.begin(), capacities.end());
+        vector<int> assign(n, -1);
+        unsigned long long nodes = 0;
+        bool stopped = false;
+
+        // Surrogate bound: remaining items in ratio order into the pooled residual capacity
+        auto bound = [&](unsigned int level, unsigned long long value) -> double {
+            recorder.boundEvaluated();
+            unsigned long long pooled = 0, largest = 0;
+            for (unsigned long long r : residual) {
+                pooled += r;
+                largest = max(largest, r);
+            }
+            double b = (double) value;
+            for (unsigned int k = level; k < n && pooled > 0; k++) {
+                unsigned int item = order[k];
+                if (weights[item] > largest) continue;
+                if (weights[item] <= pooled) {
+                    pooled -= weights[item];
+                    b += values[item];
+                } else {
+                    b += (double) values[item] * pooled / weights[item];
+                    pooled = 0;
+                }
+            }
+            return b;
+        };
+
+        /**
+         * @brief A node being expanded: the truck its item is on (-1 = none) and the next branch
+         * to try (trucks 0..m-1, then m = leave the item out).
+         */
+        struct Frame {
+            unsigned int level;
+            unsigned long long value;
+            unsigned int next;
+            int placed;
+            vector<unsigned long long> tried;  ///< Residual capacities already branched on
+        };
+        vector<Frame> stack;
+        stack.reserve(n + 1);
+
+        // Visits a node; pushes it if it has to be expanded
+        auto visit = [&](unsigned int level, unsigned long long value) {
+            if (++nodes > nodeLimit || (cancel != nullptr && (nodes & 255) == 0 && cancel->isCancelled())) {
+                complete = false;
+                stopped = true;
+                return;
+            }
+            recorder.nodeCreated();
+            if (value > bestValue) {
+                recorder.incumbentUpdated();
+                bestValue = value;
+                bestAssign = assign;
+            }
+            if (level == n) return;
+            if (bound(level, value) <= (double) bestValue) {
+                recorder.nodePruned();
+                return;
+            }
+            recorder.nodeExpanded();
+            stack.push_back({level, value, 0, -1, {}});
+        };
+
+        visit(0, 0);
+        while (!stack.empty() && !stopped) {
+            Frame& frame = stack.back();
+            unsigned int item = order[frame.level];
+            unsigned int level = frame.level;
+            unsigned long long value = frame.value;
+            if (frame.placed >= 0) {
+                residual[frame.placed] += weights[item];
+                assign[item] = -1;
+                frame.placed = -1;
+            }
+            if (frame.next > m) {
+                stack.pop_back();
+                continue;
+            }
+            unsigned int t = frame.next++;
+            if (t == m) {
+                visit(level + 1, value);
+                continue;
+            }
+            if (weights[item] > residual[t]) continue;
+            if (find(frame.tried.begin(), frame.tried.end(), residual[t]) != frame.tried.end()) continue;
+            frame.tried.push_back(residual[t]);
+            residual[t] -= weights[item];
+            assign[item] = t;
+            frame.placed = t;
+            visit(level + 1, value + values[item]);
+        }
+    }
+
+    if (optimal != nullptr) *optimal = complete;
+
+    recorder.phase(SolverPhase::Reconstruct);
+    loads.assign(m, {});
+    for (unsigned int i = 0; i < n; i++) {
+        if (bestAssign[i] >= 0) loads[bestAssign[i]].push_back(i);
+    }
+    return bestValue;
+}
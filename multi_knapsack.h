@@ -0,0 +1,26 @@
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef MULTI_KNAPSACK_H
+#define MULTI_KNAPSACK_H
+
+/**
+ * @brief Multiple knapsack solver: assigns pallets across a fleet of trucks.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param capacities Capacity of each truck.
+ * @param loads Output with, for every truck, the (0-based) indices of the items loaded on it.
+ * @param nodeLimit Branch-and-bound node budget (0 = greedy+repair heuristic only).
+ * @param optimal Optional output set to true if the result is proven optimal.
+ * @param cancel Optional cancellation token; the best assignment found so far is returned.
+ * @return Total value loaded on the fleet.
+ */
+unsigned int knapsackMultiple(unsigned int values[], unsigned int weights[], unsigned int n,
+                              const vector<unsigned int>& capacities, vector<vector<unsigned int>>& loads,
+                              unsigned long long nodeLimit = 2000000, bool* optimal = nullptr,
+                              const CancellationToken* cancel = nullptr);
+
+#endif //MULTI_KNAPSACK_H
@@ -0,0 +1,147 @@
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include "json.h"
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Column name of an event.
+ */
+const char* perfEventName(PerfEvent event) {
+    static const char* names[PerfEventCount] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+    return names[event];
+}
+
+/**
+ * @brief Hardware counters as a JSON object (unavailable events are null), or null if none is available.
+ */
+string perfJSON(const PerfReading& perf) {
+    if (!perf.anyAvailable()) return "null";
+    ostringstream out;
+    out << "{";
+    for (int e = 0; e < PerfEventCount; e++) {
+        out << (e ? ", " : "") << jsonQuote(perfEventName((PerfEvent) e)) << ": ";
+        if (perf.available((PerfEvent) e)) out << perf.value[e];
+        else out << "null";
+    }
+    out << ", \"ipc\": ";
+    if (perf.ipc() >= 0) out << perf.ipc();
+    else out << "null";
+    out << "}";
+    return out.str();
+}
+
+bool PerfReading::anyAvailable() const {
+    for (int e = 0; e < PerfEventCount; e++) {
+        if (value[e] >= 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Instructions per cycle, or -1 if either count is missing.
+ */
+double PerfReading::ipc() const {
+    if (value[PerfCycles] <= 0 || value[PerfInstructions] < 0) return -1;
+    return (double) value[PerfInstructions] / value[PerfCycles];
+}
+
+#ifdef __linux__
+
+/**
+ * @brief Opens one disabled, user-space-only counter that follows new threads.
+ */
+static int openEvent(unsigned int type, unsigned long long config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+    const unsigned long long l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const pair<unsigned int, unsigned long long> events[PerfEventCount] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, l1dReadMiss},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+    int lastError = 0;
+    for (int e = 0; e < PerfEventCount; e++) {
+        fds[e] = openEvent(events[e].first, events[e].second);
+        if (fds[e] < 0) lastError = errno;
+    }
+    if (!available()) reason = string("perf_event_open: ") + strerror(lastError);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfReading PerfCounters::stop() {
+    PerfReading reading;
+    for (int e = 0; e < PerfEventCount; e++) {
+        if (fds[e] < 0) continue;
+        ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+        unsigned long long data[3];  // value, time enabled, time running
+        if (read(fds[e], data, sizeof(data)) != sizeof(data)) continue;
+        if (data[2] == 0) {
+            reading.value[e] = data[1] == 0 ? (long long) data[0] : -1;
+        } else {
+            reading.value[e] = (long long) ((double) data[0] * data[1] / data[2]);
+        }
+    }
+    return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() : reason("hardware counters need Linux perf_event_open") {
+    for (int& fd : fds) fd = -1;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::available() const { return false; }
+
+void PerfCounters::start() {}
+
+PerfReading PerfCounters::stop() { return PerfReading(); }
+
+#endif
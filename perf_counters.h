@@ -0,0 +1,79 @@
+#include <string>
+using namespace std;
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/**
+ * @enum PerfEvent
+ * @brief Hardware events counted around a solver call.
+ */
+enum PerfEvent { PerfCycles, PerfInstructions, PerfL1DMisses, PerfLLCMisses, PerfBranchMisses, PerfEventCount };
+
+/**
+ * @brief Column name of an event ("cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses").
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * @struct PerfReading
+ * @brief Counts of one measured region; -1 marks an event the kernel or hardware does not provide.
+ */
+struct PerfReading {
+    long long value[PerfEventCount] = {-1, -1, -1, -1, -1};
+
+    bool available(PerfEvent event) const { return value[event] >= 0; }
+    bool anyAvailable() const;
+
+    /**
+     * @brief Instructions per cycle, or -1 if either count is missing.
+     */
+    double ipc() const;
+};
+
+/**
+ * @brief Hardware counters as a JSON object (unavailable events are null), or null if none is available.
+ */
+string perfJSON(const PerfReading& perf);
+
+/**
+ * @class PerfCounters
+ * @brief Linux perf_event_open counters for the calling thread and the threads it starts.
+ *
+ * Every event is opened on its own, so a missing one (no PMU in a VM, perf_event_paranoid,
+ * seccomp) only blanks that column. On other systems, or when nothing can be opened, readings
+ * are all unavailable and start()/stop() cost nothing.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Whether at least one event could be opened.
+     */
+    bool available() const;
+
+    /**
+     * @brief Why no event could be opened (empty when available).
+     */
+    const string& error() const { return reason; }
+
+    /**
+     * @brief Resets and starts counting.
+     */
+    void start();
+
+    /**
+     * @brief Stops counting and returns the counts since start(), scaled for multiplexing.
+     */
+    PerfReading stop();
+
+private:
+    int fds[PerfEventCount];
+    string reason;
+};
+
+#endif //PERF_COUNTERS_H
@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "algorithms.h"
+#include "cancellation.h"
+#include "portfolio.h"
+#include "solver_select.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief One solver in the race: its name, entry point and private output buffer.
+ */
+struct Racer {
+    string name;
+    function<bool(bool usedItems[], unsigned int& value)> run; ///< Returns true if the result is proven optimal
+    unique_ptr<bool[]> usedItems;
+    unsigned int value = 0;
+};
+
+/**
+ * @brief Appends one line to the portfolio log; concurrent portfolio runs share the file.
+ */
+static void appendPortfolioLog(const string& filename, const InstanceFeatures& features, const string& winner, double seconds) {
+    static mutex logMutex;
+    lock_guard<mutex> lock(logMutex);
+    ofstream file(filename, ios::app);
+    if (!file.is_open()) return;
+    file << features.n << "," << features.maxWeight << "," << features.profitSum << ","
+         << features.correlation << "," << winner << "," << seconds << "\n";
+}
+
+/**
+ * @brief Races dynamic programming, branch-and-bound and meet-in-the-middle on separate threads.
+ *
+ * Every solver works on its own copy of the output, the first one to finish with a proven
+ * optimum claims the result and cancels the others through a shared CancellationToken.
+ * DP only joins the race when its table fits the cost model's memory budget, MITM only for
+ * n <= 44. The winner is appended to the portfolio log.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param winner Optional output: cost-model name of the solver that won.
+ * @param logFile Log to append to; if empty, $KNAPSACK_PORTFOLIO_LOG is used when set.
+ * @param cancel Optional token that stops the whole race.
+ * @param status Optional output: Optimal, or Cancelled (best solution of any racer returned).
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackPortfolio(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                               bool usedItems[], string* winner, const string& logFile,
+                               const CancellationToken* cancel, SolveStatus* status) {
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = false;
+    }
+    if (status != nullptr) *status = SolveStatus::Optimal;
+    if (n == 0) {
+        if (winner != nullptr) *winner = "";
+        return 0;
+    }
+
+    InstanceFeatures features = computeFeatures(values, weights, n, maxWeight);
+    bool dpFits = false;
+    for (const CostEstimate& estimate : estimateCosts(features, activeCostModel())) {
+        if (estimate.solver == "dp") dpFits = estimate.applicable;
+    }
+
+    CancellationToken race(0, cancel);
+    vector<Racer> racers;
+    if (dpFits) {
+        racers.push_back({"dp", [&](bool used[], unsigned int& value) {
+            SolveStatus status;
+            value = knapsackDP1(values, weights, n, maxWeight, used, &race, &status);
+            return status == SolveStatus::Optimal;
+        }, nullptr});
+    }
+    racers.push_back({"ilp", [&](bool used[], unsigned int& value) {
+        ILPOptions options;
+        options.cancel = &race;
+        ILPStats stats;
+        value = knapsackILP(values, weights, n, maxWeight, used, options, &stats);
+        return stats.optimal;
+    }, nullptr});
+    if (n <= 44) {
+        racers.push_back({"mitm", [&](bool used[], unsigned int& value) {
+            SolveStatus status;
+            value = knapsackMITM(values, weights, n, maxWeight, used, &race, &status);
+            return status == SolveStatus::Optimal;
+        }, nullptr});
+    }
+
+    // The first racer to prove optimality claims the result; the rest only notice the token
+    atomic<int> claimed{-1};
+    double winnerSeconds = 0;
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t r = 0; r < racers.size(); r++) {
+        racers[r].usedItems.reset(new bool[n]());
+        threads.emplace_back([&, r]() {
+            Racer& racer = racers[r];
+            if (traceEnabled()) setTraceThreadName("portfolio " + racer.name);
+            TraceScope trace("race", "portfolio");
+            bool optimal = racer.run(racer.usedItems.get(), racer.value);
+            int expected = -1;
+            if (optimal && claimed.compare_exchange_strong(expected, (int) r)) {
+                winnerSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                race.cancel();
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    // Branch-and-bound always finishes unless cancelled, so without an outer cancellation some
+    // racer has claimed the result; otherwise every racer holds a feasible best-known solution
+    int r = claimed.load();
+    if (r < 0) {
+        r = 0;
+        for (size_t k = 1; k < racers.size(); k++) {
+            if (racers[k].value > racers[r].value) r = k;
+        }
+        for (unsigned int i = 0; i < n; i++) {
+            usedItems[i] = racers[r].usedItems[i];
+        }
+        if (winner != nullptr) *winner = "";
+        if (status != nullptr) *status = SolveStatus::Cancelled;
+        return racers[r].value;
+    }
+    for (unsigned int i = 0; i < n; i++) {
+        usedItems[i] = racers[r].usedItems[i];
+    }
+    if (winner != nullptr) *winner = racers[r].name;
+
+    string log = logFile;
+    if (log.empty()) {
+        const char* path = getenv("KNAPSACK_PORTFOLIO_LOG");
+        if (path != nullptr) log = path;
+    }
+    if (!log.empty()) appendPortfolioLog(log, features, racers[r].name, winnerSeconds);
+    return racers[r].value;
+}
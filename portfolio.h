@@ -0,0 +1,33 @@
+#include <string>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+/**
+ * @brief Races dynamic programming, branch-and-bound and meet-in-the-middle on separate threads.
+ *
+ * Every solver works on its own copy of the output, the first one to finish with a proven
+ * optimum claims the result and cancels the others through a shared CancellationToken.
+ * DP only joins the race when its table fits the cost model's memory budget, MITM only for
+ * n <= 44. The winner is appended to the portfolio log ("n,maxWeight,profitSum,correlation,
+ * winner,seconds"), from which learnFromPortfolioLog() corrects the cost model. If the outer token
+ * stops the race first, the best solution any racer holds is returned and nothing is logged.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param winner Optional output: cost-model name of the solver that won ("dp", "ilp" or "mitm").
+ * @param logFile Log to append to; if empty, $KNAPSACK_PORTFOLIO_LOG is used when set.
+ * @param cancel Optional token that stops the whole race.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackPortfolio(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight,
+                               bool usedItems[], string* winner = nullptr, const string& logFile = "",
+                               const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+#endif //PORTFOLIO_H
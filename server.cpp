@@ -0,0 +1,421 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "algorithms.h"
+#include "cli.h"
+#include "data_loader.h"
+#include "dataset.h"
+#include "dataset_registry.h"
+#include "json.h"
+#include "server.h"
+#include "shared_instance.h"
+#include "solvers.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+/**
+ * @class Connection
+ * @brief One client: a line reader on its input and a mutex-guarded writer on its output.
+ */
+class Connection {
+public:
+    Connection(int in, int out, bool owned) : in(in), out(out), owned(owned) {}
+    ~Connection() {
+        if (!owned) return;
+        close(in);
+        if (out != in) close(out);
+    }
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    int input() const { return in; }
+
+    /**
+     * @brief Reads the next line, without its newline. Only the connection's reader calls this.
+     * @return False at end of input.
+     */
+    bool readLine(string& line) {
+        while (true) {
+            size_t newline = buffer.find('\n', start);
+            if (newline != string::npos) {
+                line.assign(buffer, start, newline - start);
+                start = newline + 1;
+                return true;
+            }
+            buffer.erase(0, start);
+            start = 0;
+            char chunk[65536];
+            ssize_t got = read(in, chunk, sizeof(chunk));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                if (buffer.empty()) return false;
+                line.swap(buffer);
+                buffer.clear();
+                return true;
+            }
+            buffer.append(chunk, got);
+        }
+    }
+
+    /**
+     * @brief Writes a complete response line; concurrent senders never interleave.
+     */
+    void send(const string& line) {
+        lock_guard<mutex> guard(writeLock);
+        size_t done = 0;
+        while (done < line.size()) {
+            ssize_t wrote = write(out, line.data() + done, line.size() - done);
+            if (wrote < 0 && errno == EINTR) continue;
+            if (wrote <= 0) return;  // the client went away; its remaining responses are dropped
+            done += wrote;
+        }
+    }
+
+private:
+    int in;
+    int out;
+    bool owned;
+    string buffer;
+    size_t start = 0;
+    mutex writeLock;
+};
+
+/**
+ * @brief The request's "id" member as JSON (strings and numbers are echoed, anything else is null).
+ */
+static string idJSON(const JsonValue& id) {
+    if (id.isString()) return jsonQuote(id.asString());
+    if (id.isNumber()) {
+        ostringstream out;
+        out.precision(17);
+        out << id.asNumber();
+        return out.str();
+    }
+    return "null";
+}
+
+static string errorLine(const string& id, const string& message) {
+    return "{\"id\": " + id + ", \"error\": " + jsonQuote(message) + "}\n";
+}
+
+/**
+ * @brief Reads an integer member in [low, INT_MAX]; fractions, NaN and out-of-range values fail.
+ */
+static bool integerMember(const JsonValue& value, double low, int& out) {
+    if (!value.isNumber()) return false;
+    double number = value.asNumber();
+    if (!(number >= low && number <= INT_MAX) || number != floor(number)) return false;
+    out = (int) number;
+    return true;
+}
+
+/**
+ * @class SolverServer
+ * @brief Request dispatch shared by all connections: the thread pool, the dataset cache and the
+ * solution cache.
+ */
+class SolverServer {
+public:
+    explicit SolverServer(const ServerOptions& options)
+        : pool(options.threads), solutions(options.cacheEntries), cacheSolutions(options.cacheEntries > 0) {
+        string error;
+        if (!options.cacheFile.empty() && !solutions.open(options.cacheFile, &error)) {
+            cerr << "Error opening solution cache: " << error << endl;
+        }
+    }
+
+    /**
+     * @brief Reads requests from a connection until its input ends or the server shuts down.
+     */
+    void serve(const shared_ptr<Connection>& connection) {
+        {
+            lock_guard<mutex> guard(connectionsLock);
+            openInputs.insert(connection->input());
+        }
+        string line;
+        while (!stopping.load() && connection->readLine(line)) {
+            if (line.find_first_not_of(" \t\r") == string::npos) continue;
+            handle(line, connection);
+        }
+        lock_guard<mutex> guard(connectionsLock);
+        openInputs.erase(connection->input());
+    }
+
+    /**
+     * @brief Blocks until every queued request has been answered.
+     */
+    void finish() { pool.wait(); }
+
+    /**
+     * @brief Stops the readers of every connection and runs the shutdown hook (closing the listener).
+     */
+    void shutdown() {
+        stopping.store(true);
+        lock_guard<mutex> guard(connectionsLock);
+        for (int fd : openInputs) ::shutdown(fd, SHUT_RD);
+        if (onShutdown) onShutdown();
+    }
+
+    function<void()> onShutdown;
+
+private:
+    void handle(const string& line, const shared_ptr<Connection>& connection);
+    bool solveShared(const string& segment, const SolverInfo& solver, const CliOptions& options, bool expired,
+                     CliResult& result, string& error);
+
+    string statsLine(const string& id) const;
+
+    ThreadPool pool;
+    SolutionCache solutions;
+    bool cacheSolutions;
+    atomic<bool> stopping{false};
+    DatasetRegistry datasets;
+    mutex connectionsLock;
+    set<int> openInputs;
+};
+
+/**
+ * @brief Solves an instance placed in POSIX shared memory by the client.
+ *
+ * The solver reads the segment's weight and profit columns in place and the solution bits,
+ * state and totals are written back into the segment; the response then only carries the
+ * summary (its pallet list stays empty).
+ *
+ * @return False, with error set, if the segment cannot be mapped.
+ */
+bool SolverServer::solveShared(const string& segment, const SolverInfo& solver, const CliOptions& options, bool expired,
+                               CliResult& result, string& error) {
+    SharedInstance instance;
+    if (!instance.open(segment, &error)) return false;
+    unsigned int n = instance.size();
+    if (expired) {
+        result.n = n;
+        result.capacity = instance.capacity();
+        result.status = "expired";
+        instance.writeSolution(nullptr, SharedCancelled, 0);
+        return true;
+    }
+    KnapsackSolution solution;
+    solveColumns(solver, options, KnapsackInstance(instance.weights(), instance.profits(), n, instance.capacity()),
+                 solution, result, cacheSolutions ? &solutions : nullptr);
+    const bool* usedItems = solution.selected.empty() ? nullptr : reinterpret_cast<const bool*>(solution.selected.data());
+    SharedInstanceState state = result.status == "optimal" ? SharedOptimal
+                              : result.status == "feasible" || result.status == "cancelled" ? SharedFeasible
+                              : SharedFailed;
+    result.weight = instance.writeSolution(usedItems, state, result.profit);
+    return true;
+}
+
+/**
+ * @brief Response to a stats request: the solution cache counters.
+ */
+string SolverServer::statsLine(const string& id) const {
+    SolutionCacheStats stats = solutions.stats();
+    ostringstream out;
+    out << "{\"id\": " << id << ", \"solution_cache\": {\"memory_hits\": " << stats.memoryHits
+        << ", \"disk_hits\": " << stats.diskHits << ", \"misses\": " << stats.misses << ", \"stores\": " << stats.stores
+        << ", \"evictions\": " << stats.evictions << ", \"entries\": " << stats.entries << ", \"bytes\": " << stats.bytes
+        << ", \"disk_entries\": " << stats.diskEntries << "}}\n";
+    return out.str();
+}
+
+/**
+ * @brief Validates one request line and queues it on the pool (or answers it directly).
+ */
+void SolverServer::handle(const string& line, const shared_ptr<Connection>& connection) {
+    auto received = chrono::steady_clock::now();
+    JsonValue request;
+    string parseError;
+    if (!JsonValue::parse(line, request, &parseError) || !request.isObject()) {
+        connection->send(errorLine("null", parseError.empty() ? "request must be an object" : parseError));
+        return;
+    }
+    string id = idJSON(request["id"]);
+
+    if (request["op"].isString() && request["op"].asString() == "shutdown") {
+        connection->send("{\"id\": " + id + ", \"shutdown\": true}\n");
+        shutdown();
+        return;
+    }
+    if (request["op"].isString() && request["op"].asString() == "stats") {
+        connection->send(statsLine(id));
+        return;
+    }
+
+    string algorithm = request["algo"].isString() ? request["algo"].asString() : "auto";
+    const SolverInfo* solver = findSolver(algorithm);
+    if (solver == nullptr) {
+        connection->send(errorLine(id, "unknown algorithm: " + algorithm));
+        return;
+    }
+
+    shared_ptr<LoadedDataset> inlineInstance;
+    string palletsFile, truckFile, segment;
+    if (request["shm"].isString()) {
+        segment = request["shm"].asString();
+    } else if (request["pallets"].isArray()) {
+        inlineInstance = make_shared<LoadedDataset>();
+        for (const JsonValue& pallet : request["pallets"].items()) {
+            int weight, profit;
+            int palletId = (int) inlineInstance->pallets.size() + 1;
+            if (!integerMember(pallet["weight"], 0, weight) || !integerMember(pallet["profit"], 0, profit) ||
+                (!pallet["id"].isNull() && !integerMember(pallet["id"], 0, palletId))) {
+                connection->send(errorLine(id, "pallet weight, profit and id must be integers in [0, 2147483647]"));
+                return;
+            }
+            inlineInstance->pallets.emplace_back(palletId, weight, profit);
+        }
+        int capacity;
+        if (!integerMember(request["capacity"], 1, capacity) || inlineInstance->pallets.empty()) {
+            connection->send(errorLine(id, "inline instances need pallets and a positive integer capacity"));
+            return;
+        }
+        inlineInstance->truck = Truck(capacity, inlineInstance->pallets.size());
+    } else if (request["pallets_file"].isString()) {
+        palletsFile = request["pallets_file"].asString();
+        truckFile = request["truck_file"].asString();
+    } else {
+        connection->send(errorLine(id, "request needs \"pallets\", \"pallets_file\" or \"shm\""));
+        return;
+    }
+
+    // Each request may use at most the machine's hardware threads
+    CliOptions options;
+    int threads = 1;
+    if (!request["threads"].isNull() && !integerMember(request["threads"], 1, threads)) {
+        connection->send(errorLine(id, "threads must be an integer in [1, 2147483647]"));
+        return;
+    }
+    options.threads = min<unsigned int>(threads, max(1u, thread::hardware_concurrency()));
+    double deadline = request["deadline_ms"].asNumber(0) / 1000;
+
+    pool.submit([this, connection, id, solver, inlineInstance, palletsFile, truckFile, segment, options, deadline,
+                 received]() {
+        // A failure in one request (a malformed file, a table too large to allocate) must not
+        // take the daemon down
+        try {
+            CliResult result;
+            result.algorithm = solver->name;
+            CliOptions limited = options;
+            double remaining = deadline - chrono::duration<double>(chrono::steady_clock::now() - received).count();
+            if (deadline > 0) limited.timeLimit = max(remaining, 1e-6);
+
+            if (!segment.empty()) {
+                string error;
+                if (!solveShared(segment, *solver, limited, deadline > 0 && remaining <= 0, result, error)) {
+                    connection->send(errorLine(id, error));
+                    return;
+                }
+                connection->send("{\"id\": " + id + ", \"shm\": " + jsonQuote(segment) + ", \"result\": " +
+                                 cliResultJSON(result) + "}\n");
+                return;
+            }
+
+            bool cached = false;
+            shared_ptr<const LoadedDataset> instance = inlineInstance;
+            if (instance == nullptr) instance = datasets.get(palletsFile, truckFile, &cached, &result.loadMillis);
+            if (instance == nullptr) {
+                result.status = "load-error";
+            } else if (deadline > 0 && remaining <= 0) {
+                result.status = "expired";
+            } else {
+                solveLoaded(*solver, limited, *instance, result, cacheSolutions ? &solutions : nullptr);
+            }
+            connection->send("{\"id\": " + id + ", \"cached\": " + (cached ? "true" : "false") +
+                             ", \"result\": " + cliResultJSON(result) + "}\n");
+        } catch (const exception& e) {
+            connection->send(errorLine(id, e.what()));
+        }
+        // Keep the scratch of typical requests for reuse, but not the peak of a huge one
+        releaseSolverScratch(workerScratchBytes);
+    });
+}
+
+/**
+ * @brief Accepts connections on a Unix domain socket, one reader thread per live client.
+ */
+static int serveSocket(SolverServer& server, const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path too long: " << path << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (listener < 0 || bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        cerr << "Error opening socket " << path << ": " << strerror(errno) << endl;
+        if (listener >= 0) close(listener);
+        return 1;
+    }
+    server.onShutdown = [listener]() { ::shutdown(listener, SHUT_RDWR); };
+
+    // Readers whose client has gone are joined on the next accept, so a long-running daemon
+    // only holds threads for its live connections
+    struct Reader {
+        thread worker;
+        shared_ptr<atomic<bool>> done;
+    };
+    list<Reader> readers;
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        readers.remove_if([](Reader& reader) {
+            if (!reader.done->load()) return false;
+            reader.worker.join();
+            return true;
+        });
+        shared_ptr<atomic<bool>> done = make_shared<atomic<bool>>(false);
+        thread worker([&server, client, done]() {
+            server.serve(make_shared<Connection>(client, client, true));
+            done->store(true);
+        });
+        readers.push_back({move(worker), done});
+    }
+    for (Reader& reader : readers) reader.worker.join();
+    server.finish();
+    close(listener);
+    unlink(path.c_str());
+    return 0;
+}
+
+/**
+ * @brief Runs the solver daemon until its input ends or a shutdown request arrives.
+ *
+ * @param options Socket, pool size and solution cache.
+ * @return Process exit status.
+ */
+int runServer(const ServerOptions& options) {
+    // A client hanging up mid-response must not kill the daemon
+    signal(SIGPIPE, SIG_IGN);
+    SolverServer server(options);
+    if (!options.socketPath.empty()) return serveSocket(server, options.socketPath);
+
+    server.serve(make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false));
+    server.finish();
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <string>
+using namespace std;
+
+#ifndef SERVER_H
+#define SERVER_H
+
+/**
+ * @struct ServerOptions
+ * @brief Settings of the solver daemon.
+ */
+struct ServerOptions {
+    string socketPath;          ///< Unix domain socket to listen on; empty serves stdin/stdout
+    unsigned int threads = 0;   ///< Requests solved concurrently (0 = one per hardware thread)
+    string cacheFile;           ///< On-disk solution cache behind the in-memory one (empty = memory only)
+    size_t cacheEntries = 1024; ///< Solutions kept in memory (0 disables the solution cache)
+};
+
+/**
+ * @brief Runs the solver daemon until its input ends or a shutdown request arrives.
+ *
+ * Requests and responses are JSON objects, one per line. A solve request names a dataset, which
+ * is parsed once and kept in memory for later requests (see DatasetRegistry; it is parsed again
+ * when its files change), or carries its pallets inline:
+ *
+ *   {"id": 1, "pallets_file": "../datasets/Pallets_01.csv", "truck_file": "../datasets/TruckAndPallets_01.csv",
+ *    "algo": "dp", "deadline_ms": 500}
+ *   {"id": 2, "capacity": 100, "pallets": [{"id": 1, "weight": 70, "profit": 10}, ...]}
+ *   {"id": 3, "shm": "/knapsack-3"}
+ *
+ * A "shm" request names a POSIX shared memory segment laid out as in shared_instance.h; the
+ * columns are solved in place and the solution is written back into the segment, so only the
+ * summary travels over the connection.
+ *
+ * Optional fields are "algo" (default "auto"), "threads" (per-request solver threads, default 1,
+ * at most the hardware threads)
+ * and "deadline_ms", counted from the moment the request is read, so time spent queued counts.
+ * Requests run on a shared thread pool whose workers keep their solver scratch buffers (up to
+ * workerScratchBytes), and each response is written as soon as it is ready, so responses may
+ * come out of order:
+ *
+ *   {"id": 1, "cached": true, "result": {...}}    (the object cliResultJSON() produces)
+ *   {"id": 3, "shm": "/knapsack-3", "result": {...}}    (pallet list empty, solution in the segment)
+ *   {"id": 4, "error": "unknown algorithm"}
+ *
+ * Solutions are cached by content (see SolutionCache): a repeated instance with the same
+ * algorithm and pallet order is answered from the cache and its result has
+ * "solution_cached": true. {"op": "stats"} returns the cache's hit and miss counters.
+ *
+ * A request whose deadline passed before it started gets status "expired". {"op": "shutdown"}
+ * stops reading new requests (and, on a socket, accepting connections); pending requests finish.
+ *
+ * @param options Socket, pool size and solution cache.
+ * @return Process exit status.
+ */
+int runServer(const ServerOptions& options);
+
+#endif //SERVER_H
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shared_instance.h"
+
+using namespace std;
+
+static_assert(sizeof(SharedInstanceHeader) == 64, "the segment header is part of the shared memory format");
+
+/**
+ * @brief Byte offset of the solution bits (after both columns, 8-byte aligned).
+ */
+static size_t solutionOffset(uint64_t n) {
+    return (sizeof(SharedInstanceHeader) + 2 * n * sizeof(uint32_t) + 7) / 8 * 8;
+}
+
+/**
+ * @brief Bytes a segment holding n pallets needs.
+ */
+size_t sharedInstanceSize(uint64_t n) {
+    return solutionOffset(n) + (n + 63) / 64 * sizeof(uint64_t);
+}
+
+static void setError(string* error, const string& message) {
+    if (error != nullptr) *error = message + ": " + strerror(errno);
+}
+
+/**
+ * @brief Creates (or replaces) a segment and fills in an instance, for clients and tools.
+ *
+ * @param name Segment name, e.g. "/knapsack-42".
+ * @param weights Pallet weights.
+ * @param profits Pallet profits.
+ * @param n Number of pallets.
+ * @param capacity Truck capacity.
+ * @param error Optional output describing a failure.
+ * @return True if the segment was created.
+ */
+bool createSharedInstance(const string& name, const unsigned int weights[], const unsigned int profits[], uint64_t n,
+                          unsigned int capacity, string* error) {
+    int fd = shm_open(name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+    if (fd < 0) {
+        setError(error, "shm_open " + name);
+        return false;
+    }
+    size_t bytes = sharedInstanceSize(n);
+    if (ftruncate(fd, bytes) != 0) {
+        setError(error, "ftruncate " + name);
+        close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        setError(error, "mmap " + name);
+        return false;
+    }
+
+    // ftruncate zero-fills, so the state, result and solution bits start cleared
+    SharedInstanceHeader* header = static_cast<SharedInstanceHeader*>(memory);
+    memcpy(header->magic, "KSHM", 4);
+    header->version = 1;
+    header->n = n;
+    header->capacity = capacity;
+    uint32_t* columns = reinterpret_cast<uint32_t*>(header + 1);
+    memcpy(columns, weights, n * sizeof(uint32_t));
+    memcpy(columns + n, profits, n * sizeof(uint32_t));
+    munmap(memory, bytes);
+    return true;
+}
+
+SharedInstance::~SharedInstance() {
+    if (header != nullptr) munmap(header, mapped);
+}
+
+/**
+ * @brief Maps an existing segment read-write and checks its header and size.
+ *
+ * @param name Segment name.
+ * @param error Optional output describing a failure.
+ * @return True if the segment holds a valid instance.
+ */
+bool SharedInstance::open(const string& name, string* error) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        setError(error, "shm_open " + name);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(SharedInstanceHeader)) {
+        if (error != nullptr) *error = "segment " + name + " is too small";
+        close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        setError(error, "mmap " + name);
+        return false;
+    }
+    header = static_cast<SharedInstanceHeader*>(memory);
+    mapped = info.st_size;
+
+    // Read the header once (volatile, so the load is not repeated): the client may still write to it
+    uint64_t n = *reinterpret_cast<volatile uint64_t*>(&header->n);
+    if (memcmp(header->magic, "KSHM", 4) != 0 || header->version != 1 || n > UINT32_MAX ||
+        sharedInstanceSize(n) > mapped) {
+        if (error != nullptr) *error = "segment " + name + " does not hold a version 1 instance";
+        munmap(header, mapped);
+        header = nullptr;
+        return false;
+    }
+    items = n;
+    truckCapacity = *reinterpret_cast<volatile uint32_t*>(&header->capacity);
+    return true;
+}
+
+uint64_t* SharedInstance::solution() const {
+    return reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(header) + solutionOffset(items));
+}
+
+/**
+ * @brief Writes a solution into the segment.
+ *
+ * @param usedItems Which pallets are loaded (may be nullptr to clear the solution).
+ * @param state Outcome of the solve.
+ * @param profit Profit of the solution.
+ * @return Weight of the solution, also stored in the header.
+ */
+uint64_t SharedInstance::writeSolution(const bool usedItems[], SharedInstanceState state, uint64_t profit) {
+    uint64_t n = items;
+    uint64_t* bits = solution();
+    const unsigned int* weight = weights();
+    uint64_t total = 0;
+    for (uint64_t word = 0; word < (n + 63) / 64; word++) {
+        uint64_t value = 0;
+        for (uint64_t i = word * 64; i < min<uint64_t>(n, word * 64 + 64); i++) {
+            if (usedItems == nullptr || !usedItems[i]) continue;
+            value |= 1ULL << (i % 64);
+            total += weight[i];
+        }
+        bits[word] = value;
+    }
+    header->profit = profit;
+    header->weight = total;
+    header->state = state;
+    return total;
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <string>
+using namespace std;
+
+#ifndef SHARED_INSTANCE_H
+#define SHARED_INSTANCE_H
+
+/**
+ * @enum SharedInstanceState
+ * @brief Outcome the solver writes into a segment's header.
+ */
+enum SharedInstanceState : uint32_t {
+    SharedPending = 0,    ///< Not solved yet
+    SharedOptimal = 1,    ///< Solved, proven optimal
+    SharedFeasible = 2,   ///< Solved heuristically or stopped by the time limit
+    SharedCancelled = 3,  ///< Expired before the solve started; no solution written
+    SharedFailed = 4      ///< Not solved (instance too large for the solver)
+};
+
+/**
+ * @struct SharedInstanceHeader
+ * @brief First 64 bytes of a POSIX shared memory instance.
+ *
+ * Segment layout: this header, u32 weights[n], u32 profits[n], then (8-byte aligned) the
+ * solution as u64 words, bit i of word i / 64 set when pallet i + 1 is loaded. The columns are
+ * in the order of the binary .knap format. The client fills the header's first four fields and
+ * the columns; the solver writes state, profit, weight and the solution bits.
+ */
+struct SharedInstanceHeader {
+    char magic[4];      ///< "KSHM"
+    uint32_t version;   ///< 1
+    uint64_t n;         ///< Number of pallets
+    uint32_t capacity;  ///< Truck capacity
+    uint32_t state;     ///< SharedInstanceState
+    uint64_t profit;    ///< Profit of the solution
+    uint64_t weight;    ///< Weight of the solution
+    uint64_t reserved[3];
+};
+
+/**
+ * @brief Bytes a segment holding n pallets needs.
+ */
+size_t sharedInstanceSize(uint64_t n);
+
+/**
+ * @brief Creates (or replaces) a segment and fills in an instance, for clients and tools.
+ *
+ * @param name Segment name, e.g. "/knapsack-42".
+ * @param weights Pallet weights.
+ * @param profits Pallet profits.
+ * @param n Number of pallets.
+ * @param capacity Truck capacity.
+ * @param error Optional output describing a failure.
+ * @return True if the segment was created.
+ */
+bool createSharedInstance(const string& name, const unsigned int weights[], const unsigned int profits[], uint64_t n,
+                          unsigned int capacity, string* error = nullptr);
+
+/**
+ * @class SharedInstance
+ * @brief A mapped segment: the columns are read in place and the solution is written back.
+ *
+ * The header stays writable by the client, so n and the capacity are copied when the segment is
+ * opened and every offset is computed from those copies, never from the live header.
+ */
+class SharedInstance {
+public:
+    SharedInstance() = default;
+    ~SharedInstance();
+    SharedInstance(const SharedInstance&) = delete;
+    SharedInstance& operator=(const SharedInstance&) = delete;
+
+    /**
+     * @brief Maps an existing segment read-write and checks its header and size.
+     *
+     * @param name Segment name.
+     * @param error Optional output describing a failure.
+     * @return True if the segment holds a valid instance.
+     */
+    bool open(const string& name, string* error = nullptr);
+
+    uint64_t size() const { return items; }
+    unsigned int capacity() const { return truckCapacity; }
+    SharedInstanceState state() const { return (SharedInstanceState) header->state; }
+    uint64_t profit() const { return header->profit; }
+
+    /**
+     * @brief The weight column, in the segment itself.
+     */
+    unsigned int* weights() const { return reinterpret_cast<unsigned int*>(header + 1); }
+
+    /**
+     * @brief The profit column, in the segment itself.
+     */
+    unsigned int* profits() const { return weights() + items; }
+
+    /**
+     * @brief Whether the solution written to the segment loads pallet i (0-based).
+     */
+    bool selected(uint64_t i) const { return (solution()[i / 64] >> (i % 64)) & 1; }
+
+    /**
+     * @brief Writes a solution into the segment.
+     *
+     * @param usedItems Which pallets are loaded (may be nullptr to clear the solution).
+     * @param state Outcome of the solve.
+     * @param profit Profit of the solution.
+     * @return Weight of the solution, also stored in the header.
+     */
+    uint64_t writeSolution(const bool usedItems[], SharedInstanceState state, uint64_t profit);
+
+private:
+    uint64_t* solution() const;
+
+    SharedInstanceHeader* header = nullptr;
+    size_t mapped = 0;
+    uint64_t items = 0;              ///< n as validated by open()
+    unsigned int truckCapacity = 0;  ///< Capacity as read by open()
+};
+
+#endif //SHARED_INSTANCE_H
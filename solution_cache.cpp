@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash.h"
+#include "solution_cache.h"
+
+using namespace std;
+
+// Seed of the second, collision-guarding hash
+static const uint64_t CHECK_SEED = 2870177450012600261ULL;
+
+// Version 1 keyed instances with their items sorted, which does not preserve the tie-break
+static const uint32_t DISK_VERSION = 2;
+
+template<typename T>
+static void append(string& bytes, T value) {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Computes the cache key of a solve.
+ *
+ * @param solver Solver that will run.
+ * @param options Its settings.
+ * @param instance Instance to solve.
+ * @return The key.
+ */
+SolutionKey solutionKey(const Solver& solver, const KnapsackOptions& options, const KnapsackInstance& instance) {
+    SolutionKey key;
+    key.exact = solver.exact();
+
+    string bytes = solver.name();
+    bytes.push_back('\0');
+    if (!key.exact) {
+        append<uint32_t>(bytes, options.threads);
+        append<double>(bytes, options.timeLimit);
+    }
+    append<uint32_t>(bytes, instance.capacity);
+    append<uint32_t>(bytes, instance.n);
+    bytes.reserve(bytes.size() + 8 * (size_t) instance.n);
+    for (unsigned int i = 0; i < instance.n; i++) {
+        append<uint32_t>(bytes, instance.weights[i]);
+        append<uint32_t>(bytes, instance.profits[i]);
+    }
+    key.hash = xxHash64(bytes.data(), bytes.size(), 0);
+    key.check = xxHash64(bytes.data(), bytes.size(), CHECK_SEED);
+    // Key 0 marks an empty slot of the disk table
+    if (key.hash == 0) key.hash = 1;
+    return key;
+}
+
+/**
+ * @struct DiskHeader
+ * @brief First 64 bytes of the cache file.
+ */
+struct DiskHeader {
+    char magic[4];          ///< "KSCA"
+    uint32_t version;       ///< DISK_VERSION
+    uint64_t slots;         ///< Slot count, a power of two
+    uint64_t used;          ///< Filled slots
+    uint64_t dataUsed;      ///< Bytes of records written
+    uint64_t dataCapacity;  ///< Bytes reserved for records
+    uint64_t reserved[3];
+};
+
+/**
+ * @struct DiskSlot
+ * @brief Hash table slot; key 0 is empty, and key is written last so readers never see a partial slot.
+ */
+struct DiskSlot {
+    uint64_t key;
+    uint64_t check;
+    uint64_t offset;  ///< File offset of the record
+};
+
+/**
+ * @struct DiskRecord
+ * @brief A stored solution, followed by its (n + 63) / 64 bit words.
+ */
+struct DiskRecord {
+    uint32_t n;
+    uint32_t status;
+    uint64_t profit;
+    uint64_t weight;
+};
+
+static_assert(sizeof(DiskHeader) == 64, "the cache header is part of the file format");
+
+static const uint64_t INITIAL_SLOTS = 1024;
+static const uint64_t INITIAL_DATA = 256 << 10;
+
+static uint64_t fileBytes(uint64_t slots, uint64_t dataCapacity) {
+    return sizeof(DiskHeader) + slots * sizeof(DiskSlot) + dataCapacity;
+}
+
+static uint64_t recordBytes(uint64_t n) {
+    return sizeof(DiskRecord) + (n + 63) / 64 * sizeof(uint64_t);
+}
+
+static void setError(string* error, const string& message) {
+    if (error != nullptr) *error = message + ": " + strerror(errno);
+}
+
+/**
+ * @brief Creates an empty table in a zero-length file.
+ */
+static bool initialize(int fd, uint64_t slots, uint64_t dataCapacity) {
+    if (ftruncate(fd, fileBytes(slots, dataCapacity)) != 0) return false;
+    DiskHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "KSCA", 4);
+    header.version = DISK_VERSION;
+    header.slots = slots;
+    header.dataCapacity = dataCapacity;
+    return pwrite(fd, &header, sizeof(header), 0) == (ssize_t) sizeof(header);
+}
+
+SolutionCache::~SolutionCache() {
+    unmapFile();
+}
+
+/**
+ * @brief Backs the cache with a file, creating it if needed.
+ *
+ * @param file File of the on-disk table.
+ * @param error Optional output describing a failure.
+ * @return True if the table is usable.
+ */
+bool SolutionCache::open(const string& file, string* error) {
+    lock_guard<mutex> guard(lock);
+    unmapFile();
+    path = file;
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        setError(error, "open " + path);
+        return false;
+    }
+    flock(fd, LOCK_EX);
+    struct stat info;
+    bool ready = fstat(fd, &info) == 0 && (info.st_size > 0 || initialize(fd, INITIAL_SLOTS, INITIAL_DATA));
+    flock(fd, LOCK_UN);
+    if (!ready) {
+        setError(error, "initialize " + path);
+        unmapFile();
+        return false;
+    }
+    if (!mapFile(error)) {
+        unmapFile();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps the open file and checks its header.
+ */
+bool SolutionCache::mapFile(string* error) {
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        setError(error, "stat " + path);
+        return false;
+    }
+    if ((size_t) info.st_size < sizeof(DiskHeader)) {
+        if (error != nullptr) *error = path + " is not a solution cache";
+        return false;
+    }
+    void* memory = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        setError(error, "mmap " + path);
+        return false;
+    }
+    mapped = static_cast<char*>(memory);
+    mappedBytes = info.st_size;
+    const DiskHeader* header = reinterpret_cast<const DiskHeader*>(mapped);
+    if (memcmp(header->magic, "KSCA", 4) != 0 || header->version != DISK_VERSION || header->slots == 0 ||
+        (header->slots & (header->slots - 1)) != 0 || fileBytes(header->slots, header->dataCapacity) != mappedBytes) {
+        if (error != nullptr) *error = path + " is not a version " + to_string(DISK_VERSION) + " solution cache";
+        return false;
+    }
+    return true;
+}
+
+void SolutionCache::unmapFile() {
+    if (mapped != nullptr) munmap(mapped, mappedBytes);
+    if (fd >= 0) close(fd);
+    mapped = nullptr;
+    mappedBytes = 0;
+    fd = -1;
+}
+
+/**
+ * @brief Whether another process has replaced the file (grown the table) since it was opened.
+ */
+bool SolutionCache::replaced() const {
+    struct stat current, opened;
+    if (stat(path.c_str(), &current) != 0 || fstat(fd, &opened) != 0) return false;
+    return current.st_ino != opened.st_ino || current.st_dev != opened.st_dev;
+}
+
+/**
+ * @brief Finds a solution in the disk table.
+ */
+bool SolutionCache::diskFind(uint64_t hash, uint64_t check, Entry& entry) const {
+    const DiskHeader* header = reinterpret_cast<const DiskHeader*>(mapped);
+    DiskSlot* slots = reinterpret_cast<DiskSlot*>(mapped + sizeof(DiskHeader));
+    uint64_t mask = header->slots - 1;
+    for (uint64_t probe = 0; probe <= mask; probe++) {
+        DiskSlot& slot = slots[(hash + probe) & mask];
+        uint64_t key = atomic_ref<uint64_t>(slot.key).load(memory_order_acquire);
+        if (key == 0) return false;
+        if (key != hash || slot.check != check) continue;
+        if (slot.offset + sizeof(DiskRecord) > mappedBytes) return false;
+        const DiskRecord* record = reinterpret_cast<const DiskRecord*>(mapped + slot.offset);
+        if (slot.offset + recordBytes(record->n) > mappedBytes) return false;
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(record + 1);
+        entry.hash = hash;
+        entry.check = check;
+        entry.n = record->n;
+        entry.status = (SolveStatus) record->status;
+        entry.profit = record->profit;
+        entry.weight = record->weight;
+        entry.bits.assign(words, words + (record->n + 63) / 64);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Rewrites the table with more slots or record space under a new inode, then maps it.
+ *
+ * Called with the file locked; the new file is locked before it becomes visible.
+ */
+bool SolutionCache::grow(uint64_t slotCount, uint64_t dataCapacity) {
+    string temporary = path + ".tmp";
+    int grown = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (grown < 0) return false;
+    flock(grown, LOCK_EX);
+    void* memory = MAP_FAILED;
+    if (initialize(grown, slotCount, dataCapacity)) {
+        memory = mmap(nullptr, fileBytes(slotCount, dataCapacity), PROT_READ | PROT_WRITE, MAP_SHARED, grown, 0);
+    }
+    if (memory == MAP_FAILED) {
+        close(grown);
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    char* target = static_cast<char*>(memory);
+    DiskHeader* header = reinterpret_cast<DiskHeader*>(target);
+    DiskSlot* slots = reinterpret_cast<DiskSlot*>(target + sizeof(DiskHeader));
+    uint64_t dataStart = sizeof(DiskHeader) + slotCount * sizeof(DiskSlot);
+    const DiskHeader* old = reinterpret_cast<const DiskHeader*>(mapped);
+    const DiskSlot* oldSlots = reinterpret_cast<const DiskSlot*>(mapped + sizeof(DiskHeader));
+    for (uint64_t s = 0; s < old->slots; s++) {
+        if (oldSlots[s].key == 0) continue;
+        const DiskRecord* record = reinterpret_cast<const DiskRecord*>(mapped + oldSlots[s].offset);
+        uint64_t bytes = recordBytes(record->n);
+        uint64_t offset = dataStart + header->dataUsed;
+        memcpy(target + offset, record, bytes);
+        header->dataUsed += bytes;
+        uint64_t position = oldSlots[s].key & (slotCount - 1);
+        while (slots[position].key != 0) position = (position + 1) & (slotCount - 1);
+        slots[position] = {oldSlots[s].key, oldSlots[s].check, offset};
+        header->used++;
+    }
+
+    rename(temporary.c_str(), path.c_str());
+    unmapFile();
+    fd = grown;
+    mapped = target;
+    mappedBytes = fileBytes(slotCount, dataCapacity);
+    return true;
+}
+
+/**
+ * @brief Appends a solution to the disk table under the file lock.
+ */
+void SolutionCache::diskInsert(const Entry& entry) {
+    // Lock the current file; if another process replaced it meanwhile, switch to the new one
+    while (true) {
+        flock(fd, LOCK_EX);
+        if (!replaced()) break;
+        flock(fd, LOCK_UN);
+        unmapFile();
+        fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0 || !mapFile(nullptr)) {
+            unmapFile();
+            return;
+        }
+    }
+
+    Entry existing;
+    if (!diskFind(entry.hash, entry.check, existing)) {
+        const DiskHeader* header = reinterpret_cast<const DiskHeader*>(mapped);
+        uint64_t bytes = recordBytes(entry.n);
+        uint64_t slotCount = header->slots;
+        uint64_t dataCapacity = header->dataCapacity;
+        if ((header->used + 1) * 4 > slotCount * 3) slotCount *= 2;
+        if (header->dataUsed + bytes > dataCapacity) dataCapacity = max(dataCapacity * 2, header->dataUsed + bytes);
+        bool fits = slotCount == header->slots && dataCapacity == header->dataCapacity;
+        if (fits || grow(slotCount, dataCapacity)) {
+            DiskHeader* target = reinterpret_cast<DiskHeader*>(mapped);
+            DiskSlot* slots = reinterpret_cast<DiskSlot*>(mapped + sizeof(DiskHeader));
+            uint64_t offset = sizeof(DiskHeader) + target->slots * sizeof(DiskSlot) + target->dataUsed;
+            DiskRecord record = {entry.n, (uint32_t) entry.status, entry.profit, entry.weight};
+            memcpy(mapped + offset, &record, sizeof(record));
+            memcpy(mapped + offset + sizeof(record), entry.bits.data(), entry.bits.size() * sizeof(uint64_t));
+            target->dataUsed += bytes;
+
+            uint64_t mask = target->slots - 1;
+            uint64_t position = entry.hash & mask;
+            while (slots[position].key != 0) position = (position + 1) & mask;
+            slots[position].check = entry.check;
+            slots[position].offset = offset;
+            atomic_ref<uint64_t>(slots[position].key).store(entry.hash, memory_order_release);
+            target->used++;
+        }
+    }
+    flock(fd, LOCK_UN);
+}
+
+/**
+ * @brief Copies a stored solution out, rejecting it unless its recomputed totals match (so a
+ * key collision cannot return a wrong solution).
+ */
+bool SolutionCache::restore(const Entry& entry, const KnapsackInstance& instance, KnapsackSolution& solution) const {
+    if (entry.n != instance.n) return false;
+    solution.selected.assign(instance.n, 0);
+    unsigned long long profit = 0, weight = 0;
+    for (unsigned int k = 0; k < instance.n; k++) {
+        if (!((entry.bits[k / 64] >> (k % 64)) & 1)) continue;
+        solution.selected[k] = 1;
+        profit += instance.profits[k];
+        weight += instance.weights[k];
+    }
+    if (profit != entry.profit || weight != entry.weight || weight > instance.capacity) return false;
+    solution.profit = entry.profit;
+    solution.weight = entry.weight;
+    solution.status = entry.status;
+    return true;
+}
+
+/**
+ * @brief Puts an entry at the front of the LRU and evicts down to the limits.
+ */
+void SolutionCache::remember(Entry entry) {
+    auto found = index.find(entry.hash);
+    if (found != index.end()) {
+        memoryBytes -= sizeof(Entry) + found->second->bits.size() * sizeof(uint64_t);
+        recent.erase(found->second);
+        index.erase(found);
+    }
+    memoryBytes += sizeof(Entry) + entry.bits.size() * sizeof(uint64_t);
+    uint64_t hash = entry.hash;
+    recent.push_front(move(entry));
+    index[hash] = recent.begin();
+    while (!recent.empty() && (recent.size() > maxEntries || memoryBytes > maxBytes)) {
+        memoryBytes -= sizeof(Entry) + recent.back().bits.size() * sizeof(uint64_t);
+        index.erase(recent.back().hash);
+        recent.pop_back();
+        counters.evictions++;
+    }
+}
+
+/**
+ * @brief Looks a solve up, first in memory and then on disk (promoting disk hits to memory).
+ *
+ * @param key Key from solutionKey().
+ * @param instance The instance the key was computed for.
+ * @param solution Output solution, in the instance's item order.
+ * @return True on a hit.
+ */
+bool SolutionCache::lookup(const SolutionKey& key, const KnapsackInstance& instance, KnapsackSolution& solution) {
+    lock_guard<mutex> guard(lock);
+    auto found = index.find(key.hash);
+    if (found != index.end() && found->second->check == key.check && restore(*found->second, instance, solution)) {
+        recent.splice(recent.begin(), recent, found->second);
+        counters.memoryHits++;
+        return true;
+    }
+
+    if (mapped != nullptr) {
+        Entry entry;
+        bool hit = diskFind(key.hash, key.check, entry);
+        if (!hit && replaced()) {
+            unmapFile();
+            fd = ::open(path.c_str(), O_RDWR);
+            if (fd >= 0 && mapFile(nullptr)) hit = diskFind(key.hash, key.check, entry);
+            else unmapFile();
+        }
+        if (hit && restore(entry, instance, solution)) {
+            remember(move(entry));
+            counters.diskHits++;
+            return true;
+        }
+    }
+    counters.misses++;
+    return false;
+}
+
+/**
+ * @brief Remembers a solution. Cancelled runs, and non-optimal runs of exact solvers, are skipped.
+ *
+ * @param key Key from solutionKey().
+ * @param instance The instance the key was computed for.
+ * @param solution Solution to store.
+ */
+void SolutionCache::store(const SolutionKey& key, const KnapsackInstance& instance, const KnapsackSolution& solution) {
+    if (solution.status == SolveStatus::Cancelled || (key.exact && solution.status != SolveStatus::Optimal)) return;
+    if (solution.selected.size() != instance.n) return;
+    Entry entry;
+    entry.hash = key.hash;
+    entry.check = key.check;
+    entry.n = instance.n;
+    entry.status = solution.status;
+    entry.profit = solution.profit;
+    entry.weight = solution.weight;
+    entry.bits.assign(((size_t) instance.n + 63) / 64, 0);
+    for (unsigned int k = 0; k < instance.n; k++) {
+        if (solution.selected[k]) entry.bits[k / 64] |= 1ULL << (k % 64);
+    }
+
+    lock_guard<mutex> guard(lock);
+    if (mapped != nullptr) diskInsert(entry);
+    remember(move(entry));
+    counters.stores++;
+}
+
+SolutionCacheStats SolutionCache::stats() const {
+    lock_guard<mutex> guard(lock);
+    SolutionCacheStats result = counters;
+    result.entries = recent.size();
+    result.bytes = memoryBytes;
+    if (mapped != nullptr) result.diskEntries = reinterpret_cast<const DiskHeader*>(mapped)->used;
+    return result;
+}
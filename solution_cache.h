@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "knapsack.h"
+using namespace std;
+
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+/**
+ * @struct SolutionKey
+ * @brief Content address of a solve: hashes of the instance and the solver settings.
+ *
+ * The items are hashed in the caller's order: the canonical tie-break (most profit, then fewest
+ * pallets, then lowest index sum) depends on it, so the same manifest in another order is a
+ * different solve and must not share its answer.
+ */
+struct SolutionKey {
+    uint64_t hash = 0;             ///< xxHash64 of the key bytes, the table key
+    uint64_t check = 0;            ///< Second hash (other seed) that guards against key collisions
+    bool exact = false;            ///< Only optimal solutions of exact solvers are stored
+};
+
+/**
+ * @brief Computes the cache key of a solve.
+ *
+ * An optimal solution does not depend on the thread count or time limit, so they are part of
+ * the key only for heuristic solvers.
+ *
+ * @param solver Solver that will run.
+ * @param options Its settings.
+ * @param instance Instance to solve.
+ * @return The key.
+ */
+SolutionKey solutionKey(const Solver& solver, const KnapsackOptions& options, const KnapsackInstance& instance);
+
+/**
+ * @struct SolutionCacheStats
+ * @brief Counters of a solution cache.
+ */
+struct SolutionCacheStats {
+    uint64_t memoryHits = 0;  ///< Lookups answered by the in-memory LRU
+    uint64_t diskHits = 0;    ///< Lookups answered by the on-disk table
+    uint64_t misses = 0;      ///< Lookups answered by neither
+    uint64_t stores = 0;      ///< Solutions added
+    uint64_t evictions = 0;   ///< Entries dropped from the LRU to respect its limits
+    uint64_t entries = 0;     ///< Entries in the LRU
+    uint64_t bytes = 0;       ///< Approximate memory held by the LRU
+    uint64_t diskEntries = 0; ///< Entries in the on-disk table
+};
+
+/**
+ * @class SolutionCache
+ * @brief Solutions by content address: an in-memory LRU in front of an optional on-disk table.
+ *
+ * The disk file is a memory-mapped open-addressing hash table (64-byte header, then
+ * {key, check, offset} slots, then the solution records) in host byte order. Writers take an
+ * exclusive flock and grow the table by rewriting it under a new inode, so several processes may
+ * share one file; readers pick up a replaced file on their next miss. Thread-safe.
+ */
+class SolutionCache {
+public:
+    /**
+     * @param maxEntries Most solutions kept in memory.
+     * @param maxBytes Most bytes of solutions kept in memory.
+     */
+    explicit SolutionCache(size_t maxEntries = 1024, size_t maxBytes = 64 << 20)
+        : maxEntries(maxEntries), maxBytes(maxBytes) {}
+    ~SolutionCache();
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    /**
+     * @brief Backs the cache with a file, creating it if needed.
+     *
+     * @param path File of the on-disk table.
+     * @param error Optional output describing a failure.
+     * @return True if the table is usable.
+     */
+    bool open(const string& path, string* error = nullptr);
+
+    /**
+     * @brief Looks a solve up, first in memory and then on disk (promoting disk hits to memory).
+     *
+     * @param key Key from solutionKey().
+     * @param instance The instance the key was computed for.
+     * @param solution Output solution, in the instance's item order.
+     * @return True on a hit.
+     */
+    bool lookup(const SolutionKey& key, const KnapsackInstance& instance, KnapsackSolution& solution);
+
+    /**
+     * @brief Remembers a solution. Cancelled runs, and non-optimal runs of exact solvers, are skipped.
+     *
+     * @param key Key from solutionKey().
+     * @param instance The instance the key was computed for.
+     * @param solution Solution to store.
+     */
+    void store(const SolutionKey& key, const KnapsackInstance& instance, const KnapsackSolution& solution);
+
+    SolutionCacheStats stats() const;
+
+private:
+    /**
+     * @brief A solution, in the instance's item order.
+     */
+    struct Entry {
+        uint64_t hash = 0;
+        uint64_t check = 0;
+        unsigned int n = 0;
+        SolveStatus status = SolveStatus::Feasible;
+        unsigned int profit = 0;
+        unsigned long long weight = 0;
+        vector<uint64_t> bits;   ///< Bit k set if item k is chosen
+    };
+
+    bool restore(const Entry& entry, const KnapsackInstance& instance, KnapsackSolution& solution) const;
+    void remember(Entry entry);
+    bool diskFind(uint64_t hash, uint64_t check, Entry& entry) const;
+    void diskInsert(const Entry& entry);
+    bool mapFile(string* error);
+    void unmapFile();
+    bool replaced() const;
+    bool grow(uint64_t slots, uint64_t dataCapacity);
+
+    size_t maxEntries;
+    size_t maxBytes;
+    mutable mutex lock;
+    list<Entry> recent;   ///< Most recently used first
+    unordered_map<uint64_t, list<Entry>::iterator> index;
+    size_t memoryBytes = 0;
+    SolutionCacheStats counters;
+
+    string path;
+    int fd = -1;
+    char* mapped = nullptr;
+    size_t mappedBytes = 0;
+};
+
+#endif //SOLUTION_CACHE_H
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include "solver_select.h"
+#include "solvers.h"
+
+using namespace std;
+
+/**
+ * @brief Computes the features of an instance in one pass.
+ *
+ * Items heavier than the capacity are ignored, since no solver can use them.
+ */
+InstanceFeatures computeFeatures(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight) {
+    InstanceFeatures features;
+    features.n = n;
+    features.maxWeight = maxWeight;
+    double sw = 0, sp = 0, sww = 0, spp = 0, swp = 0;
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (weights[i] > maxWeight) continue;
+        features.profitSum += values[i];
+        features.weightSum += weights[i];
+        double w = weights[i], p = values[i];
+        sw += w; sp += p; sww += w * w; spp += p * p; swp += w * p;
+        count++;
+    }
+    if (count > 1) {
+        double cov = swp - sw * sp / count;
+        double varW = sww - sw * sw / count;
+        double varP = spp - sp * sp / count;
+        features.correlation = (varW > 0 && varP > 0) ? cov / sqrt(varW * varP) : 1.0;
+    }
+    return features;
+}
+
+/**
+ * @brief Units of work and bytes of every exact method, before multiplying by the calibrated costs.
+ *
+ * Sparse DP and branch-and-bound depend on how many states/nodes survive, which grows with the
+ * weight-profit correlation: uncorrelated instances keep few Pareto states and prune well,
+ * strongly correlated ones approach the dense table and exponential search.
+ */
+struct WorkEstimate {
+    string solver;
+    double units;
+    double bytes;
+    bool applicable;
+};
+
+static vector<WorkEstimate> estimateWork(const InstanceFeatures& f) {
+    double n = f.n;
+    double capacity = (double) f.maxWeight + 1;
+    double profits = (double) f.profitSum + 1;
+    double corr = max(0.0, f.correlation);
+    vector<WorkEstimate> work;
+
+    work.push_back({"bf", f.n <= 30 ? n * pow(2.0, n) : INFINITY, n, f.n <= 25});
+
+    double mitmEntries = pow(2.0, floor(n / 2)) + pow(2.0, ceil(n / 2));
+    work.push_back({"mitm", f.n <= 62 ? mitmEntries * log2(mitmEntries + 1) : INFINITY, 40 * mitmEntries, f.n <= 44});
+
+    double denseCells = n * capacity;
+    work.push_back({"dp", denseCells, 12 * denseCells, true});
+
+    double profitCells = n * profits;
+    work.push_back({"dp-profit", profitCells, 8 * profits + profitCells / 8, true});
+
+    double stageLimit = min(capacity, profits) * (0.02 + 0.98 * pow(corr, 4));
+    double states = 0;
+    for (unsigned int k = 1; k <= f.n; k++) {
+        states += k < 60 ? min(pow(2.0, k), stageLimit) : stageLimit;
+    }
+    work.push_back({"dp-sparse", states, 40 * states, true});
+
+    double nodes = n * n * pow(2.0, min(60.0, n * pow(corr, 8) / 8));
+    work.push_back({"ilp", nodes, 64 * n, true});
+    return work;
+}
+
+/**
+ * @brief Calibrated cost per unit of work of a solver.
+ */
+static double unitCost(const CostModel& model, const string& solver) {
+    if (solver == "bf") return model.nsPerSubset;
+    if (solver == "mitm") return model.nsPerMitmEntry;
+    if (solver == "dp") return model.nsPerDenseCell;
+    if (solver == "dp-profit") return model.nsPerProfitCell;
+    if (solver == "dp-sparse") return model.nsPerSparseState;
+    return model.nsPerBnBNode;
+}
+
+/**
+ * @brief Field of the model holding the cost per unit of work of a solver, or nullptr.
+ */
+static double* unitCostField(CostModel& model, const string& solver) {
+    if (solver == "bf") return &model.nsPerSubset;
+    if (solver == "mitm") return &model.nsPerMitmEntry;
+    if (solver == "dp") return &model.nsPerDenseCell;
+    if (solver == "dp-profit") return &model.nsPerProfitCell;
+    if (solver == "dp-sparse") return &model.nsPerSparseState;
+    if (solver == "ilp") return &model.nsPerBnBNode;
+    return nullptr;
+}
+
+/**
+ * @brief Estimates time and memory of brute force, meet-in-the-middle, dense DP, profit DP,
+ * sparse DP and branch-and-bound.
+ *
+ * @param features Instance features.
+ * @param model Calibrated cost model.
+ * @return One estimate per method.
+ */
+vector<CostEstimate> estimateCosts(const InstanceFeatures& features, const CostModel& model) {
+    vector<CostEstimate> estimates;
+    for (const WorkEstimate& w : estimateWork(features)) {
+        double seconds = w.units * unitCost(model, w.solver) * 1e-9;
+        bool applicable = w.applicable && isfinite(seconds) && w.bytes <= model.memoryLimit;
+        estimates.push_back({w.solver, seconds, w.bytes, applicable});
+    }
+    return estimates;
+}
+
+/**
+ * @brief Name of the cheapest applicable exact solver.
+ *
+ * Falls back to branch-and-bound, which needs little memory and is always applicable.
+ *
+ * @param features Instance features.
+ * @param model Calibrated cost model.
+ * @return Registry name of the selected solver.
+ */
+string selectSolver(const InstanceFeatures& features, const CostModel& model) {
+    string best = "ilp";
+    double bestSeconds = INFINITY;
+    for (const CostEstimate& estimate : estimateCosts(features, model)) {
+        if (estimate.applicable && estimate.seconds < bestSeconds) {
+            bestSeconds = estimate.seconds;
+            best = estimate.solver;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Times every exact method on generated instances and fits the per-unit costs.
+ *
+ * Each method is run on a few random instances sized to take a few milliseconds; its cost per
+ * unit is the median of measured time / estimated units, so the calibration also absorbs the
+ * bias of the work estimates on this machine.
+ *
+ * @param seed Seed of the instance generator.
+ * @return The calibrated model.
+ */
+CostModel calibrateCostModel(unsigned int seed) {
+    struct Probe {
+        string solver;
+        unsigned int n;
+        unsigned int maxWeight;
+        unsigned int maxProfit;
+        double* cost;
+    };
+    CostModel model;
+    vector<Probe> probes = {
+        {"bf", 16, 400, 100, &model.nsPerSubset},
+        {"mitm", 34, 800, 100, &model.nsPerMitmEntry},
+        {"dp", 200, 20000, 100, &model.nsPerDenseCell},
+        {"dp-profit", 200, 20000, 100, &model.nsPerProfitCell},
+        {"dp-sparse", 200, 20000, 1000, &model.nsPerSparseState},
+        {"ilp", 2000, 200000, 1000, &model.nsPerBnBNode},
+    };
+
+    mt19937 rng(seed);
+    for (const Probe& probe : probes) {
+        const SolverInfo* solver = findSolver(probe.solver);
+        vector<double> samples;
+        for (int run = 0; run < 5; run++) {
+            vector<unsigned int> values(probe.n), weights(probe.n);
+            for (unsigned int i = 0; i < probe.n; i++) {
+                weights[i] = 1 + rng() % (2 * probe.maxWeight / probe.n * 2 + 1);
+                values[i] = 1 + rng() % probe.maxProfit;
+            }
+            vector<char> used(probe.n);
+            auto start = chrono::steady_clock::now();
+            solver->solve(values.data(), weights.data(), probe.n, probe.maxWeight, reinterpret_cast<bool*>(used.data()));
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+            InstanceFeatures features = computeFeatures(values.data(), weights.data(), probe.n, probe.maxWeight);
+            for (const WorkEstimate& w : estimateWork(features)) {
+                if (w.solver == probe.solver && w.units > 0) samples.push_back(ns / w.units);
+            }
+        }
+        sort(samples.begin(), samples.end());
+        if (!samples.empty()) *probe.cost = samples[samples.size() / 2];
+    }
+    return model;
+}
+
+/**
+ * @brief Loads a cost model from a "key,value" CSV file.
+ *
+ * Unknown keys are ignored, missing keys keep their current value.
+ *
+ * @return True on success.
+ */
+bool loadCostModel(const string& filename, CostModel& model) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string key, value;
+        getline(ss, key, ',');
+        getline(ss, value, ',');
+        if (value.empty()) continue;
+        double v = strtod(value.c_str(), nullptr);
+        if (key == "nsPerSubset") model.nsPerSubset = v;
+        else if (key == "nsPerMitmEntry") model.nsPerMitmEntry = v;
+        else if (key == "nsPerDenseCell") model.nsPerDenseCell = v;
+        else if (key == "nsPerProfitCell") model.nsPerProfitCell = v;
+        else if (key == "nsPerSparseState") model.nsPerSparseState = v;
+        else if (key == "nsPerBnBNode") model.nsPerBnBNode = v;
+        else if (key == "memoryLimit") model.memoryLimit = v;
+    }
+    return true;
+}
+
+/**
+ * @brief Saves a cost model as a "key,value" CSV file.
+ *
+ * @return True on success.
+ */
+bool saveCostModel(const string& filename, const CostModel& model) {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "key,value\n"
+         << "nsPerSubset," << model.nsPerSubset << "\n"
+         << "nsPerMitmEntry," << model.nsPerMitmEntry << "\n"
+         << "nsPerDenseCell," << model.nsPerDenseCell << "\n"
+         << "nsPerProfitCell," << model.nsPerProfitCell << "\n"
+         << "nsPerSparseState," << model.nsPerSparseState << "\n"
+         << "nsPerBnBNode," << model.nsPerBnBNode << "\n"
+         << "memoryLimit," << model.memoryLimit << "\n";
+    return true;
+}
+
+/**
+ * @brief Corrects a cost model with the outcomes of portfolio races.
+ *
+ * Every line ("n,maxWeight,profitSum,correlation,winner,seconds") gives the real time of the
+ * winner, so its unit cost moves a quarter of the way (in log scale) towards the observed one.
+ * The losers were still running at that time, so any loser predicted to be faster than that is
+ * known to be underestimated and is moved up the same way. Races shorter than 1 ms are
+ * dominated by thread start-up and are skipped.
+ *
+ * @param filename Portfolio log.
+ * @param model Model to update in place.
+ * @return Number of log lines applied, or -1 if the file cannot be opened.
+ */
+int learnFromPortfolioLog(const string& filename, CostModel& model) {
+    ifstream file(filename);
+    if (!file.is_open()) return -1;
+    const double rate = 0.25;
+    auto update = [&](const string& solver, double observed, double units) {
+        double* cost = unitCostField(model, solver);
+        if (cost == nullptr || units <= 0 || !isfinite(units)) return;
+        double predicted = units * *cost * 1e-9;
+        double ratio = min(1e3, max(1e-3, observed / predicted));
+        *cost *= pow(ratio, rate);
+    };
+
+    int applied = 0;
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string field[6];
+        for (string& f : field) {
+            getline(ss, f, ',');
+        }
+        if (field[5].empty()) continue;
+        InstanceFeatures features;
+        features.n = strtoul(field[0].c_str(), nullptr, 10);
+        features.maxWeight = strtoul(field[1].c_str(), nullptr, 10);
+        features.profitSum = strtoull(field[2].c_str(), nullptr, 10);
+        features.correlation = strtod(field[3].c_str(), nullptr);
+        const string& winner = field[4];
+        double seconds = strtod(field[5].c_str(), nullptr);
+        if (seconds < 1e-3) continue;
+
+        vector<WorkEstimate> work = estimateWork(features);
+        for (const WorkEstimate& w : work) {
+            if (w.solver == winner) update(w.solver, seconds, w.units);
+        }
+        for (const WorkEstimate& w : work) {
+            bool raced = w.solver == "dp" || w.solver == "ilp" || (w.solver == "mitm" && w.applicable);
+            if (w.solver == winner || !raced) continue;
+            if (w.units * unitCost(model, w.solver) * 1e-9 < seconds) update(w.solver, seconds, w.units);
+        }
+        applied++;
+    }
+    return applied;
+}
+
+/**
+ * @brief The model used by knapsackAuto.
+ *
+ * Starts from the built-in defaults, overridden by the file named in $KNAPSACK_COST_MODEL
+ * (as written by --calibrate) when that variable is set, then corrected with the races
+ * recorded in $KNAPSACK_PORTFOLIO_LOG when that one is set.
+ */
+CostModel& activeCostModel() {
+    static CostModel model = []() {
+        CostModel m;
+        const char* path = getenv("KNAPSACK_COST_MODEL");
+        if (path != nullptr) loadCostModel(path, m);
+        const char* log = getenv("KNAPSACK_PORTFOLIO_LOG");
+        if (log != nullptr) learnFromPortfolioLog(log, m);
+        return m;
+    }();
+    return model;
+}
+
+/**
+ * @brief Solves the instance with the exact method the cost model predicts to be cheapest.
+ *
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token, passed on to the chosen solver.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackAuto(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                          const CancellationToken* cancel, SolveStatus* status) {
+    InstanceFeatures features = computeFeatures(values, weights, n, maxWeight);
+    const SolverInfo* solver = findSolver(selectSolver(features, activeCostModel()));
+    return solver->solveCancellable(values, weights, n, maxWeight, usedItems, cancel, status);
+}
@@ -0,0 +1,109 @@
+#include <string>
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef SOLVER_SELECT_H
+#define SOLVER_SELECT_H
+
+/**
+ * @struct InstanceFeatures
+ * @brief Instance statistics the cost model is driven by.
+ */
+struct InstanceFeatures {
+    unsigned int n = 0;                  ///< Number of items
+    unsigned int maxWeight = 0;          ///< Capacity
+    unsigned long long profitSum = 0;    ///< Total profit of the items that fit on their own
+    unsigned long long weightSum = 0;    ///< Total weight of the items that fit on their own
+    double correlation = 0.0;            ///< Pearson correlation between weights and profits
+};
+
+/**
+ * @struct CostModel
+ * @brief Calibrated nanoseconds per unit of work of every exact method, plus a memory budget.
+ */
+struct CostModel {
+    double nsPerSubset = 2.0;        ///< Brute force, per (subset, item) pair
+    double nsPerMitmEntry = 40.0;    ///< Meet-in-the-middle, per enumerated half-subset
+    double nsPerDenseCell = 3.0;     ///< Dense DP, per (item, capacity) cell
+    double nsPerProfitCell = 1.5;    ///< Profit DP, per (item, profit) cell
+    double nsPerSparseState = 15.0;  ///< Sparse DP, per estimated Pareto state
+    double nsPerBnBNode = 60.0;      ///< Branch-and-bound, per estimated node
+    double memoryLimit = 2e9;        ///< Methods estimated to need more bytes are not considered
+};
+
+/**
+ * @struct CostEstimate
+ * @brief Estimated runtime and memory of one exact method on one instance.
+ */
+struct CostEstimate {
+    string solver;       ///< Registry name of the solver
+    double seconds;      ///< Estimated wall time
+    double bytes;        ///< Estimated peak memory
+    bool applicable;     ///< False if the method cannot handle the instance or exceeds the memory budget
+};
+
+/**
+ * @brief Computes the features of an instance in one pass.
+ */
+InstanceFeatures computeFeatures(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight);
+
+/**
+ * @brief Estimates time and memory of brute force, meet-in-the-middle, dense DP, profit DP,
+ * sparse DP and branch-and-bound.
+ */
+vector<CostEstimate> estimateCosts(const InstanceFeatures& features, const CostModel& model);
+
+/**
+ * @brief Name of the cheapest applicable exact solver.
+ */
+string selectSolver(const InstanceFeatures& features, const CostModel& model);
+
+/**
+ * @brief Times every exact method on generated instances and fits the per-unit costs.
+ * 
+ * @param seed Seed of the instance generator.
+ * @return The calibrated model.
+ */
+CostModel calibrateCostModel(unsigned int seed = 1);
+
+/**
+ * @brief Loads a cost model from a "key,value" CSV file.
+ * @return True on success.
+ */
+bool loadCostModel(const string& filename, CostModel& model);
+
+/**
+ * @brief Saves a cost model as a "key,value" CSV file.
+ * @return True on success.
+ */
+bool saveCostModel(const string& filename, const CostModel& model);
+
+/**
+ * @brief Corrects a cost model with the winners recorded by knapsackPortfolio.
+ * @return Number of log lines applied, or -1 if the file cannot be opened.
+ */
+int learnFromPortfolioLog(const string& filename, CostModel& model);
+
+/**
+ * @brief The model used by knapsackAuto (loaded from $KNAPSACK_COST_MODEL and corrected with
+ * $KNAPSACK_PORTFOLIO_LOG if set).
+ */
+CostModel& activeCostModel();
+
+/**
+ * @brief Solves the instance with the exact method the cost model predicts to be cheapest.
+ * 
+ * @param values Array of item values.
+ * @param weights Array of item weights.
+ * @param n Number of items.
+ * @param maxWeight Maximum total weight allowed.
+ * @param usedItems Output array marking which items are used.
+ * @param cancel Optional cancellation token, passed on to the chosen solver.
+ * @param status Optional output describing how the run ended.
+ * @return Maximum total value that fits in the knapsack.
+ */
+unsigned int knapsackAuto(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                          const CancellationToken* cancel = nullptr, SolveStatus* status = nullptr);
+
+#endif //SOLVER_SELECT_H
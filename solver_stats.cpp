@@ -0,0 +1,58 @@
+#include <sstream>
+#include "solver_stats.h"
+
+using namespace std;
+
+/**
+ * @brief Adds the counters of another run; peak memory is the larger of the two.
+ */
+void SolverStats::merge(const SolverStats& other) {
+    dpCells += other.dpCells;
+    nodesCreated += other.nodesCreated;
+    nodesPruned += other.nodesPruned;
+    nodesExpanded += other.nodesExpanded;
+    boundEvaluations += other.boundEvaluations;
+    subsetsEnumerated += other.subsetsEnumerated;
+    incumbentUpdates += other.incumbentUpdates;
+    peakMemoryBytes = max(peakMemoryBytes, other.peakMemoryBytes);
+    loadSeconds += other.loadSeconds;
+    preprocessSeconds += other.preprocessSeconds;
+    solveSeconds += other.solveSeconds;
+    reconstructSeconds += other.reconstructSeconds;
+}
+
+/**
+ * @brief The counters and phase timings (in milliseconds) as a JSON object.
+ */
+string solverStatsJSON(const SolverStats& s) {
+    ostringstream out;
+    out << "{\"dp_cells\": " << s.dpCells << ", \"nodes_created\": " << s.nodesCreated
+        << ", \"nodes_pruned\": " << s.nodesPruned << ", \"nodes_expanded\": " << s.nodesExpanded
+        << ", \"bound_evaluations\": " << s.boundEvaluations << ", \"subsets\": " << s.subsetsEnumerated
+        << ", \"incumbent_updates\": " << s.incumbentUpdates << ", \"peak_bytes\": " << s.peakMemoryBytes
+        << ", \"preprocess_ms\": " << s.preprocessSeconds * 1000 << ", \"solve_ms\": " << s.solveSeconds * 1000
+        << ", \"reconstruct_ms\": " << s.reconstructSeconds * 1000 << "}";
+    return out.str();
+}
+
+/**
+ * @brief The stats object the calling thread's solvers report to, or nullptr.
+ */
+SolverStats*& currentSolverStats() {
+    static thread_local SolverStats* current = nullptr;
+    return current;
+}
+
+/**
+ * @brief Lower-case name of a phase, as used for trace events.
+ */
+const char* solverPhaseName(SolverPhase phase) {
+    switch (phase) {
+        case SolverPhase::Load: return "load";
+        case SolverPhase::Preprocess: return "preprocess";
+        case SolverPhase::Solve: return "solve";
+        case SolverPhase::Reconstruct: return "reconstruct";
+        case SolverPhase::None: break;
+    }
+    return "none";
+}
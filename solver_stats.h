@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "trace.h"
+using namespace std;
+
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+/**
+ * Statistics are collected unless the build defines KNAPSACK_STATS=0 (CMake option
+ * KNAPSACK_STATS=OFF), in which case every recorder call compiles to nothing.
+ */
+#ifndef KNAPSACK_STATS
+#define KNAPSACK_STATS 1
+#endif
+
+constexpr bool solverStatsEnabled = KNAPSACK_STATS != 0;
+
+/**
+ * @struct SolverStats
+ * @brief Work counters and phase timings of one solve.
+ */
+struct SolverStats {
+    unsigned long long dpCells = 0;           ///< DP cells (or Pareto states) computed
+    unsigned long long nodesCreated = 0;      ///< Branch-and-bound nodes pushed
+    unsigned long long nodesPruned = 0;       ///< Branch-and-bound nodes discarded by their bound
+    unsigned long long nodesExpanded = 0;     ///< Branch-and-bound nodes branched on or evaluated as leaves
+    unsigned long long boundEvaluations = 0;  ///< Upper bounds computed
+    unsigned long long subsetsEnumerated = 0; ///< Subsets visited by brute force and meet-in-the-middle
+    unsigned long long incumbentUpdates = 0;  ///< Times the best known solution improved
+    unsigned long long peakMemoryBytes = 0;   ///< Largest working set reported by the solver (main buffers only)
+    double loadSeconds = 0;                   ///< Reading the instance (filled by the caller)
+    double preprocessSeconds = 0;             ///< Sorting, bounds, warm starts, table initialization
+    double solveSeconds = 0;                  ///< The search or DP proper
+    double reconstructSeconds = 0;            ///< Recovering the chosen items
+
+    /**
+     * @brief Adds the counters of another run; peak memory is the larger of the two.
+     */
+    void merge(const SolverStats& other);
+};
+
+/**
+ * @brief The counters and phase timings (in milliseconds) as a JSON object.
+ */
+string solverStatsJSON(const SolverStats& stats);
+
+/**
+ * @enum SolverPhase
+ * @brief Phases a solver's time is attributed to.
+ */
+enum class SolverPhase { None, Load, Preprocess, Solve, Reconstruct };
+
+/**
+ * @brief Lower-case name of a phase, as used for trace events.
+ */
+const char* solverPhaseName(SolverPhase phase);
+
+/**
+ * @brief The stats object the calling thread's solvers report to, or nullptr.
+ */
+SolverStats*& currentSolverStats();
+
+/**
+ * @class SolverStatsScope
+ * @brief Makes solvers called on this thread report into a SolverStats until the scope ends.
+ *
+ * Scopes nest; solvers' internal worker threads do not report.
+ */
+class SolverStatsScope {
+public:
+    explicit SolverStatsScope(SolverStats* stats) : previous(currentSolverStats()) { currentSolverStats() = stats; }
+    ~SolverStatsScope() { currentSolverStats() = previous; }
+    SolverStatsScope(const SolverStatsScope&) = delete;
+    SolverStatsScope& operator=(const SolverStatsScope&) = delete;
+
+private:
+    SolverStats* previous;
+};
+
+/**
+ * @class StatsRecorder
+ * @brief Per-call counter a solver updates in its loops.
+ *
+ * Counts go to a local SolverStats and are added to the thread's current stats (if any) when the
+ * recorder is destroyed, so the hot loops only touch a local. The disabled specialization has no
+ * state and empty inline methods.
+ */
+template <bool Enabled>
+class StatsRecorder {
+public:
+    StatsRecorder() : target(currentSolverStats()) {}
+    ~StatsRecorder() {
+        phase(SolverPhase::None);
+        if (target != nullptr) target->merge(local);
+    }
+    StatsRecorder(const StatsRecorder&) = delete;
+    StatsRecorder& operator=(const StatsRecorder&) = delete;
+
+    void cells(unsigned long long count) { local.dpCells += count; }
+    void nodeCreated(unsigned long long count = 1) { local.nodesCreated += count; }
+    void nodePruned(unsigned long long count = 1) { local.nodesPruned += count; }
+    void nodeExpanded() { local.nodesExpanded++; }
+    void boundEvaluated() { local.boundEvaluations++; }
+    void subsets(unsigned long long count) { local.subsetsEnumerated += count; }
+    void incumbentUpdated() { local.incumbentUpdates++; }
+    void memory(unsigned long long bytes) { local.peakMemoryBytes = max(local.peakMemoryBytes, bytes); }
+
+    /**
+     * @brief Ends the running phase, charging its time (and tracing it), and starts the next one.
+     */
+    void phase(SolverPhase next) {
+        auto now = chrono::steady_clock::now();
+        double seconds = chrono::duration<double>(now - phaseStart).count();
+        switch (running) {
+            case SolverPhase::Load: local.loadSeconds += seconds; break;
+            case SolverPhase::Preprocess: local.preprocessSeconds += seconds; break;
+            case SolverPhase::Solve: local.solveSeconds += seconds; break;
+            case SolverPhase::Reconstruct: local.reconstructSeconds += seconds; break;
+            case SolverPhase::None: break;
+        }
+        if (running != SolverPhase::None && traceEnabled()) {
+            traceComplete(solverPhaseName(running), "phase", phaseStart, now);
+        }
+        running = next;
+        phaseStart = now;
+    }
+
+private:
+    SolverStats local;
+    SolverStats* target;
+    SolverPhase running = SolverPhase::None;
+    chrono::steady_clock::time_point phaseStart;
+};
+
+template <>
+class StatsRecorder<false> {
+public:
+    void cells(unsigned long long) {}
+    void nodeCreated(unsigned long long = 1) {}
+    void nodePruned(unsigned long long = 1) {}
+    void nodeExpanded() {}
+    void boundEvaluated() {}
+    void subsets(unsigned long long) {}
+    void incumbentUpdated() {}
+    void memory(unsigned long long) {}
+    void phase(SolverPhase) {}
+};
+
+/**
+ * @brief The recorder solvers use: active or empty depending on KNAPSACK_STATS.
+ */
+typedef StatsRecorder<solverStatsEnabled> SolverStatsRecorder;
+
+#endif //SOLVER_STATS_H
@@ -0,0 +1,177 @@
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "local_search.h"
+#include "metaheuristics.h"
+#include "solvers.h"
+#include "solver_select.h"
+#include "portfolio.h"
+
+using namespace std;
+
+/**
+ * @brief Runs a cancellable entry point without a token, for the plain registry entry.
+ */
+template <CancellableSolver solver>
+static unsigned int uncancellable(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[]) {
+    return solver(values, weights, n, maxWeight, usedItems, nullptr, nullptr);
+}
+
+/**
+ * @brief Status of a heuristic run: Cancelled if the token stopped it, otherwise Feasible.
+ */
+static void heuristicStatus(const CancellationToken* cancel, SolveStatus* status) {
+    if (status != nullptr) *status = cancel != nullptr && cancel->isCancelled() ? SolveStatus::Cancelled : SolveStatus::Feasible;
+}
+
+/**
+ * @brief Dynamic programming, using the static-array version when the instance fits in it.
+ */
+static unsigned int solveDP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                            const CancellationToken* cancel, SolveStatus* status) {
+    if (maxWeight < 1000 && n <= 100) {
+        return knapsackDP(values, weights, n, maxWeight, usedItems, cancel, status);
+    }
+    return knapsackDP1(values, weights, n, maxWeight, usedItems, cancel, status);
+}
+
+/**
+ * @brief Greedy; it runs in O(n) expected time and does not poll the token.
+ */
+static unsigned int solveGreedy(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                                const CancellationToken*, SolveStatus* status) {
+    if (status != nullptr) *status = SolveStatus::Feasible;
+    return knapsackGreedy(values, weights, n, maxWeight, usedItems);
+}
+
+/**
+ * @brief Portfolio race, logging to $KNAPSACK_PORTFOLIO_LOG when set.
+ */
+static unsigned int solvePortfolio(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                                   const CancellationToken* cancel, SolveStatus* status) {
+    return knapsackPortfolio(values, weights, n, maxWeight, usedItems, nullptr, "", cancel, status);
+}
+
+/**
+ * @brief Greedy followed by a single-threaded local search stage.
+ */
+static unsigned int solveGreedyLocalSearch(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                                           const CancellationToken* cancel, SolveStatus* status) {
+    knapsackGreedy(values, weights, n, maxWeight, usedItems);
+    unsigned int value = localSearch(values, weights, n, maxWeight, usedItems, 0.05, 1, cancel);
+    heuristicStatus(cancel, status);
+    return value;
+}
+
+/**
+ * @brief Branch-and-bound with the default warm start; a cancelled search returns its incumbent.
+ */
+static unsigned int solveILP(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                             const CancellationToken* cancel, SolveStatus* status) {
+    ILPOptions options;
+    options.cancel = cancel;
+    ILPStats stats;
+    unsigned int value = knapsackILP(values, weights, n, maxWeight, usedItems, options, &stats);
+    if (status != nullptr) *status = stats.optimal ? SolveStatus::Optimal : SolveStatus::Cancelled;
+    return value;
+}
+
+/**
+ * @brief FPTAS with epsilon = 0.1.
+ */
+static unsigned int solveFPTAS(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                               const CancellationToken* cancel, SolveStatus* status) {
+    return knapsackFPTAS(values, weights, n, maxWeight, 0.1, usedItems, nullptr, cancel, status);
+}
+
+/**
+ * @brief Single-island metaheuristic settings for registry use: one second, fixed seed, silent.
+ */
+static MetaheuristicOptions registryMetaOptions(const CancellationToken* cancel) {
+    MetaheuristicOptions options;
+    options.timeLimit = 1.0;
+    options.threads = 1;
+    options.cancel = cancel;
+    return options;
+}
+
+static unsigned int solveGenetic(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                                 const CancellationToken* cancel, SolveStatus* status) {
+    unsigned int value = knapsackGenetic(values, weights, n, maxWeight, usedItems, registryMetaOptions(cancel));
+    heuristicStatus(cancel, status);
+    return value;
+}
+
+static unsigned int solveAnnealing(unsigned int values[], unsigned int weights[], unsigned int n, unsigned int maxWeight, bool usedItems[],
+                                   const CancellationToken* cancel, SolveStatus* status) {
+    unsigned int value = knapsackAnnealing(values, weights, n, maxWeight, usedItems, registryMetaOptions(cancel));
+    heuristicStatus(cancel, status);
+    return value;
+}
+
+static bool fitsBruteForce(const unsigned int[], const unsigned int[], unsigned int n, unsigned int) { return n <= 25; }
+/**
+ * @brief Dense DP: its three unsigned int tables of n x (capacity + 1) cells (12 bytes per cell)
+ * must fit the cost model's memory budget.
+ */
+static bool fitsDP(const unsigned int[], const unsigned int[], unsigned int n, unsigned int maxWeight) {
+    return 12.0 * n * (maxWeight + 1.0) <= activeCostModel().memoryLimit;
+}
+static bool fitsStaticDP(const unsigned int[], const unsigned int[], unsigned int n, unsigned int maxWeight) {
+    return n <= 100 && maxWeight < 1000;
+}
+static bool fitsMITM(const unsigned int[], const unsigned int[], unsigned int n, unsigned int) { return n <= 44; }
+static bool fitsAlways(const unsigned int[], const unsigned int[], unsigned int, unsigned int) { return true; }
+
+/**
+ * @brief Profit DP: its table grows with the total profit, so the bytes it would allocate (one
+ * minimum weight per profit plus one bit per item and profit) must fit the cost model's budget.
+ */
+static bool fitsProfitDP(const unsigned int values[], const unsigned int weights[], unsigned int n, unsigned int maxWeight) {
+    if (n > 20000) return false;
+    unsigned long long profitSum = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (weights[i] <= maxWeight) profitSum += values[i];
+    }
+    double bytes = 8.0 * (profitSum + 1) + 8.0 * n * (profitSum / 64 + 1);
+    return bytes <= activeCostModel().memoryLimit;
+}
+
+/**
+ * @brief Returns every registered solver.
+ *
+ * @return Reference to the solver registry.
+ */
+const vector<SolverInfo>& knapsackSolvers() {
+    static const vector<SolverInfo> solvers = {
+        {"bf", "Brute force", uncancellable<knapsackBF>, true, fitsBruteForce, knapsackBF},
+        {"dp", "Dynamic programming", uncancellable<solveDP>, true, fitsDP, solveDP},
+        {"dp-static", "Dynamic programming, static arrays", uncancellable<knapsackDP>, true, fitsStaticDP, knapsackDP},
+        {"dp-vector", "Dynamic programming, vectors", uncancellable<knapsackDP1>, true, fitsDP, knapsackDP1},
+        {"greedy", "Greedy (1/2-approximation)", knapsackGreedy, false, fitsAlways, solveGreedy},
+        {"greedy-ls", "Greedy followed by local search", uncancellable<solveGreedyLocalSearch>, false, fitsAlways, solveGreedyLocalSearch},
+        {"mitm", "Meet-in-the-middle", uncancellable<knapsackMITM>, true, fitsMITM, knapsackMITM},
+        {"dp-profit", "Dynamic programming over profits", uncancellable<knapsackProfitDP>, true, fitsProfitDP, knapsackProfitDP},
+        {"dp-sparse", "Sparse dynamic programming (Pareto states)", uncancellable<knapsackSparseDP>, true, fitsAlways, knapsackSparseDP},
+        {"ilp", "Branch-and-bound", uncancellable<solveILP>, true, fitsAlways, solveILP},
+        {"fptas", "FPTAS, epsilon = 0.1", uncancellable<solveFPTAS>, false, fitsAlways, solveFPTAS},
+        {"ga", "Genetic algorithm, 1 s", uncancellable<solveGenetic>, false, fitsAlways, solveGenetic},
+        {"sa", "Parallel-tempering annealing, 1 s", uncancellable<solveAnnealing>, false, fitsAlways, solveAnnealing},
+        {"auto", "Cheapest exact method by cost model", uncancellable<knapsackAuto>, true, fitsAlways, knapsackAuto},
+        {"portfolio", "DP, branch-and-bound and MITM raced on threads", uncancellable<solvePortfolio>, true, fitsAlways, solvePortfolio},
+    };
+    return solvers;
+}
+
+/**
+ * @brief Looks up a solver by name.
+ *
+ * @param name Solver name.
+ * @return Pointer to the registry entry, or nullptr if there is no such solver.
+ */
+const SolverInfo* findSolver(const string& name) {
+    for (const SolverInfo& solver : knapsackSolvers()) {
+        if (solver.name == name) return &solver;
+    }
+    return nullptr;
+}
@@ -0,0 +1,53 @@
+#include <string>
+#include <vector>
+#include "cancellation.h"
+using namespace std;
+
+#ifndef SOLVERS_H
+#define SOLVERS_H
+
+/**
+ * @brief Common signature of the single-truck knapsack solvers.
+ */
+typedef unsigned int (*KnapsackSolver)(unsigned int values[], unsigned int weights[], unsigned int n,
+                                       unsigned int maxWeight, bool usedItems[]);
+
+/**
+ * @brief Signature of the solver entry points that poll a cancellation token (which may carry a
+ * deadline). On cancellation they return the best feasible solution they know of; status, if
+ * given, is always set to Optimal, Feasible or Cancelled.
+ */
+typedef unsigned int (*CancellableSolver)(unsigned int values[], unsigned int weights[], unsigned int n,
+                                          unsigned int maxWeight, bool usedItems[], const CancellationToken* cancel,
+                                          SolveStatus* status);
+
+/**
+ * @struct SolverInfo
+ * @brief Registry entry describing one knapsack solver.
+ */
+struct SolverInfo {
+    string name;          ///< Name used on the command line and in result files
+    string description;   ///< Human readable description
+    KnapsackSolver solve; ///< Entry point
+    bool exact;           ///< True if the solver proves optimality
+    bool (*fits)(const unsigned int values[], const unsigned int weights[], unsigned int n,
+                 unsigned int maxWeight); ///< Whether the solver can handle the instance (size and memory)
+    CancellableSolver solveCancellable; ///< Entry point that stops when the token is cancelled
+};
+
+/**
+ * @brief Returns every registered solver.
+ * 
+ * @return Reference to the solver registry.
+ */
+const vector<SolverInfo>& knapsackSolvers();
+
+/**
+ * @brief Looks up a solver by name.
+ * 
+ * @param name Solver name.
+ * @return Pointer to the registry entry, or nullptr if there is no such solver.
+ */
+const SolverInfo* findSolver(const string& name);
+
+#endif //SOLVERS_H
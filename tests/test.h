@@ -0,0 +1,40 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+using namespace std;
+
+#ifndef TEST_H
+#define TEST_H
+
+/**
+ * Minimal harness of the test executables: each is a main() whose checks end the process with
+ * status 1 on the first failure, which ctest reports with the message below.
+ */
+
+/**
+ * @brief Fails the test with the file, line and condition if a condition does not hold.
+ */
+#define CHECK(condition)                                                                              \
+    do {                                                                                              \
+        if (!(condition)) {                                                                           \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << endl;          \
+            exit(1);                                                                                  \
+        }                                                                                             \
+    } while (0)
+
+/**
+ * @brief A fresh directory for a test's files, unique to the process.
+ *
+ * @param name Name of the test.
+ * @return Path of the (empty) directory.
+ */
+inline filesystem::path testDirectory(const string& name) {
+    filesystem::path directory = filesystem::temp_directory_path() / ("knapsack_" + name + "_" + to_string(getpid()));
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+    return directory;
+}
+
+#endif //TEST_H
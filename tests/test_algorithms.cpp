@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "algorithms.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief A random instance with correlated profits.
+ */
+struct Instance {
+    vector<unsigned int> values;
+    vector<unsigned int> weights;
+    unsigned int capacity = 0;
+
+    Instance(mt19937& rng, unsigned int n) : values(n), weights(n) {
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            weights[i] = 1 + rng() % 100;
+            values[i] = weights[i] + rng() % 30;
+            total += weights[i];
+        }
+        capacity = total / 2;
+    }
+};
+
+/**
+ * @brief Value of a selection, after checking that it fits.
+ */
+static unsigned int selectionValue(const Instance& instance, const vector<char>& used) {
+    unsigned long long weight = 0, value = 0;
+    for (size_t i = 0; i < used.size(); i++) {
+        if (used[i]) {
+            weight += instance.weights[i];
+            value += instance.values[i];
+        }
+    }
+    CHECK(weight <= instance.capacity);
+    return value;
+}
+
+/**
+ * @brief Reference greedy: sort by ratio, take the prefix before the first item that does not
+ * fit, and keep the better of it and the best single item. 0 if two ratios tie (the prefix then
+ * depends on the order of the tied items).
+ */
+static unsigned int sortingGreedy(const Instance& instance) {
+    unsigned int n = instance.values.size();
+    vector<unsigned int> order;
+    unsigned int bestSingle = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (instance.weights[i] > instance.capacity) continue;
+        order.push_back(i);
+        bestSingle = max(bestSingle, instance.values[i]);
+    }
+    auto ratio = [&](unsigned int a, unsigned int b) {
+        return (unsigned long long) instance.values[a] * instance.weights[b] <=> (unsigned long long) instance.values[b] * instance.weights[a];
+    };
+    sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return ratio(a, b) > 0; });
+    for (size_t k = 1; k < order.size(); k++) {
+        if (ratio(order[k - 1], order[k]) == 0) return 0;
+    }
+    unsigned long long weight = 0, prefix = 0;
+    for (unsigned int i : order) {
+        if (weight + instance.weights[i] > instance.capacity) break;
+        weight += instance.weights[i];
+        prefix += instance.values[i];
+    }
+    return max<unsigned long long>(prefix, bestSingle);
+}
+
+/**
+ * Single-truck algorithms: branch-and-bound warm starts and anytime budgets, the FPTAS
+ * guarantee, and the critical-item greedy against a sorting greedy.
+ */
+int main() {
+    mt19937 rng(3);
+    for (int run = 0; run < 100; run++) {
+        Instance instance(rng, 5 + rng() % 20);
+        unsigned int n = instance.values.size();
+        unsigned int* values = instance.values.data();
+        unsigned int* weights = instance.weights.data();
+        vector<char> used(n);
+        unsigned int optimum = knapsackDP1(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()));
+        CHECK(selectionValue(instance, used) == optimum);
+        vector<char> best = used;
+
+        // Incumbents only improve, and the last one is the answer
+        ILPOptions options;
+        vector<unsigned int> incumbents;
+        options.onImprove = [&](unsigned int value, double gap) {
+            CHECK(incumbents.empty() || value > incumbents.back());
+            CHECK(gap >= 0);
+            incumbents.push_back(value);
+        };
+        ILPStats stats;
+        CHECK(knapsackILP(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()), options, &stats) == optimum);
+        CHECK(stats.optimal && selectionValue(instance, used) == optimum);
+        CHECK(incumbents.empty() || incumbents.back() == optimum);
+        options.onImprove = nullptr;
+        options.improveIncumbent = true;
+        CHECK(knapsackILP(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()), options) == optimum);
+
+        // A node budget stops the search with a feasible answer no worse than the warm start
+        ILPOptions budget;
+        budget.nodeLimit = 1;
+        budget.greedyWarmStart = false;
+        budget.incumbent = reinterpret_cast<const bool*>(best.data());
+        CHECK(knapsackILP(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()), budget, &stats) == optimum);
+        CHECK(selectionValue(instance, used) == optimum);
+        budget.incumbent = nullptr;
+        unsigned int value = knapsackILP(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()), budget, &stats);
+        CHECK(selectionValue(instance, used) == value && value <= optimum);
+        if (!stats.optimal) CHECK(stats.gap >= 0);
+
+        // The FPTAS is within (1 - epsilon) of the optimum and its bound is above it
+        for (double epsilon : {0.5, 0.1, 0.01}) {
+            unsigned int upper = 0;
+            SolveStatus status;
+            value = knapsackFPTAS(values, weights, n, instance.capacity, epsilon, reinterpret_cast<bool*>(used.data()), &upper,
+                                  nullptr, &status);
+            CHECK(selectionValue(instance, used) == value);
+            CHECK(value >= (1 - epsilon) * optimum && value <= optimum);
+            CHECK(upper >= optimum);
+            CHECK(status != SolveStatus::Cancelled);
+        }
+
+        // Without sorting, the greedy still takes the whole prefix before the critical item (then
+        // fills what is left), and is a 1/2-approximation
+        value = knapsackGreedy(values, weights, n, instance.capacity, reinterpret_cast<bool*>(used.data()));
+        CHECK(selectionValue(instance, used) == value);
+        CHECK(2ULL * value >= optimum);
+        unsigned int reference = sortingGreedy(instance);
+        CHECK(value >= reference);
+    }
+
+    // A time limit stops a hard search early
+    Instance hard(rng, 3000);
+    for (unsigned int i = 0; i < hard.values.size(); i++) hard.values[i] = hard.weights[i] + 10;
+    vector<char> used(hard.values.size());
+    ILPOptions limited;
+    limited.timeLimit = 0.05;
+    ILPStats stats;
+    auto start = chrono::steady_clock::now();
+    unsigned int value = knapsackILP(hard.values.data(), hard.weights.data(), hard.values.size(), hard.capacity + 1,
+                                     reinterpret_cast<bool*>(used.data()), limited, &stats);
+    CHECK(chrono::duration<double>(chrono::steady_clock::now() - start).count() < 2);
+    hard.capacity++;
+    CHECK(selectionValue(hard, used) == value);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <climits>
+#include "arguments.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * Option parsing shared by the command line tools: whole-argument integers within a limit and
+ * finite non-negative numbers.
+ */
+int main() {
+    unsigned long long count;
+    CHECK(parseCount("0", 10, count) && count == 0);
+    CHECK(parseCount("10", 10, count) && count == 10);
+    CHECK(!parseCount("11", 10, count));
+    CHECK(parseCount("18446744073709551615", ULLONG_MAX, count) && count == ULLONG_MAX);
+    CHECK(!parseCount("18446744073709551616", ULLONG_MAX, count));
+    for (const char* text : {"", "-1", "+1", " 1", "1 ", "4x", "x", "1e3", "0x10", "2.5"}) {
+        CHECK(!parseCount(text, ULLONG_MAX, count));
+    }
+
+    unsigned int small = 7;
+    CHECK(parseCount("4294967295", small) && small == UINT_MAX);
+    small = 7;
+    CHECK(!parseCount("4294967296", small));
+    CHECK(!parseCount("-3", small));
+    CHECK(small == 7);
+
+    double number;
+    CHECK(parseNonNegative("0", number) && number == 0);
+    CHECK(parseNonNegative("2.5", number) && number == 2.5);
+    CHECK(parseNonNegative("1e-3", number) && number == 1e-3);
+    for (const char* text : {"", "-1", "-0.5", "x", "1.5s", "inf", "nan", "1e400"}) {
+        CHECK(!parseNonNegative(text, number));
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "batch.h"
+#include "generator.h"
+#include "thread_pool.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Splits a line of the batch CSV into fields, undoing the quoting of the first one.
+ */
+static vector<string> csvFields(const string& line) {
+    vector<string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+            fields.back() += '"';
+            i++;
+        } else if (c == '"') {
+            quoted = !quoted;
+        } else if (c == ',' && !quoted) {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+/**
+ * Work-stealing pool and batch runs: every task runs (including tasks submitted by tasks), jobs
+ * are discovered from directories and manifests, and every job gets one well-formed result line.
+ */
+int main() {
+    {
+        ThreadPool pool(3);
+        CHECK(pool.size() == 3);
+        atomic<int> done{0};
+        for (int k = 0; k < 200; k++) {
+            pool.submit([&]() {
+                done++;
+                pool.submit([&]() { done++; });
+            });
+        }
+        pool.wait();
+        CHECK(done == 400);
+        pool.wait();
+        pool.submit([&]() { done++; });
+        pool.wait();
+        CHECK(done == 401);
+    }
+    CHECK(ThreadPool().size() >= 1);
+
+    filesystem::path directory = testDirectory("batch");
+    ofstream(directory / "Pallets_01.csv") << "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n";
+    ofstream(directory / "TruckAndPallets_01.csv") << "Capacity,Pallets\n100,3\n";
+    ofstream(directory / "Pallets_02.csv") << "Pallet,Weight,Profit\n1,heavy,10\n";
+    ofstream(directory / "TruckAndPallets_02.csv") << "Capacity,Pallets\n100,1\n";
+    ofstream(directory / "Pallets_03.csv") << "Pallet,Weight,Profit\n1,1,1\n";  // no truck file: not a job
+    GeneratorOptions options;
+    options.n = 50;
+    CHECK(writeInstanceBinary(options, (directory / "a,\"b\".knap").string()));
+
+    vector<BatchJob> jobs = discoverBatchJobs(directory.string());
+    CHECK(jobs.size() == 3);
+    CHECK(jobs[0].name == "01" && jobs[1].name == "02" && jobs[2].name == "a,\"b\"");
+    CHECK(jobs[2].truckFile.empty());
+
+    ofstream(directory / "manifest.txt") << "# instances\n\nPallets_01.csv,TruckAndPallets_01.csv\n"
+                                         << (directory / "Pallets_02.csv").string() << ",TruckAndPallets_02.csv\n";
+    vector<BatchJob> listed = discoverBatchJobs((directory / "manifest.txt").string());
+    CHECK(listed.size() == 2);
+    CHECK(listed[0].name == "Pallets_01" && listed[0].palletsFile == (directory / "Pallets_01.csv").string());
+    CHECK(listed[1].truckFile == (directory / "TruckAndPallets_02.csv").string());
+    string error;
+    CHECK(discoverBatchJobs((directory / "missing.txt").string(), &error).empty() && !error.empty());
+
+    ostringstream out;
+    CHECK(runBatch(jobs, "dp", 2, out) == 1);
+    istringstream lines(out.str());
+    string line;
+    getline(lines, line);
+    CHECK(line == "instance,algorithm,status,pallets,capacity,profit,load,millis");
+    map<string, vector<string>> results;
+    while (getline(lines, line)) {
+        vector<string> fields = csvFields(line);
+        CHECK(fields.size() == 8);
+        results[fields[0]] = fields;
+    }
+    CHECK(results.size() == 3);
+    CHECK(results["01"][2] == "ok" && results["01"][5] == "18" && results["01"][6] == "100");
+    CHECK(results["02"][2] == "load-error");
+    CHECK(results["a,\"b\""][2] == "ok" && results["a,\"b\""][3] == "50");
+
+    ostringstream unused;
+    CHECK(runBatch(jobs, "no-such-solver", 1, unused, &error) == jobs.size());
+    CHECK(!error.empty());
+
+    filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "bench.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Number of lines of a text.
+ */
+static size_t countLines(const string& text) {
+    size_t lines = 0;
+    for (char c : text) lines += c == '\n';
+    return lines;
+}
+
+/**
+ * @brief A result with the given run times.
+ */
+static BenchResult timed(const string& instance, const string& solver, const vector<double>& millis) {
+    BenchResult r;
+    r.instance = instance;
+    r.solver = solver;
+    r.status = millis.empty() ? "timeout" : "ok";
+    r.millis = millis;
+    vector<double> sorted = millis;
+    sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) r.medianMillis = sorted[sorted.size() / 2];
+    return r;
+}
+
+/**
+ * @brief The comparison of one pair.
+ */
+static const BenchComparison& comparisonOf(const vector<BenchComparison>& comparisons, const string& instance) {
+    for (const BenchComparison& c : comparisons) {
+        if (c.instance == instance) return c;
+    }
+    CHECK(false);
+    return comparisons.front();
+}
+
+/**
+ * Benchmark harness: dataset discovery, forked timed runs with their statistics, solvers that
+ * do not fit the instance, the CSV report, the JSON baseline, and the regression gate.
+ */
+int main() {
+    filesystem::path directory = testDirectory("bench");
+    ofstream(directory / "Pallets_01.csv") << "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n";
+    ofstream(directory / "TruckAndPallets_01.csv") << "Capacity,Pallets\n100,3\n";
+    {
+        ofstream pallets(directory / "Pallets_02.csv");
+        pallets << "Pallet,Weight,Profit\n";
+        for (int i = 1; i <= 30; i++) pallets << i << "," << i << "," << 31 - i << "\n";
+        ofstream(directory / "TruckAndPallets_02.csv") << "Capacity,Pallets\n200,30\n";
+    }
+
+    BenchOptions options;
+    options.directories = {directory.string()};
+    options.generated = false;
+    vector<BenchInstance> instances = loadBenchInstances(options);
+    string prefix = directory.filename().string();
+    CHECK(instances.size() == 2);
+    CHECK(instances[0].name == prefix + "/01" && instances[0].maxWeight == 100 && instances[0].values.size() == 3);
+    CHECK(instances[1].name == prefix + "/02" && instances[1].weights.size() == 30);
+
+    // Every run is timed in its own process; the last one's profit and counters are kept
+    BenchResult dp = benchmarkSolver(instances[0], *findSolver("dp-vector"), 3, 10);
+    CHECK(dp.status == "ok" && dp.profit == 18 && dp.n == 3 && dp.capacity == 100);
+    CHECK(dp.millis.size() == 3 && dp.medianMillis <= dp.p95Millis);
+    CHECK(dp.unit == "cells" && dp.stats.dpCells == 2 * 100 && dp.peakRssKB > 0);
+    CHECK(!dp.perf.anyAvailable());
+
+    // The solver filter skips unknown names; brute force does not fit 30 items and is not run
+    options.repeats = 2;
+    options.solvers = {"bf", "simplex", "ilp"};
+    ostringstream progress;
+    vector<BenchResult> results = runBenchmark(options, &progress);
+    CHECK(results.size() == 4);
+    CHECK(results[0].solver == "bf" && results[0].status == "ok" && results[0].unit == "subsets");
+    CHECK(results[2].instance == prefix + "/02" && results[2].solver == "bf");
+    CHECK(results[2].status == "too-large" && results[2].millis.empty());
+    CHECK(results[3].solver == "ilp" && results[3].status == "ok" && results[3].millis.size() == 2);
+    CHECK(results[1].solver == "ilp" && results[1].profit == 18);
+    CHECK(progress.str().find("Unknown solver: simplex") != string::npos);
+    CHECK(countLines(progress.str()) == 1 + results.size());
+
+    ostringstream csv;
+    writeBenchCSV(results, csv);
+    CHECK(countLines(csv.str()) == 1 + results.size());
+    CHECK(csv.str().rfind("instance,solver,status,n,capacity,profit,runs,median_ms,", 0) == 0);
+    CHECK(csv.str().find(prefix + "/02,bf,too-large,30,200,") != string::npos);
+
+    // A JSON baseline reads back the samples and counters the comparison needs
+    {
+        ofstream json(directory / "baseline.json");
+        writeBenchJSON(results, json);
+    }
+    vector<BenchResult> loaded;
+    CHECK(loadBenchJSON((directory / "baseline.json").string(), loaded));
+    CHECK(loaded.size() == results.size());
+    for (size_t k = 0; k < results.size(); k++) {
+        CHECK(loaded[k].instance == results[k].instance && loaded[k].solver == results[k].solver);
+        CHECK(loaded[k].status == results[k].status && loaded[k].profit == results[k].profit);
+        CHECK(loaded[k].millis.size() == results[k].millis.size() && loaded[k].unit == results[k].unit);
+        CHECK(loaded[k].stats.dpCells == results[k].stats.dpCells);
+    }
+    CHECK(!loadBenchJSON((directory / "missing.json").string(), loaded));
+    ofstream(directory / "broken.json") << "[{\"instance\": ";
+    CHECK(!loadBenchJSON((directory / "broken.json").string(), loaded));
+
+    // Clear slowdowns regress, noise and sub-threshold differences do not, lost runs always regress
+    vector<double> base = {10, 10.2, 9.9, 10.1, 10.0, 9.8, 10.3};
+    vector<BenchResult> baseline = {
+        timed("slower", "dp", base), timed("noise", "dp", base), timed("faster", "dp", base),
+        timed("tiny", "dp", {0.01, 0.01, 0.011}), timed("lost", "dp", base), timed("gone", "dp", base),
+    };
+    vector<BenchResult> current = {
+        timed("slower", "dp", {15, 15.2, 14.9, 15.1, 15.0, 14.8, 15.3}),
+        timed("noise", "dp", {10.1, 9.9, 10.2, 10.0, 9.7, 10.4, 10.0}),
+        timed("faster", "dp", {5, 5.1, 4.9, 5.0, 5.2, 4.8, 5.0}),
+        timed("tiny", "dp", {0.03, 0.03, 0.031}),
+        timed("lost", "dp", {}),
+        timed("added", "dp", base),
+    };
+    vector<BenchComparison> comparisons = compareBench(baseline, current, 0.1, 0.1);
+    CHECK(comparisons.size() == 7);
+    CHECK(comparisonOf(comparisons, "slower").verdict == "regression");
+    CHECK(comparisonOf(comparisons, "slower").ciLow > 1.1 && comparisonOf(comparisons, "slower").ratio > 1.4);
+    CHECK(comparisonOf(comparisons, "noise").verdict == "same");
+    CHECK(comparisonOf(comparisons, "faster").verdict == "improvement");
+    CHECK(comparisonOf(comparisons, "tiny").verdict == "same");
+    CHECK(comparisonOf(comparisons, "lost").verdict == "regression");
+    CHECK(comparisonOf(comparisons, "gone").verdict == "missing");
+    CHECK(comparisonOf(comparisons, "added").verdict == "new");
+    ostringstream report;
+    writeBenchComparison(comparisons, report);
+    CHECK(countLines(report.str()) == 1 + comparisons.size());
+    filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <random>
+#include "bin_packing.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Fewest bins by trying every assignment of the items (small n only).
+ */
+static unsigned int bruteForce(const vector<unsigned int>& weights, unsigned int capacity) {
+    unsigned int best = weights.size();
+    vector<unsigned long long> loads;
+    auto place = [&](auto&& self, size_t item) -> void {
+        if (loads.size() >= best) return;
+        if (item == weights.size()) {
+            best = loads.size();
+            return;
+        }
+        for (size_t b = 0; b < loads.size(); b++) {
+            if (loads[b] + weights[item] > capacity) continue;
+            loads[b] += weights[item];
+            self(self, item + 1);
+            loads[b] -= weights[item];
+        }
+        loads.push_back(weights[item]);
+        self(self, item + 1);
+        loads.pop_back();
+    };
+    place(place, 0);
+    return best;
+}
+
+/**
+ * @brief Checks that a packing loads every item that fits exactly once, within the capacity.
+ */
+static void checkPacking(const vector<unsigned int>& weights, unsigned int capacity, const vector<vector<unsigned int>>& bins) {
+    vector<int> seen(weights.size(), 0);
+    for (const vector<unsigned int>& bin : bins) {
+        CHECK(!bin.empty());
+        unsigned long long load = 0;
+        for (unsigned int item : bin) {
+            CHECK(item < weights.size());
+            seen[item]++;
+            load += weights[item];
+        }
+        CHECK(load <= capacity);
+    }
+    for (size_t i = 0; i < weights.size(); i++) CHECK(seen[i] == (weights[i] <= capacity ? 1 : 0));
+}
+
+/**
+ * Bin packing: FFD, BFD, the lower bound and the exact search against brute force, plus node
+ * budgets, cancellation and items heavier than a truck.
+ */
+int main() {
+    mt19937 rng(5);
+    for (int run = 0; run < 300; run++) {
+        unsigned int n = 1 + rng() % 9, capacity = 10 + rng() % 90;
+        vector<unsigned int> weights(n);
+        for (unsigned int& weight : weights) weight = 1 + rng() % capacity;
+        unsigned int optimum = bruteForce(weights, capacity);
+
+        vector<vector<unsigned int>> bins;
+        unsigned int ffd = binPackingFFD(weights.data(), n, capacity, bins);
+        CHECK(ffd == bins.size() && ffd >= optimum);
+        checkPacking(weights, capacity, bins);
+        unsigned int bfd = binPackingBFD(weights.data(), n, capacity, bins);
+        CHECK(bfd == bins.size() && bfd >= optimum);
+        checkPacking(weights, capacity, bins);
+        unsigned int l1;
+        unsigned int lower = binPackingLowerBound(weights.data(), n, capacity, &l1);
+        CHECK(l1 <= lower && lower <= optimum);
+
+        bool optimal = false;
+        CHECK(binPackingExact(weights.data(), n, capacity, bins, 5000000, &optimal) == optimum);
+        CHECK(optimal && bins.size() == optimum);
+        checkPacking(weights, capacity, bins);
+    }
+
+    // Out of budget or cancelled: the best packing so far, not proven
+    vector<unsigned int> hard(60);
+    for (unsigned int& weight : hard) weight = 200 + rng() % 350;
+    vector<vector<unsigned int>> bins;
+    bool optimal = true;
+    unsigned int trucks = binPackingExact(hard.data(), hard.size(), 1000, bins, 10, &optimal);
+    CHECK(trucks == bins.size());
+    checkPacking(hard, 1000, bins);
+    CancellationToken token;
+    token.cancel();
+    trucks = binPackingExact(hard.data(), hard.size(), 1000, bins, 5000000, &optimal, &token);
+    CHECK(trucks == bins.size());
+    checkPacking(hard, 1000, bins);
+    if (trucks > binPackingLowerBound(hard.data(), hard.size(), 1000)) CHECK(!optimal);
+
+    // Items heavier than a truck are left out
+    vector<unsigned int> heavy = {5, 120, 7, 100};
+    CHECK(binPackingExact(heavy.data(), heavy.size(), 100, bins) == 2);
+    checkPacking(heavy, 100, bins);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include "solvers.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * Cancellation: deadlines and parent tokens, and every solver stopping soon after its deadline
+ * on instances it would take much longer to finish, with a feasible solution.
+ */
+int main() {
+    CancellationToken none;
+    CHECK(!none.isCancelled());
+    CancellationToken parent, child(0, &parent);
+    CHECK(!child.isCancelled());
+    parent.cancel();
+    CHECK(child.isCancelled() && !CancellationToken().isCancelled());
+
+    auto start = chrono::steady_clock::now();
+    CancellationToken deadline(0.02);
+    CHECK(!deadline.isCancelled());
+    while (!deadline.isCancelled()) {
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(5));
+    }
+    CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(20));
+
+    // Strongly correlated items: hard for branch-and-bound and local search alike. The small
+    // instance is for brute force, the large one (n <= 44 for MITM) for every other solver. The
+    // capacity keeps the DP tables small, as allocating them is a single uninterruptible step.
+    mt19937 rng(50);
+    for (unsigned int n : {25u, 44u}) {
+        vector<unsigned int> values(n), weights(n);
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            weights[i] = 1000 + rng() % 9000;
+            values[i] = weights[i] + 1000;
+            total += weights[i];
+        }
+        unsigned int capacity = total / 2;
+        for (const SolverInfo& solver : knapsackSolvers()) {
+            if (!solver.fits(values.data(), weights.data(), n, capacity)) continue;
+            vector<char> used(n);
+            CancellationToken token(0.05);
+            SolveStatus status;
+            auto begin = chrono::steady_clock::now();
+            unsigned int value = solver.solveCancellable(values.data(), weights.data(), n, capacity,
+                                                         reinterpret_cast<bool*>(used.data()), &token, &status);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            if (seconds >= 1.0) cerr << solver.name << " took " << seconds << " s" << endl;
+            CHECK(seconds < 1.0);
+            unsigned long long weight = 0, sum = 0;
+            for (unsigned int i = 0; i < n; i++) {
+                if (used[i]) {
+                    weight += weights[i];
+                    sum += values[i];
+                }
+            }
+            CHECK(weight <= capacity && sum == value);
+            CHECK(status != SolveStatus::Optimal || solver.exact);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <fstream>
+#include <sstream>
+#include "cli.h"
+#include "json.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Parses options given as one argument list (without the program name).
+ */
+static bool parse(vector<string> arguments, CliOptions& options) {
+    vector<char*> argv;
+    for (string& argument : arguments) argv.push_back(argument.data());
+    return parseCliOptions(argv.size(), argv.data(), options);
+}
+
+/**
+ * Non-interactive mode: option parsing, solving a dataset through the library, the JSON and CSV
+ * formats, the solution cache, and the load-error, too-large and usage outcomes.
+ */
+int main() {
+    CliOptions options;
+    CHECK(parse({"--pallets", "p.csv", "--truck=t.csv", "--algo", "ilp", "--threads", "3", "--time-limit=0.5",
+                 "--format", "csv", "--cache", "c.bin", "--perf"}, options));
+    CHECK(options.palletsFile == "p.csv" && options.truckFile == "t.csv" && options.algorithm == "ilp");
+    CHECK(options.threads == 3 && options.timeLimit == 0.5 && options.format == "csv");
+    CHECK(options.cacheFile == "c.bin" && options.perf);
+    vector<vector<string>> invalid = {
+        {},
+        {"--algo", "dp"},
+        {"--pallets", "p.csv", "--threads", "-1"},
+        {"--pallets", "p.csv", "--threads", "2x"},
+        {"--pallets", "p.csv", "--time-limit", "-1"},
+        {"--pallets", "p.csv", "--format", "xml"},
+        {"--pallets", "p.csv", "--colour", "red"},
+        {"--pallets"},
+    };
+    for (const vector<string>& arguments : invalid) {
+        CliOptions rejected;
+        CHECK(!parse(arguments, rejected));
+    }
+
+    filesystem::path directory = testDirectory("cli");
+    ofstream(directory / "Pallets.csv") << "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n";
+    ofstream(directory / "Truck.csv") << "Capacity,Pallets\n100,3\n";
+    CliOptions solve;
+    solve.palletsFile = (directory / "Pallets.csv").string();
+    solve.truckFile = (directory / "Truck.csv").string();
+    solve.algorithm = "dp";
+    CliResult result = solveCli(solve);
+    CHECK(result.status == "optimal" && result.algorithm == "dp");
+    CHECK(result.n == 3 && result.capacity == 100 && result.profit == 18 && result.weight == 100);
+    CHECK(result.pallets == vector<int>({1, 3}) && !result.solutionCached);
+
+    JsonValue json;
+    CHECK(JsonValue::parse(formatCliResult(result, "json"), json));
+    CHECK(json["status"].asString() == "optimal" && json["profit"].asNumber() == 18);
+    CHECK(json["pallets"].items().size() == 2 && json["stats"].isObject() && json["timing"]["total_ms"].isNumber());
+    stringstream csv(formatCliResult(result, "csv"));
+    string header, row;
+    CHECK(getline(csv, header) && getline(csv, row));
+    CHECK(header == "algorithm,status,n,capacity,profit,weight,load_ms,solve_ms,pallets");
+    CHECK(row.rfind("dp,optimal,3,100,18,100,", 0) == 0 && row.substr(row.rfind(',') + 1) == "1 3");
+
+    // The second run is answered from the on-disk cache
+    solve.cacheFile = (directory / "solutions.bin").string();
+    CHECK(!solveCli(solve).solutionCached);
+    CliResult cached = solveCli(solve);
+    CHECK(cached.solutionCached && cached.profit == 18 && cached.pallets == result.pallets);
+
+    // A missing file and an instance the solver cannot handle are results, not crashes
+    CliOptions missing = solve;
+    missing.palletsFile = (directory / "Missing.csv").string();
+    CHECK(solveCli(missing).status == "load-error");
+    {
+        ofstream pallets(directory / "Large.csv");
+        pallets << "Pallet,Weight,Profit\n";
+        for (int i = 1; i <= 30; i++) pallets << i << "," << i << "," << i << "\n";
+        ofstream(directory / "LargeTruck.csv") << "Capacity,Pallets\n100,30\n";
+    }
+    CliOptions large;
+    large.palletsFile = (directory / "Large.csv").string();
+    large.truckFile = (directory / "LargeTruck.csv").string();
+    large.algorithm = "bf";
+    CliResult tooLarge = solveCli(large);
+    CHECK(tooLarge.status == "too-large" && tooLarge.n == 30 && tooLarge.pallets.empty());
+
+    // Usage errors exit with 2 before anything is loaded
+    vector<string> unknown = {"untitled2", "--pallets", solve.palletsFile, "--algo", "simplex"};
+    vector<char*> argv;
+    for (string& argument : unknown) argv.push_back(argument.data());
+    CHECK(runCommandLine(argv.size(), argv.data()) == 2);
+    filesystem::remove_all(directory);
+    return 0;
+}
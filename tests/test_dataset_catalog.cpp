@@ -0,0 +1,104 @@
+#include <fstream>
+#include <vector>
+#include "dataset_catalog.h"
+#include "knapsack.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Saves a catalog and loads it back for the given columns.
+ */
+static bool roundTrip(const string& file, const DatasetCatalog& saved, const vector<unsigned int>& values,
+                      const vector<unsigned int>& weights, unsigned int capacity, DatasetCatalog& loaded) {
+    CHECK(saveCatalog(file, saved));
+    return loadCatalog(file, values.data(), weights.data(), values.size(), capacity, loaded);
+}
+
+/**
+ * Catalog sidecars: a valid round trip, tampered, stale, truncated and missing sidecars, and
+ * that the solvers give the same answers with or without a catalog (valid or not).
+ */
+int main() {
+    vector<unsigned int> values = {10, 7, 8, 3, 9, 7, 5}, weights = {5, 4, 6, 2, 7, 4, 3};
+    unsigned int capacity = 12;
+    DatasetCatalog catalog;
+    buildCatalog(values.data(), weights.data(), values.size(), capacity, catalog);
+    CHECK(catalog.classes == 6);
+    CHECK(catalog.duplicateClass[1] == catalog.duplicateClass[5]);
+    CHECK(catalog.prefixWeight.back() == 31 && catalog.prefixProfit.back() == 49);
+    CHECK(catalogMatches(catalog, values.data(), weights.data(), values.size(), capacity));
+
+    filesystem::path directory = testDirectory("dataset_catalog");
+    string file = catalogPath((directory / "Pallets_01.csv").string());
+    CHECK(file == (directory / "Pallets_01.csv.catalog").string());
+    DatasetCatalog loaded;
+    CHECK(roundTrip(file, catalog, values, weights, capacity, loaded));
+    CHECK(loaded.ratioOrder == catalog.ratioOrder && loaded.prefixProfit == catalog.prefixProfit);
+
+    // Built for other columns or another capacity
+    vector<unsigned int> otherValues = values;
+    otherValues[0]++;
+    CHECK(!roundTrip(file, catalog, otherValues, weights, capacity, loaded));
+    CHECK(!roundTrip(file, catalog, values, weights, capacity + 1, loaded));
+
+    // A ratio order that is not a permutation, or not sorted by ratio
+    DatasetCatalog tampered = catalog;
+    tampered.ratioOrder[0] = 99;
+    CHECK(!roundTrip(file, tampered, values, weights, capacity, loaded));
+    tampered = catalog;
+    tampered.ratioOrder[1] = tampered.ratioOrder[0];
+    CHECK(!roundTrip(file, tampered, values, weights, capacity, loaded));
+    tampered = catalog;
+    swap(tampered.ratioOrder.front(), tampered.ratioOrder.back());
+    CHECK(!roundTrip(file, tampered, values, weights, capacity, loaded));
+    CHECK(!catalogMatches(tampered, values.data(), weights.data(), values.size(), capacity));
+
+    // Wrong prefix sums are recomputed on load, and never trusted in memory
+    tampered = catalog;
+    tampered.prefixProfit[3] += 100;
+    CHECK(roundTrip(file, tampered, values, weights, capacity, loaded));
+    CHECK(loaded.prefixProfit == catalog.prefixProfit);
+    CHECK(!catalogMatches(tampered, values.data(), weights.data(), values.size(), capacity));
+
+    // Truncated, garbage and missing files
+    CHECK(saveCatalog(file, catalog));
+    filesystem::resize_file(file, filesystem::file_size(file) - 5);
+    CHECK(!loadCatalog(file, values.data(), weights.data(), values.size(), capacity, loaded));
+    ofstream(file, ios::trunc) << "not a catalog";
+    CHECK(!loadCatalog(file, values.data(), weights.data(), values.size(), capacity, loaded));
+    filesystem::remove(file);
+    CHECK(!loadCatalog(file, values.data(), weights.data(), values.size(), capacity, loaded));
+
+    // The solvers ignore a catalog that does not match and answer the same with a valid one
+    tampered = catalog;
+    swap(tampered.ratioOrder.front(), tampered.ratioOrder.back());
+    KnapsackInstance plain(weights, values, capacity);
+    for (const SolverInfo& info : knapsackSolvers()) {
+        if (info.name == "ga" || info.name == "sa") continue;
+        unique_ptr<Solver> solver = Solver::create(info.name);
+        if (!solver->fits(plain)) continue;
+        KnapsackSolution expected;
+        solver->solve(plain, KnapsackOptions(), expected);
+        for (const DatasetCatalog* offered : {&catalog, &tampered}) {
+            KnapsackInstance instance = plain;
+            instance.catalog = offered;
+            KnapsackSolution solution;
+            solver->solve(instance, KnapsackOptions(), solution);
+            CHECK(solution.selected == expected.selected);
+            CHECK(solution.profit == expected.profit);
+        }
+    }
+
+    // A bound catalog is only visible on its own columns and size
+    {
+        CatalogScope scope(&catalog, values.data(), weights.data());
+        CHECK(boundCatalog(values.data(), weights.data(), values.size(), capacity) == &catalog);
+        CHECK(boundCatalog(values.data(), weights.data(), values.size() - 1, capacity) == nullptr);
+        CHECK(boundCatalog(otherValues.data(), weights.data(), values.size(), capacity) == nullptr);
+    }
+    CHECK(boundCatalog(values.data(), weights.data(), values.size(), capacity) == nullptr);
+
+    filesystem::remove_all(directory);
+    return 0;
+}
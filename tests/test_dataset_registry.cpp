@@ -0,0 +1,89 @@
+#include <fstream>
+#include "dataset.h"
+#include "data_loader.h"
+#include "dataset_registry.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Writes a file with the given contents.
+ */
+static string writeFile(const filesystem::path& path, const string& contents) {
+    ofstream(path, ios::trunc) << contents;
+    return path.string();
+}
+
+/**
+ * Instance loading and the dataset registry: valid, empty, header-only, malformed and missing
+ * files, caching, reloading after a change, prefetching and the entry bound.
+ */
+int main() {
+    filesystem::path directory = testDirectory("dataset_registry");
+    string pallets = writeFile(directory / "Pallets_01.csv", "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n");
+    string truck = writeFile(directory / "TruckAndPallets_01.csv", "Capacity,Pallets\n100,3\n");
+    string headerOnly = writeFile(directory / "Pallets_02.csv", "Pallet,Weight,Profit\n");
+    string malformed = writeFile(directory / "Pallets_03.csv", "Pallet,Weight,Profit\n1,heavy,10\n");
+    string emptyTruck = writeFile(directory / "TruckAndPallets_04.csv", "Capacity,Pallets\n100,0\n");
+    string noCapacity = writeFile(directory / "TruckAndPallets_05.csv", "Capacity,Pallets\n0,3\n");
+    string missing = (directory / "Pallets_missing.csv").string();
+
+    // The loader reports every failure with a reason
+    vector<Pallet> loaded;
+    Truck loadedTruck;
+    string error;
+    CHECK(load_instance(pallets, truck, loaded, loadedTruck, &error));
+    CHECK(loaded.size() == 3 && loadedTruck.capacity == 100 && loadedTruck.pallets == 3);
+    CHECK(loaded[2].weight == 30 && loaded[2].profit == 8);
+    for (const pair<string, string>& files : {make_pair(headerOnly, truck), make_pair(missing, truck), make_pair(pallets, noCapacity)}) {
+        error.clear();
+        CHECK(!load_instance(files.first, files.second, loaded, loadedTruck, &error));
+        CHECK(!error.empty());
+    }
+
+    // Failures come back as errors, not exceptions, and are not cached
+    DatasetRegistry registry(2);
+    bool cached;
+    for (const string& file : {headerOnly, malformed, missing}) {
+        error.clear();
+        CHECK(registry.get(file, truck, &cached, nullptr, &error) == nullptr);
+        CHECK(!error.empty());
+    }
+    CHECK(registry.get(headerOnly, truck, &cached) == nullptr);
+    CHECK(!cached);
+
+    // A truck that takes no pallets is a valid, empty instance
+    shared_ptr<const LoadedDataset> empty = registry.get(pallets, emptyTruck);
+    CHECK(empty != nullptr && empty->truck.pallets == 0);
+
+    // The second request is served from the cache until a file changes
+    shared_ptr<const LoadedDataset> first = registry.get(pallets, truck, &cached);
+    CHECK(first != nullptr && !cached && first->pallets.size() == 3);
+    CHECK(registry.get(pallets, truck, &cached) == first && cached);
+    writeFile(pallets, "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n4,20,6\n");
+    shared_ptr<const LoadedDataset> reloaded = registry.get(pallets, truck, &cached);
+    CHECK(!cached && reloaded->pallets.size() == 4);
+    CHECK(first->pallets.size() == 3);
+
+    // Fixing a file that failed makes the next request succeed
+    writeFile(headerOnly, "Pallet,Weight,Profit\n1,10,1\n");
+    CHECK(registry.get(headerOnly, truck) != nullptr);
+
+    // A prefetched dataset is not parsed again
+    string otherTruck = writeFile(directory / "TruckAndPallets_06.csv", "Capacity,Pallets\n50,3\n");
+    registry.prefetch(pallets, otherTruck);
+    shared_ptr<const LoadedDataset> prefetched = registry.get(pallets, otherTruck, &cached);
+    CHECK(prefetched != nullptr && cached && prefetched->truck.capacity == 50);
+
+    // Only two entries are kept: the least recently used one is parsed again
+    DatasetRegistry bounded(2);
+    shared_ptr<const LoadedDataset> kept = bounded.get(pallets, truck);
+    CHECK(bounded.get(pallets, otherTruck) != nullptr);
+    CHECK(bounded.get(pallets, truck, &cached) == kept && cached);
+    CHECK(bounded.get(pallets, emptyTruck, &cached) != nullptr && !cached);
+    CHECK(bounded.get(pallets, truck, &cached) == kept && cached);
+    CHECK(bounded.get(pallets, otherTruck, &cached) != nullptr && !cached);
+
+    filesystem::remove_all(directory);
+    return 0;
+}
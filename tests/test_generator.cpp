@@ -0,0 +1,80 @@
+#include <vector>
+#include "dataset.h"
+#include "data_loader.h"
+#include "generator.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * Instance generator: option checks, determinism, per-family coefficient shapes, and the CSV and
+ * binary writers read back by the loaders.
+ */
+int main() {
+    string error;
+    GeneratorOptions options;
+    CHECK(validGeneratorOptions(options, error));
+    GeneratorOptions bad = options;
+    bad.family = "no-such-family";
+    CHECK(!validGeneratorOptions(bad, error) && !error.empty());
+    bad = options;
+    bad.n = 0;
+    CHECK(!validGeneratorOptions(bad, error));
+    bad = options;
+    bad.range = 0;
+    CHECK(!validGeneratorOptions(bad, error));
+
+    filesystem::path directory = testDirectory("generator");
+    for (const string& family : generatorFamilies()) {
+        options.family = family;
+        options.n = 300;
+        options.range = 100;
+        options.seed = 42;
+        CHECK(validGeneratorOptions(options, error));
+
+        // The same seed gives the same items, in memory or one at a time
+        vector<unsigned int> weights, profits, againWeights, againProfits;
+        unsigned int capacity = generateInstance(options, weights, profits);
+        CHECK(weights.size() == options.n && profits.size() == options.n);
+        CHECK(generateInstance(options, againWeights, againProfits) == capacity);
+        CHECK(weights == againWeights && profits == againProfits);
+        unsigned long long total = 0;
+        for (unsigned long long i = 0; i < options.n; i++) {
+            unsigned int weight, profit;
+            generateItem(options, i, weight, profit);
+            CHECK(weight == weights[i] && profit == profits[i]);
+            CHECK(weight >= 1);
+            if (family == "subset-sum") CHECK(profit == weight);
+            if (family == "strongly-correlated") CHECK(profit == weight + options.range / 10);
+            if (family == "inverse-strongly-correlated") CHECK(weight == profit + options.range / 10);
+            total += weight;
+        }
+        CHECK(capacity > 0 && capacity <= total);
+        GeneratorOptions reseeded = options;
+        reseeded.seed = 43;
+        generateInstance(reseeded, againWeights, againProfits);
+        CHECK(weights != againWeights || profits != againProfits);
+
+        // Both formats load back as the same instance
+        string pallets = (directory / ("Pallets_" + family + ".csv")).string();
+        string truck = (directory / ("TruckAndPallets_" + family + ".csv")).string();
+        string binary = (directory / (family + ".knap")).string();
+        CHECK(writeInstanceCSV(options, pallets, truck));
+        CHECK(writeInstanceBinary(options, binary));
+        for (const pair<string, string>& files : {make_pair(pallets, truck), make_pair(binary, string())}) {
+            vector<Pallet> loaded;
+            Truck loadedTruck;
+            CHECK(load_instance(files.first, files.second, loaded, loadedTruck, &error));
+            CHECK(loaded.size() == options.n);
+            CHECK((unsigned int) loadedTruck.capacity == capacity);
+            CHECK((unsigned long long) loadedTruck.pallets == options.n);
+            for (unsigned long long i = 0; i < options.n; i++) {
+                CHECK(loaded[i].pallet == (int) i + 1);
+                CHECK((unsigned int) loaded[i].weight == weights[i] && (unsigned int) loaded[i].profit == profits[i]);
+            }
+        }
+    }
+
+    filesystem::remove_all(directory);
+    return 0;
+}
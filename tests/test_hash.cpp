@@ -0,0 +1,28 @@
+#include <cstring>
+#include <vector>
+#include "hash.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * xxHash64: reference vectors, seeds, and inputs that cross the 32-byte stripe boundary.
+ */
+int main() {
+    CHECK(xxHash64("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(xxHash64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+    CHECK(xxHash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+    const char* sentence = "Nobody inspects the spammish repetition";
+    CHECK(xxHash64(sentence, strlen(sentence)) == 0xFBCEA83C8A378BF1ULL);
+    CHECK(xxHash64("abc", 3, 1) != xxHash64("abc", 3));
+
+    // Every length up to a few stripes hashes differently and does not read past the end
+    vector<unsigned char> bytes(100);
+    for (size_t i = 0; i < bytes.size(); i++) bytes[i] = i * 37 + 11;
+    for (size_t length = 1; length < bytes.size(); length++) {
+        CHECK(xxHash64(bytes.data(), length) != xxHash64(bytes.data(), length - 1));
+        vector<unsigned char> copy(bytes.begin(), bytes.begin() + length);
+        CHECK(xxHash64(copy.data(), length) == xxHash64(bytes.data(), length));
+    }
+    return 0;
+}
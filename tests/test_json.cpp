@@ -0,0 +1,39 @@
+#include "json.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * JSON reader and quoting: every value type, nesting, escapes, quoting round trips and syntax
+ * errors.
+ */
+int main() {
+    JsonValue value;
+    string error;
+    CHECK(JsonValue::parse(" {\"b\": [1, -2.5e1, true, false, null], \"a\": {\"s\": \"x\\\"y\\n\\u0041\"}} ", value, &error));
+    CHECK(value.isObject() && value.members().size() == 2);
+    CHECK(value.members().begin()->first == "a");
+    const JsonValue& list = value["b"];
+    CHECK(list.isArray() && list.items().size() == 5);
+    CHECK(list.items()[0].asNumber() == 1 && list.items()[1].asNumber() == -25);
+    CHECK(list.items()[2].asBool() && !list.items()[3].asBool(true) && list.items()[4].isNull());
+    CHECK(value["a"]["s"].asString() == "x\"y\nA");
+    CHECK(value.has("a") && !value.has("c"));
+    CHECK(value["c"].isNull() && value["b"]["x"].isNull());
+    CHECK(value["a"].asNumber(7) == 7);
+
+    CHECK(JsonValue::parse("[0, -0.5e+3, 1E2, 12.25]", value));
+    CHECK(value.items()[1].asNumber() == -500 && value.items()[2].asNumber() == 100 && value.items()[3].asNumber() == 12.25);
+
+    string awkward = "tab\tquote\" backslash\\ newline\n control\x01 caf\xc3\xa9";
+    CHECK(JsonValue::parse(jsonQuote(awkward), value));
+    CHECK(value.isString() && value.asString() == awkward);
+
+    for (const char* text : {"", "{", "[1,]", "{\"a\" 1}", "{\"a\": 1,}", "tru", "01", "1.", "-", ".5", "1e", "inf", "0x10", "+1",
+                             "\"open", "[1] 2", "{1: 2}", "\"bad \\u00zz\"", "\"bad \\q escape\""}) {
+        error.clear();
+        CHECK(!JsonValue::parse(text, value, &error));
+        CHECK(!error.empty());
+    }
+    return 0;
+}
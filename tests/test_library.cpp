@@ -0,0 +1,90 @@
+#include <vector>
+#include "knapsack.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Best profit of an instance by enumerating every subset.
+ */
+static unsigned int bruteForce(const vector<unsigned int>& weights, const vector<unsigned int>& profits, unsigned int capacity) {
+    unsigned int best = 0;
+    for (unsigned int mask = 0; mask < (1u << weights.size()); mask++) {
+        unsigned long long weight = 0, profit = 0;
+        for (unsigned int i = 0; i < weights.size(); i++) {
+            if (mask >> i & 1) {
+                weight += weights[i];
+                profit += profits[i];
+            }
+        }
+        if (weight <= capacity && profit > best) best = profit;
+    }
+    return best;
+}
+
+/**
+ * @brief Checks that a solution is feasible and that its profit and weight match its selection.
+ */
+static void checkConsistent(const KnapsackInstance& instance, const KnapsackSolution& solution) {
+    CHECK(solution.selected.size() == instance.n);
+    unsigned long long weight = 0, profit = 0;
+    for (unsigned int i = 0; i < instance.n; i++) {
+        if (solution.selected[i]) {
+            weight += instance.weights[i];
+            profit += instance.profits[i];
+        }
+    }
+    CHECK(weight == solution.weight);
+    CHECK(profit == solution.profit);
+    CHECK(weight <= instance.capacity);
+}
+
+/**
+ * Library API: every registered solver through Solver, on a small instance, an empty instance
+ * and with a cancelled token.
+ */
+int main() {
+    CHECK(Solver::create("no-such-solver") == nullptr);
+
+    vector<unsigned int> weights = {23, 31, 29, 44, 53, 38, 63, 85, 89, 82, 12, 7};
+    vector<unsigned int> profits = {92, 57, 49, 68, 60, 43, 67, 84, 87, 72, 15, 9};
+    KnapsackInstance instance(weights, profits, 165);
+    unsigned int optimum = bruteForce(weights, profits, instance.capacity);
+
+    KnapsackOptions options;
+    options.timeLimit = 0.05;
+    for (const SolverInfo& info : knapsackSolvers()) {
+        unique_ptr<Solver> solver = Solver::create(info.name);
+        CHECK(solver != nullptr);
+        CHECK(solver->name() == info.name);
+        if (!solver->fits(instance)) continue;
+
+        KnapsackSolution solution;
+        solver->solve(instance, options, solution);
+        checkConsistent(instance, solution);
+        CHECK(solution.profit <= optimum);
+        if (solver->exact()) {
+            CHECK(solution.profit == optimum);
+            CHECK(solution.status == SolveStatus::Optimal);
+        }
+
+        // An empty instance is answered without running the solver
+        KnapsackInstance empty(weights.data(), profits.data(), 0, instance.capacity);
+        KnapsackSolution none;
+        solver->solve(empty, options, none);
+        CHECK(none.profit == 0);
+        CHECK(none.weight == 0);
+        CHECK(none.selected.empty());
+        CHECK(none.status == SolveStatus::Optimal);
+
+        // A cancelled solve still returns a feasible solution
+        CancellationToken token;
+        token.cancel();
+        KnapsackOptions cancelled;
+        cancelled.cancel = &token;
+        KnapsackSolution partial;
+        solver->solve(instance, cancelled, partial);
+        checkConsistent(instance, partial);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <random>
+#include <vector>
+#include "algorithms.h"
+#include "local_search.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Value of a selection, after checking that it fits.
+ */
+static unsigned int selectionValue(const vector<unsigned int>& values, const vector<unsigned int>& weights,
+                                   unsigned int capacity, const vector<char>& used) {
+    unsigned long long weight = 0, value = 0;
+    for (size_t i = 0; i < used.size(); i++) {
+        if (used[i]) {
+            weight += weights[i];
+            value += values[i];
+        }
+    }
+    CHECK(weight <= capacity);
+    return value;
+}
+
+/**
+ * Local search after greedy: never worse than its start, a local optimum for additions when
+ * unbudgeted, reproducible with a move budget, and harmless when cancelled.
+ */
+int main() {
+    mt19937 rng(9);
+    for (int run = 0; run < 100; run++) {
+        unsigned int n = 5 + rng() % 60;
+        vector<unsigned int> values(n), weights(n);
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            weights[i] = 1 + rng() % 100;
+            values[i] = 1 + rng() % 100;
+            total += weights[i];
+        }
+        unsigned int capacity = total / 3;
+        vector<char> start(n), used(n);
+        unsigned int greedy = knapsackGreedy(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(start.data()));
+        unsigned int optimum = knapsackDP1(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()));
+
+        for (unsigned int threads : {1u, 3u}) {
+            used = start;
+            unsigned int value = localSearch(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()), 0, threads);
+            CHECK(selectionValue(values, weights, capacity, used) == value);
+            CHECK(value >= greedy && value <= optimum);
+            unsigned long long weight = 0;
+            for (unsigned int i = 0; i < n; i++) weight += used[i] ? weights[i] : 0;
+            for (unsigned int i = 0; i < n; i++) CHECK(used[i] || weight + weights[i] > capacity);
+        }
+
+        // A move budget without a time limit gives the same result on any thread count
+        vector<char> single = start, parallel = start;
+        unsigned int a = localSearch(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(single.data()), 0, 1, nullptr, 3);
+        unsigned int b = localSearch(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(parallel.data()), 0, 4, nullptr, 3);
+        CHECK(a == b && single == parallel);
+
+        CancellationToken token;
+        token.cancel();
+        used = start;
+        CHECK(localSearch(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()), 0, 2, &token) >= greedy);
+        CHECK(selectionValue(values, weights, capacity, used) >= greedy);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "algorithms.h"
+#include "metaheuristics.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Value of a selection, after checking that it fits.
+ */
+static unsigned int selectionValue(const vector<unsigned int>& values, const vector<unsigned int>& weights,
+                                   unsigned int capacity, const vector<char>& used) {
+    unsigned long long weight = 0, value = 0;
+    for (size_t i = 0; i < used.size(); i++) {
+        if (used[i]) {
+            weight += weights[i];
+            value += values[i];
+        }
+    }
+    CHECK(weight <= capacity);
+    return value;
+}
+
+/**
+ * Genetic algorithm and parallel-tempering annealing: feasible answers, reproducible runs with a
+ * fixed seed and generation budget, and prompt stops on a time limit or cancellation.
+ */
+int main() {
+    mt19937 rng(21);
+    unsigned int n = 200;
+    vector<unsigned int> values(n), weights(n);
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        weights[i] = 1 + rng() % 1000;
+        values[i] = weights[i] + rng() % 100;
+        total += weights[i];
+    }
+    unsigned int capacity = total / 2;
+    vector<char> used(n);
+    unsigned int optimum = knapsackDP1(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()));
+
+    using Engine = unsigned int (*)(unsigned int[], unsigned int[], unsigned int, unsigned int, bool[], const MetaheuristicOptions&);
+    for (Engine engine : {Engine(knapsackGenetic), Engine(knapsackAnnealing)}) {
+        MetaheuristicOptions options;
+        options.timeLimit = 0;
+        options.generations = 40;
+        options.threads = 2;
+        options.seed = 7;
+        vector<char> first(n), second(n);
+        unsigned int value = engine(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(first.data()), options);
+        CHECK(selectionValue(values, weights, capacity, first) == value);
+        CHECK(value <= optimum && value > 0);
+        CHECK(engine(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(second.data()), options) == value);
+        CHECK(first == second);
+
+        // Progress lines go to the given stream
+        ostringstream progress;
+        options.progress = &progress;
+        options.progressInterval = 1e-9;
+        engine(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(second.data()), options);
+        CHECK(!progress.str().empty());
+
+        MetaheuristicOptions limited;
+        limited.timeLimit = 0.05;
+        limited.threads = 2;
+        auto start = chrono::steady_clock::now();
+        value = engine(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()), limited);
+        CHECK(chrono::duration<double>(chrono::steady_clock::now() - start).count() < 2);
+        CHECK(selectionValue(values, weights, capacity, used) == value);
+
+        CancellationToken token;
+        token.cancel();
+        limited.timeLimit = 0;
+        limited.cancel = &token;
+        value = engine(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()), limited);
+        CHECK(selectionValue(values, weights, capacity, used) == value);
+    }
+    return 0;
+}
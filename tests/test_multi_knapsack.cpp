@@ -0,0 +1,93 @@
+#include <random>
+#include "multi_knapsack.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Best fleet value by trying every truck (or none) for every item (small n only).
+ */
+static unsigned int bruteForce(const vector<unsigned int>& values, const vector<unsigned int>& weights,
+                               const vector<unsigned int>& capacities) {
+    unsigned int best = 0;
+    vector<unsigned long long> loads(capacities.size(), 0);
+    auto place = [&](auto&& self, size_t item, unsigned int value) -> void {
+        if (item == values.size()) {
+            best = max(best, value);
+            return;
+        }
+        self(self, item + 1, value);
+        for (size_t t = 0; t < capacities.size(); t++) {
+            if (loads[t] + weights[item] > capacities[t]) continue;
+            loads[t] += weights[item];
+            self(self, item + 1, value + values[item]);
+            loads[t] -= weights[item];
+        }
+    };
+    place(place, 0, 0);
+    return best;
+}
+
+/**
+ * @brief Checks that every truck is within its capacity, no item is loaded twice, and the
+ * loads add up to the returned value.
+ */
+static void checkLoads(const vector<unsigned int>& values, const vector<unsigned int>& weights,
+                       const vector<unsigned int>& capacities, const vector<vector<unsigned int>>& loads, unsigned int value) {
+    CHECK(loads.size() == capacities.size());
+    vector<int> seen(values.size(), 0);
+    unsigned long long total = 0;
+    for (size_t t = 0; t < loads.size(); t++) {
+        unsigned long long load = 0;
+        for (unsigned int item : loads[t]) {
+            CHECK(item < values.size() && seen[item]++ == 0);
+            load += weights[item];
+            total += values[item];
+        }
+        CHECK(load <= capacities[t]);
+    }
+    CHECK(total == value);
+}
+
+/**
+ * Fleet loading: the branch-and-bound against brute force, the heuristic alone, and node
+ * budgets and cancellation on a larger fleet.
+ */
+int main() {
+    mt19937 rng(11);
+    for (int run = 0; run < 200; run++) {
+        unsigned int n = 1 + rng() % 8, m = 1 + rng() % 3;
+        vector<unsigned int> values(n), weights(n), capacities(m);
+        for (unsigned int i = 0; i < n; i++) {
+            weights[i] = 1 + rng() % 50;
+            values[i] = 1 + rng() % 60;
+        }
+        for (unsigned int& capacity : capacities) capacity = 10 + rng() % 80;
+        unsigned int optimum = bruteForce(values, weights, capacities);
+
+        vector<vector<unsigned int>> loads;
+        bool optimal = false;
+        unsigned int value = knapsackMultiple(values.data(), weights.data(), n, capacities, loads, 2000000, &optimal);
+        CHECK(value == optimum && optimal);
+        checkLoads(values, weights, capacities, loads, value);
+
+        value = knapsackMultiple(values.data(), weights.data(), n, capacities, loads, 0);
+        CHECK(value <= optimum);
+        checkLoads(values, weights, capacities, loads, value);
+    }
+
+    unsigned int n = 400;
+    vector<unsigned int> values(n), weights(n), capacities = {900, 700, 1200, 500};
+    for (unsigned int i = 0; i < n; i++) {
+        weights[i] = 20 + rng() % 200;
+        values[i] = weights[i] + rng() % 40;
+    }
+    vector<vector<unsigned int>> loads;
+    unsigned int value = knapsackMultiple(values.data(), weights.data(), n, capacities, loads, 1000);
+    checkLoads(values, weights, capacities, loads, value);
+    CancellationToken token;
+    token.cancel();
+    value = knapsackMultiple(values.data(), weights.data(), n, capacities, loads, 2000000, nullptr, &token);
+    checkLoads(values, weights, capacities, loads, value);
+    return 0;
+}
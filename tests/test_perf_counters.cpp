@@ -0,0 +1,42 @@
+#include "json.h"
+#include "perf_counters.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * Hardware counters: readings and their JSON form, and PerfCounters working where the kernel
+ * allows it and degrading to "unavailable" with a reason where it does not.
+ */
+int main() {
+    PerfReading none;
+    CHECK(!none.anyAvailable() && none.ipc() == -1);
+    CHECK(perfJSON(none) == "null");
+
+    PerfReading partial;
+    partial.value[PerfCycles] = 200;
+    partial.value[PerfInstructions] = 500;
+    CHECK(partial.anyAvailable() && partial.ipc() == 2.5);
+    JsonValue json;
+    CHECK(JsonValue::parse(perfJSON(partial), json));
+    CHECK(json["cycles"].asNumber() == 200 && json["instructions"].asNumber() == 500);
+    CHECK(json["ipc"].asNumber() == 2.5 && json["llc_misses"].isNull());
+    partial.value[PerfCycles] = -1;
+    CHECK(JsonValue::parse(perfJSON(partial), json) && json["ipc"].isNull());
+
+    // Containers and CI machines often forbid perf_event_open; both outcomes must be consistent
+    PerfCounters counters;
+    CHECK(counters.available() == counters.error().empty());
+    counters.start();
+    volatile unsigned long long sum = 0;
+    for (unsigned int i = 0; i < 1000000; i++) sum = sum + i;
+    PerfReading reading = counters.stop();
+    if (counters.available()) {
+        for (int e = 0; e < PerfEventCount; e++) {
+            CHECK(reading.value[e] >= -1);
+        }
+    } else {
+        CHECK(!reading.anyAvailable());
+    }
+    return 0;
+}
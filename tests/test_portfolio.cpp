@@ -0,0 +1,98 @@
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "portfolio.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Value of a selection, after checking that it fits.
+ */
+static unsigned int selectionValue(const vector<unsigned int>& values, const vector<unsigned int>& weights,
+                                   unsigned int capacity, const vector<char>& used) {
+    unsigned long long weight = 0, value = 0;
+    for (size_t i = 0; i < used.size(); i++) {
+        if (used[i]) {
+            weight += weights[i];
+            value += values[i];
+        }
+    }
+    CHECK(weight <= capacity);
+    return value;
+}
+
+/**
+ * Portfolio racing: the winner's solution is optimal and logged once per race, and an outer
+ * cancellation returns a feasible solution without logging.
+ */
+int main() {
+    filesystem::path directory = testDirectory("portfolio");
+    string log = (directory / "portfolio.log").string();
+    mt19937 rng(35);
+    const int runs = 30;
+    for (int run = 0; run < runs; run++) {
+        unsigned int n = 1 + rng() % 50;
+        vector<unsigned int> values(n), weights(n);
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            weights[i] = 1 + rng() % 300;
+            values[i] = 1 + rng() % 300;
+            total += weights[i];
+        }
+        unsigned int capacity = total / 2;
+        vector<char> used(n), reference(n);
+        string winner;
+        SolveStatus status;
+        unsigned int value = knapsackPortfolio(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()),
+                                               &winner, log, nullptr, &status);
+        CHECK(value == knapsackDP1(values.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(reference.data())));
+        CHECK(selectionValue(values, weights, capacity, used) == value);
+        CHECK(status == SolveStatus::Optimal);
+        CHECK(winner == "dp" || winner == "ilp" || (winner == "mitm" && n <= 44));
+    }
+
+    // One "n,maxWeight,profitSum,correlation,winner,seconds" line per race
+    ifstream file(log);
+    string line;
+    int lines = 0;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string field;
+        int fields = 0;
+        while (getline(ss, field, ',')) fields++;
+        CHECK(fields == 6);
+        lines++;
+    }
+    CHECK(lines == runs);
+    file.close();
+
+    // Stopped from outside: the best solution any racer holds, nothing logged
+    unsigned int n = 40;
+    vector<unsigned int> values(n), weights(n);
+    for (unsigned int i = 0; i < n; i++) {
+        weights[i] = 1 + rng() % 1000;
+        values[i] = weights[i] + rng() % 10;
+    }
+    vector<char> used(n);
+    CancellationToken token;
+    token.cancel();
+    string winner = "unset";
+    SolveStatus status;
+    unsigned int value = knapsackPortfolio(values.data(), weights.data(), n, 10000, reinterpret_cast<bool*>(used.data()),
+                                           &winner, log, &token, &status);
+    CHECK(selectionValue(values, weights, 10000, used) == value);
+    CHECK(status == SolveStatus::Cancelled && winner.empty());
+    ifstream again(log);
+    lines = 0;
+    while (getline(again, line)) lines++;
+    CHECK(lines == runs);
+
+    // The empty instance has no winner
+    CHECK(knapsackPortfolio(nullptr, nullptr, 0, 10, nullptr, &winner, log) == 0 && winner.empty());
+    filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "json.h"
+#include "server.h"
+#include "shared_instance.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief A client connection to the daemon that sends one request and reads its response.
+ */
+class Client {
+public:
+    explicit Client(const string& path) {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, path.c_str());
+        // The daemon starts listening on its own thread
+        for (int attempt = 0; attempt < 500; attempt++) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (connect(fd, (sockaddr*) &address, sizeof(address)) == 0) return;
+            close(fd);
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        CHECK(!"could not connect to the daemon");
+    }
+    ~Client() { close(fd); }
+
+    JsonValue request(const string& line) {
+        string text = line + "\n";
+        CHECK(write(fd, text.data(), text.size()) == (ssize_t) text.size());
+        size_t end;
+        while ((end = pending.find('\n')) == string::npos) {
+            char buffer[4096];
+            ssize_t got = read(fd, buffer, sizeof(buffer));
+            CHECK(got > 0);
+            pending.append(buffer, got);
+        }
+        JsonValue response;
+        CHECK(JsonValue::parse(pending.substr(0, end), response));
+        pending.erase(0, end + 1);
+        return response;
+    }
+
+private:
+    int fd = -1;
+    string pending;
+};
+
+/**
+ * Solver daemon over a Unix socket: inline, file and shared memory instances, the solution
+ * cache, empty instances, malformed requests and shutdown.
+ */
+int main() {
+    filesystem::path directory = testDirectory("server");
+    ofstream(directory / "Pallets_01.csv") << "Pallet,Weight,Profit\n1,70,10\n2,60,5\n3,30,8\n";
+    ofstream(directory / "TruckAndPallets_01.csv") << "Capacity,Pallets\n100,3\n";
+    ofstream(directory / "TruckAndPallets_02.csv") << "Capacity,Pallets\n100,0\n";
+    ofstream(directory / "Pallets_03.csv") << "Pallet,Weight,Profit\n";
+    string files = "\"pallets_file\": \"" + (directory / "Pallets_01.csv").string() + "\", \"truck_file\": \"";
+
+    ServerOptions options;
+    options.socketPath = (directory / "daemon.sock").string();
+    options.threads = 2;
+    int status = -1;
+    thread daemon([&]() { status = runServer(options); });
+    {
+        Client client(options.socketPath);
+
+        string instance = "\"capacity\": 100, \"pallets\": [{\"weight\": 70, \"profit\": 10}, {\"weight\": 60, \"profit\": 5}, "
+                          "{\"weight\": 30, \"profit\": 8}]";
+        JsonValue response = client.request("{\"id\": 1, \"algo\": \"dp\", " + instance + "}");
+        CHECK(response["id"].asNumber() == 1);
+        CHECK(response["result"]["profit"].asNumber() == 18);
+        CHECK(response["result"]["status"].asString() == "optimal");
+        CHECK(!response["result"]["solution_cached"].asBool());
+        response = client.request("{\"id\": 2, \"algo\": \"dp\", " + instance + "}");
+        CHECK(response["result"]["profit"].asNumber() == 18);
+        CHECK(response["result"]["solution_cached"].asBool());
+        string reversed = "\"capacity\": 100, \"pallets\": [{\"weight\": 30, \"profit\": 8}, {\"weight\": 60, \"profit\": 5}, "
+                          "{\"weight\": 70, \"profit\": 10}]";
+        response = client.request("{\"id\": 2, \"algo\": \"dp\", " + reversed + "}");
+        CHECK(response["result"]["profit"].asNumber() == 18);
+        CHECK(!response["result"]["solution_cached"].asBool());
+
+        response = client.request("{\"id\": 3, \"algo\": \"ilp\", " + files + (directory / "TruckAndPallets_01.csv").string() + "\"}");
+        CHECK(response["result"]["profit"].asNumber() == 18);
+        response = client.request("{\"id\": 4, " + files + (directory / "TruckAndPallets_02.csv").string() + "\"}");
+        CHECK(response["result"]["profit"].asNumber() == 0);
+        CHECK(response["result"]["status"].asString() == "optimal");
+
+        // The solution is written back into the segment
+        string segment = "/knapsack-server-test-" + to_string(getpid());
+        unsigned int weights[] = {70, 60, 30}, profits[] = {10, 5, 8};
+        CHECK(createSharedInstance(segment, weights, profits, 3, 100));
+        response = client.request("{\"id\": 5, \"algo\": \"dp\", \"shm\": \"" + segment + "\"}");
+        CHECK(response["result"]["profit"].asNumber() == 18);
+        SharedInstance shared;
+        CHECK(shared.open(segment));
+        CHECK(shared.state() == SharedOptimal && shared.profit() == 18);
+        CHECK(shared.selected(0) && !shared.selected(1) && shared.selected(2));
+        shm_unlink(segment.c_str());
+
+        // A dataset that cannot be loaded is reported in the result
+        response = client.request("{\"id\": 6, \"pallets_file\": \"" + (directory / "Pallets_03.csv").string() +
+                                  "\", \"truck_file\": \"" + (directory / "TruckAndPallets_01.csv").string() + "\"}");
+        CHECK(response["result"]["status"].asString() == "load-error");
+
+        // Bad requests are answered with an error, and the daemon keeps serving
+        vector<string> badRequests = {"{\"id\": 6, \"threads\": \"x\", " + instance + "}",
+                                      "{\"id\": 6, \"threads\": 1e12, " + instance + "}",
+                                      "{\"id\": 6, \"algo\": \"no-such-solver\", " + instance + "}",
+                                      "{\"id\": 6, \"capacity\": 100, \"pallets\": []}",
+                                      "{\"id\": 6, \"capacity\": -1, \"pallets\": [{\"weight\": 1, \"profit\": 1}]}",
+                                      "{\"id\": 6, \"shm\": \"/knapsack-no-such-segment\"}",
+                                      "{\"id\": 6}"};
+        for (const string& bad : badRequests) {
+            response = client.request(bad);
+            CHECK(response["id"].asNumber() == 6);
+            CHECK(response["error"].isString());
+        }
+        response = client.request("{\"id\": ");
+        CHECK(response["id"].isNull() && response["error"].isString());
+
+        response = client.request("{\"id\": 7, \"op\": \"stats\"}");
+        CHECK(response["solution_cache"]["memory_hits"].asNumber() >= 1);
+        response = client.request("{\"id\": 8, \"op\": \"shutdown\"}");
+        CHECK(response["shutdown"].asBool());
+    }
+    daemon.join();
+    CHECK(status == 0);
+
+    filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "shared_instance.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Maps a segment's header for writing, as a client would.
+ */
+static SharedInstanceHeader* mapHeader(const string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    CHECK(fd >= 0);
+    void* header = mmap(nullptr, sizeof(SharedInstanceHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(header != MAP_FAILED);
+    return static_cast<SharedInstanceHeader*>(header);
+}
+
+/**
+ * Shared memory instances: round trip of the columns and the solution, header validation, and
+ * a client changing the header after the segment was opened.
+ */
+int main() {
+    string name = "/knapsack-test-" + to_string(getpid());
+    unsigned int weights[] = {5, 4, 6, 3, 7}, profits[] = {10, 7, 8, 3, 9};
+    string error;
+    CHECK(createSharedInstance(name, weights, profits, 5, 12, &error));
+
+    {
+        SharedInstance instance;
+        CHECK(instance.open(name, &error));
+        CHECK(instance.size() == 5);
+        CHECK(instance.capacity() == 12);
+        CHECK(instance.state() == SharedPending);
+        CHECK(memcmp(instance.weights(), weights, sizeof(weights)) == 0);
+        CHECK(memcmp(instance.profits(), profits, sizeof(profits)) == 0);
+
+        // A client that rewrites n and the capacity cannot move the solver's offsets
+        SharedInstanceHeader* header = mapHeader(name);
+        header->n = 1ULL << 40;
+        header->capacity = 1;
+        CHECK(instance.size() == 5);
+        CHECK(instance.capacity() == 12);
+
+        bool used[] = {true, true, false, false, false};
+        CHECK(instance.writeSolution(used, SharedOptimal, 17) == 9);
+        CHECK(instance.state() == SharedOptimal);
+        CHECK(instance.profit() == 17);
+        CHECK(header->weight == 9);
+        CHECK(instance.selected(0) && instance.selected(1) && !instance.selected(2));
+
+        // ... but the next open rejects the header
+        CHECK(!SharedInstance().open(name));
+        header->n = 5;
+        CHECK(SharedInstance().open(name));
+        memcpy(header->magic, "XXXX", 4);
+        CHECK(!SharedInstance().open(name, &error));
+        CHECK(!error.empty());
+        munmap(header, sizeof(SharedInstanceHeader));
+    }
+
+    shm_unlink(name.c_str());
+    CHECK(!SharedInstance().open(name));
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <fstream>
+#include <vector>
+#include "solution_cache.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief Solves an instance with default options.
+ */
+static KnapsackSolution solve(const Solver& solver, const KnapsackInstance& instance) {
+    KnapsackSolution solution;
+    solver.solve(instance, KnapsackOptions(), solution);
+    return solution;
+}
+
+static bool sameSolution(const KnapsackSolution& a, const KnapsackSolution& b) {
+    return a.selected == b.selected && a.profit == b.profit && a.weight == b.weight && a.status == b.status;
+}
+
+/**
+ * Solution cache: in-memory hits and eviction, what is not stored, item order in the key, and
+ * the on-disk table shared between caches (including its growth).
+ */
+int main() {
+    unique_ptr<Solver> dp = Solver::create("dp");
+    unique_ptr<Solver> greedy = Solver::create("greedy");
+    CHECK(dp != nullptr && greedy != nullptr);
+    KnapsackOptions options;
+
+    vector<unsigned int> weights = {5, 4, 6, 3, 7, 2}, profits = {10, 7, 8, 3, 9, 2};
+    KnapsackInstance instance(weights, profits, 12);
+    KnapsackSolution solved = solve(*dp, instance);
+    SolutionKey key = solutionKey(*dp, options, instance);
+
+    SolutionCache cache(2);
+    KnapsackSolution found;
+    CHECK(!cache.lookup(key, instance, found));
+    cache.store(key, instance, solved);
+    CHECK(cache.lookup(key, instance, found));
+    CHECK(sameSolution(found, solved));
+    CHECK(cache.stats().memoryHits == 1 && cache.stats().misses == 1 && cache.stats().stores == 1);
+
+    // The same items in another order are another solve
+    vector<unsigned int> reversedWeights(weights.rbegin(), weights.rend()), reversedProfits(profits.rbegin(), profits.rend());
+    KnapsackInstance reversed(reversedWeights, reversedProfits, 12);
+    SolutionKey reversedKey = solutionKey(*dp, options, reversed);
+    CHECK(reversedKey.hash != key.hash);
+    CHECK(!cache.lookup(reversedKey, reversed, found));
+
+    // Settings only matter for heuristics
+    KnapsackOptions threaded;
+    threaded.threads = 4;
+    CHECK(solutionKey(*dp, threaded, instance).hash == key.hash);
+    CHECK(solutionKey(*greedy, threaded, instance).hash != solutionKey(*greedy, options, instance).hash);
+
+    // Cancelled runs are not stored
+    KnapsackSolution cancelled = solved;
+    cancelled.status = SolveStatus::Cancelled;
+    cache.store(reversedKey, reversed, cancelled);
+    CHECK(!cache.lookup(reversedKey, reversed, found));
+
+    // The least recently used entry is evicted
+    vector<unsigned int> otherWeights = {1, 2, 3}, otherProfits = {3, 2, 1};
+    KnapsackInstance other(otherWeights, otherProfits, 4);
+    SolutionKey otherKey = solutionKey(*dp, options, other);
+    cache.store(reversedKey, reversed, solve(*dp, reversed));
+    cache.store(otherKey, other, solve(*dp, other));
+    CHECK(cache.stats().entries == 2);
+    CHECK(cache.stats().evictions == 1);
+    CHECK(!cache.lookup(key, instance, found));
+    CHECK(cache.lookup(otherKey, other, found));
+
+    // A second cache on the same file sees the first one's solutions, across table growth
+    filesystem::path directory = testDirectory("solution_cache");
+    string file = (directory / "solutions.cache").string();
+    vector<vector<unsigned int>> columns;
+    {
+        SolutionCache writer;
+        string error;
+        CHECK(writer.open(file, &error));
+        for (unsigned int k = 0; k < 500; k++) {
+            columns.push_back({k + 1, 2 * k + 3, k % 7 + 1, 9});
+        }
+        for (unsigned int k = 0; k < columns.size(); k++) {
+            KnapsackInstance item(columns[k], columns[(k + 1) % columns.size()], 10 + k);
+            writer.store(solutionKey(*dp, options, item), item, solve(*dp, item));
+        }
+    }
+    SolutionCache reader;
+    CHECK(reader.open(file));
+    for (unsigned int k = 0; k < columns.size(); k++) {
+        KnapsackInstance item(columns[k], columns[(k + 1) % columns.size()], 10 + k);
+        CHECK(reader.lookup(solutionKey(*dp, options, item), item, found));
+        CHECK(sameSolution(found, solve(*dp, item)));
+    }
+    CHECK(reader.stats().diskHits == columns.size());
+
+    // A file that is not a table is refused
+    string garbage = (directory / "garbage.cache").string();
+    ofstream(garbage) << string(4096, 'x');
+    CHECK(!SolutionCache().open(garbage));
+
+    filesystem::remove_all(directory);
+    return 0;
+}
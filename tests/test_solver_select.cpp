@@ -0,0 +1,116 @@
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "solver_select.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * @brief The estimate of one method.
+ */
+static const CostEstimate& estimateOf(const vector<CostEstimate>& estimates, const string& solver) {
+    for (const CostEstimate& estimate : estimates) {
+        if (estimate.solver == solver) return estimate;
+    }
+    CHECK(false);
+    return estimates.front();
+}
+
+/**
+ * Cost-model selection: features, estimates, the memory budget, the model files, learning from
+ * the portfolio log, and knapsackAuto returning the optimum.
+ */
+int main() {
+    // Features ignore items heavier than the capacity
+    unsigned int values[] = {10, 20, 30, 99}, weights[] = {1, 2, 3, 50};
+    InstanceFeatures features = computeFeatures(values, weights, 4, 10);
+    CHECK(features.n == 4 && features.maxWeight == 10);
+    CHECK(features.profitSum == 60 && features.weightSum == 6);
+    CHECK(fabs(features.correlation - 1.0) < 1e-9);
+    unsigned int reversed[] = {30, 20, 10, 1};
+    CHECK(computeFeatures(reversed, weights, 4, 10).correlation < -0.99);
+
+    // One estimate per method, brute force only for small n, and the choice is the cheapest applicable one
+    CostModel model;
+    for (unsigned int n : {10u, 40u, 200u}) {
+        InstanceFeatures f{n, 1000, 50ull * n, 50ull * n, 0.5};
+        vector<CostEstimate> estimates = estimateCosts(f, model);
+        CHECK(estimates.size() == 6);
+        CHECK(estimateOf(estimates, "bf").applicable == (n <= 25));
+        CHECK(estimateOf(estimates, "mitm").applicable == (n <= 44));
+        CHECK(estimateOf(estimates, "ilp").applicable);
+        string selected = selectSolver(f, model);
+        const CostEstimate& chosen = estimateOf(estimates, selected);
+        CHECK(chosen.applicable);
+        for (const CostEstimate& estimate : estimates) {
+            CHECK(!estimate.applicable || estimate.seconds >= chosen.seconds);
+        }
+    }
+
+    // A method over the memory budget is not considered; branch-and-bound always is
+    InstanceFeatures wide{100, 1000000000, 5000, 5000000000ull, 0.0};
+    model.memoryLimit = 1e6;
+    CHECK(!estimateOf(estimateCosts(wide, model), "dp").applicable);
+    CHECK(selectSolver(wide, model) != "dp");
+    model.memoryLimit = 0;
+    CHECK(selectSolver(wide, model) == "ilp");
+
+    // Model files round-trip; a missing file is reported and leaves the model alone
+    filesystem::path directory = testDirectory("solver_select");
+    CostModel saved;
+    saved.nsPerSubset = 1.25;
+    saved.nsPerDenseCell = 7.5;
+    saved.memoryLimit = 123456;
+    CHECK(saveCostModel((directory / "model.csv").string(), saved));
+    CostModel loaded;
+    CHECK(loadCostModel((directory / "model.csv").string(), loaded));
+    CHECK(loaded.nsPerSubset == 1.25 && loaded.nsPerDenseCell == 7.5 && loaded.memoryLimit == 123456);
+    CHECK(loaded.nsPerBnBNode == saved.nsPerBnBNode);
+    CHECK(!loadCostModel((directory / "missing.csv").string(), loaded));
+    CHECK(loaded.nsPerSubset == 1.25);
+
+    // A race won slower than predicted raises the winner's unit cost; short races are skipped
+    CHECK(learnFromPortfolioLog((directory / "missing.log").string(), loaded) == -1);
+    {
+        ofstream log(directory / "portfolio.log");
+        log << "50,10000,2500,0.5,dp,10\n"
+            << "50,10000,2500,0.5,dp,0.0001\n";
+    }
+    CostModel learned;
+    double before = learned.nsPerDenseCell;
+    CHECK(learnFromPortfolioLog((directory / "portfolio.log").string(), learned) == 1);
+    CHECK(learned.nsPerDenseCell > before);
+    filesystem::remove_all(directory);
+
+    // knapsackAuto is exact whatever it selects
+    mt19937 rng(34);
+    for (int run = 0; run < 50; run++) {
+        unsigned int n = 1 + rng() % 40;
+        vector<unsigned int> v(n), w(n);
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            w[i] = 1 + rng() % 200;
+            v[i] = 1 + rng() % 200;
+            total += w[i];
+        }
+        unsigned int capacity = total / 2;
+        vector<char> used(n), reference(n);
+        SolveStatus status;
+        unsigned int value = knapsackAuto(v.data(), w.data(), n, capacity, reinterpret_cast<bool*>(used.data()), nullptr, &status);
+        CHECK(value == knapsackDP1(v.data(), w.data(), n, capacity, reinterpret_cast<bool*>(reference.data())));
+        CHECK(status == SolveStatus::Optimal);
+        unsigned long long weight = 0, sum = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            if (used[i]) {
+                weight += w[i];
+                sum += v[i];
+            }
+        }
+        CHECK(weight <= capacity && sum == value);
+    }
+    return 0;
+}
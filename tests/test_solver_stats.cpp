@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+#include "algorithms.h"
+#include "json.h"
+#include "knapsack.h"
+#include "test.h"
+
+using namespace std;
+
+/**
+ * Solver statistics: the counters each solver family reports through Solver::solve(), scopes
+ * routing a thread's counters, merging, and the JSON form.
+ */
+int main() {
+    mt19937 rng(40);
+    const unsigned int n = 20, capacity = 500;
+    vector<unsigned int> weights(n), profits(n);
+    for (unsigned int i = 0; i < n; i++) {
+        weights[i] = 1 + rng() % 100;
+        profits[i] = 1 + rng() % 100;
+    }
+    KnapsackInstance instance(weights, profits, capacity);
+    KnapsackSolution solution;
+
+    // Dense DP: one row of cells per item after the first, three tables of unsigned ints
+    SolverStats dp = Solver::create("dp-vector")->solve(instance, KnapsackOptions(), solution);
+    CHECK(dp.dpCells == (unsigned long long) (n - 1) * capacity);
+    CHECK(dp.peakMemoryBytes == 3ULL * n * (capacity + 1) * sizeof(unsigned int));
+    CHECK(dp.nodesCreated == 0 && dp.subsetsEnumerated == 0);
+    CHECK(dp.preprocessSeconds >= 0 && dp.solveSeconds >= 0 && dp.reconstructSeconds >= 0);
+
+    SolverStats bf = Solver::create("bf")->solve(instance, KnapsackOptions(), solution);
+    CHECK(bf.subsetsEnumerated > 0 && bf.dpCells == 0);
+    SolverStats ilp = Solver::create("ilp")->solve(instance, KnapsackOptions(), solution);
+    CHECK(ilp.nodesCreated > 0 && ilp.boundEvaluations > 0 && ilp.incumbentUpdates > 0);
+    CHECK(ilp.nodesExpanded <= ilp.nodesCreated);
+
+    // An empty instance is answered without running the solver
+    SolverStats empty = Solver::create("dp-vector")->solve(KnapsackInstance(), KnapsackOptions(), solution);
+    CHECK(empty.dpCells == 0 && empty.peakMemoryBytes == 0);
+
+    // Counters go to the innermost scope of the calling thread, and nowhere without one
+    vector<char> used(n);
+    SolverStats outer, inner;
+    {
+        SolverStatsScope outerScope(&outer);
+        {
+            SolverStatsScope innerScope(&inner);
+            knapsackDP1(profits.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()));
+        }
+        CHECK(currentSolverStats() == &outer);
+        knapsackDP1(profits.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()));
+    }
+    CHECK(currentSolverStats() == nullptr);
+    knapsackDP1(profits.data(), weights.data(), n, capacity, reinterpret_cast<bool*>(used.data()));
+    CHECK(inner.dpCells == dp.dpCells && outer.dpCells == dp.dpCells);
+
+    // Merging adds the counters and keeps the larger peak
+    SolverStats merged = dp;
+    merged.merge(ilp);
+    CHECK(merged.dpCells == dp.dpCells && merged.nodesCreated == ilp.nodesCreated);
+    CHECK(merged.peakMemoryBytes == max(dp.peakMemoryBytes, ilp.peakMemoryBytes));
+    merged.merge(dp);
+    CHECK(merged.dpCells == 2 * dp.dpCells);
+
+    JsonValue json;
+    CHECK(JsonValue::parse(solverStatsJSON(merged), json));
+    CHECK(json["dp_cells"].asNumber() == merged.dpCells);
+    CHECK(json["nodes_created"].asNumber() == merged.nodesCreated);
+    CHECK(json["peak_bytes"].asNumber() == merged.peakMemoryBytes);
+    CHECK(json["solve_ms"].isNumber());
+    return 0;
+}
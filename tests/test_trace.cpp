@@ -0,0 +1,103 @@
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include "json.h"
+#include "knapsack.h"
+#include "test.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief Parses a Chrome trace file and returns its events.
+ */
+static vector<JsonValue> readTrace(const filesystem::path& path) {
+    ifstream file(path);
+    stringstream text;
+    text << file.rdbuf();
+    JsonValue trace;
+    string error;
+    if (!JsonValue::parse(text.str(), trace, &error)) cerr << error << endl;
+    CHECK(trace.isObject() && trace["traceEvents"].isArray());
+    return trace["traceEvents"].items();
+}
+
+/**
+ * @brief Complete events of a given name.
+ */
+static size_t countEvents(const vector<JsonValue>& events, const string& name) {
+    size_t count = 0;
+    for (const JsonValue& event : events) {
+        if (event["ph"].asString() == "X" && event["name"].asString() == name) count++;
+    }
+    return count;
+}
+
+/**
+ * Chrome traces: nothing is recorded while disabled, solver phases, DP row blocks and named
+ * portfolio threads appear as valid trace JSON, rings keep the most recent events, and a
+ * restart discards the previous trace.
+ */
+int main() {
+    filesystem::path directory = testDirectory("trace");
+    mt19937 rng(42);
+    const unsigned int n = 200;
+    vector<unsigned int> weights(n), profits(n);
+    for (unsigned int i = 0; i < n; i++) {
+        weights[i] = 1 + rng() % 100;
+        profits[i] = 1 + rng() % 100;
+    }
+    KnapsackInstance instance(weights, profits, 2000);
+    KnapsackSolution solution;
+
+    { TraceScope scope("disabled", "test"); }
+    CHECK(!traceEnabled());
+    CHECK(writeChromeTrace((directory / "empty.json").string()));
+    CHECK(readTrace(directory / "empty.json").empty());
+
+    startTrace();
+    CHECK(traceEnabled());
+    Solver::create("dp-vector")->solve(instance, KnapsackOptions(), solution);
+    Solver::create("portfolio")->solve(instance, KnapsackOptions(), solution);
+    stopTrace();
+    { TraceScope scope("after stop", "test"); }
+    CHECK(writeChromeTrace((directory / "solve.json").string()));
+    vector<JsonValue> events = readTrace(directory / "solve.json");
+    CHECK(countEvents(events, "preprocess") > 0 && countEvents(events, "solve") > 0 && countEvents(events, "reconstruct") > 0);
+    CHECK(countEvents(events, "dp rows") >= (n - 1 + 63) / 64);
+    CHECK(countEvents(events, "race") > 0 && countEvents(events, "after stop") == 0);
+    set<string> threads;
+    for (const JsonValue& event : events) {
+        if (event["ph"].asString() == "M") threads.insert(event["args"]["name"].asString());
+        if (event["ph"].asString() != "X") continue;
+        CHECK(event["ts"].asNumber(-1) >= 0 && event["dur"].asNumber(-1) >= 0);
+        if (event["name"].asString() == "dp rows") CHECK(event["args"]["first"].isNumber());
+    }
+    CHECK(threads.count("portfolio ilp") == 1);
+
+    // A ring keeps its thread's most recent events
+    startTrace();
+    thread([]() {
+        setTraceThreadName("flood");
+        for (int k = 0; k < 100000; k++) {
+            TraceScope scope("flood", "test", "k", k);
+        }
+    }).join();
+    stopTrace();
+    CHECK(writeChromeTrace((directory / "flood.json").string()));
+    events = readTrace(directory / "flood.json");
+    size_t flood = countEvents(events, "flood");
+    CHECK(flood > 0 && flood < 100000);
+    CHECK(countEvents(events, "preprocess") == 0);
+    long long last = -1;
+    for (const JsonValue& event : events) {
+        if (event["name"].asString() == "flood") last = max(last, (long long) event["args"]["k"].asNumber());
+    }
+    CHECK(last == 99999);
+
+    CHECK(!writeChromeTrace((directory / "missing" / "trace.json").string()));
+    filesystem::remove_all(directory);
+    return 0;
+}
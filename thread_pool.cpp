@@ -0,0 +1,133 @@
+#include "thread_pool.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief Index of the pool worker running on this thread, or -1 outside the pool.
+ */
+static thread_local int currentWorker = -1;
+static thread_local const ThreadPool* currentPool = nullptr;
+
+/**
+ * @brief Starts the workers.
+ *
+ * @param threads Number of worker threads (0 = one per hardware thread).
+ */
+ThreadPool::ThreadPool(unsigned int threads) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    for (unsigned int t = 0; t < threads; t++) {
+        queues.push_back(make_unique<Queue>());
+    }
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back(&ThreadPool::run, this, t);
+    }
+}
+
+/**
+ * @brief Waits for the queued tasks to finish and stops the workers.
+ */
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (thread& worker : workers) worker.join();
+}
+
+/**
+ * @brief Queues a task, on the caller's own deque when called from a worker of this pool.
+ *
+ * @param task Function to run on a worker thread.
+ */
+void ThreadPool::submit(function<void()> task) {
+    unsigned int index = (currentPool == this && currentWorker >= 0)
+                         ? (unsigned int) currentWorker
+                         : nextQueue.fetch_add(1) % queues.size();
+    pending.fetch_add(1);
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        lock_guard<mutex> guard(sleepLock);
+    }
+    wakeUp.notify_one();
+}
+
+/**
+ * @brief Takes a task from the worker's own deque, or steals one from another worker.
+ *
+ * @param index Index of the calling worker.
+ * @param task Output task.
+ * @return True if a task was found.
+ */
+bool ThreadPool::popTask(unsigned int index, function<void()>& task) {
+    {
+        Queue& own = *queues[index];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (unsigned int k = 1; k < queues.size(); k++) {
+        Queue& victim = *queues[(index + k) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Worker loop: run tasks until the pool stops.
+ *
+ * @param index Index of this worker.
+ */
+void ThreadPool::run(unsigned int index) {
+    currentWorker = index;
+    currentPool = this;
+    setTraceThreadName("pool worker " + to_string(index));
+    function<void()> task;
+    while (true) {
+        if (popTask(index, task)) {
+            {
+                TraceScope trace("task", "pool");
+                task();
+            }
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                lock_guard<mutex> guard(sleepLock);
+                idle.notify_all();
+            }
+            continue;
+        }
+        unique_lock<mutex> guard(sleepLock);
+        if (stopping) return;
+        // Re-check under the lock so a submit between the failed pop and the wait is not missed
+        bool queued = false;
+        for (auto& queue : queues) {
+            lock_guard<mutex> queueGuard(queue->lock);
+            if (!queue->tasks.empty()) {
+                queued = true;
+                break;
+            }
+        }
+        if (!queued) wakeUp.wait(guard);
+    }
+}
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ */
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(sleepLock);
+    idle.wait(guard, [&]() { return pending.load() == 0; });
+}
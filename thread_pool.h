@@ -0,0 +1,74 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a task deque. Tasks submitted from a worker go to the back of its own deque,
+ * other submissions are spread round-robin. A worker pops from the back of its own deque (most
+ * recent first, for cache locality) and, when that is empty, steals from the front of the others.
+ * Worker threads live as long as the pool, so thread-local scratch buffers are reused across tasks.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threads Number of worker threads (0 = one per hardware thread).
+     */
+    explicit ThreadPool(unsigned int threads = 0);
+
+    /**
+     * @brief Waits for the queued tasks to finish and stops the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution.
+     * @param task Function to run on a worker thread.
+     */
+    void submit(function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     */
+    void wait();
+
+    /**
+     * @brief Number of worker threads.
+     */
+    unsigned int size() const { return workers.size(); }
+
+private:
+    struct Queue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    void run(unsigned int index);
+    bool popTask(unsigned int index, function<void()>& task);
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> workers;
+    mutex sleepLock;
+    condition_variable wakeUp;
+    condition_variable idle;
+    atomic<unsigned long long> pending{0};
+    atomic<unsigned int> nextQueue{0};
+    bool stopping = false;
+};
+
+#endif //THREAD_POOL_H
@@ -0,0 +1,188 @@
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "json.h"
+#include "trace.h"
+
+using namespace std;
+
+/**
+ * @brief Events kept per thread (a power of two).
+ */
+static const unsigned long long traceCapacity = 1 << 15;
+
+/**
+ * @struct TraceBuffer
+ * @brief Ring of one thread's events. Only the owning thread writes events and head.
+ */
+struct TraceBuffer {
+    unsigned int tid;
+    string name;  ///< Name given by setTraceThreadName(), empty for "thread N"
+    atomic<unsigned long long> head{0};
+    TraceEvent events[traceCapacity];
+};
+
+/**
+ * @struct TraceRegistry
+ * @brief Every ring ever handed out. Rings of finished threads are reused by new threads of the
+ * same name, so short-lived workers (portfolio racers, local search threads) do not grow the
+ * trace's memory and keep a stable track per role.
+ */
+struct TraceRegistry {
+    mutex lock;
+    vector<unique_ptr<TraceBuffer>> buffers;
+    vector<TraceBuffer*> released;
+    long long epoch = 0;
+};
+
+static TraceRegistry& traceRegistry() {
+    // Never destroyed: threads may release their rings during static destruction
+    static TraceRegistry* registry = new TraceRegistry();
+    return *registry;
+}
+
+/**
+ * @struct ThreadTrace
+ * @brief The calling thread's ring (acquired on its first event) and its name.
+ */
+struct ThreadTrace {
+    TraceBuffer* buffer = nullptr;
+    string name;
+
+    ~ThreadTrace() { release(); }
+
+    TraceBuffer* acquire() {
+        TraceRegistry& registry = traceRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        for (size_t k = 0; k < registry.released.size(); k++) {
+            if (registry.released[k]->name == name) {
+                buffer = registry.released[k];
+                registry.released.erase(registry.released.begin() + k);
+                return buffer;
+            }
+        }
+        registry.buffers.emplace_back(new TraceBuffer());
+        buffer = registry.buffers.back().get();
+        buffer->tid = registry.buffers.size();
+        buffer->name = name;
+        return buffer;
+    }
+
+    void release() {
+        if (buffer == nullptr) return;
+        TraceRegistry& registry = traceRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        registry.released.push_back(buffer);
+        buffer = nullptr;
+    }
+};
+
+static ThreadTrace& threadTrace() {
+    static thread_local ThreadTrace trace;
+    return trace;
+}
+
+/**
+ * @brief The flag TraceScope checks before recording.
+ */
+atomic<bool>& traceFlag() {
+    static atomic<bool> flag{false};
+    return flag;
+}
+
+/**
+ * @brief Starts recording, discarding the events of any previous trace.
+ */
+void startTrace() {
+    TraceRegistry& registry = traceRegistry();
+    {
+        lock_guard<mutex> guard(registry.lock);
+        for (auto& buffer : registry.buffers) buffer->head.store(0, memory_order_relaxed);
+        registry.epoch = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    traceFlag().store(true);
+}
+
+/**
+ * @brief Stops recording; the events stay available to writeChromeTrace().
+ */
+void stopTrace() {
+    traceFlag().store(false);
+}
+
+/**
+ * @brief Names the calling thread in the trace (the default is "thread N").
+ */
+void setTraceThreadName(const string& name) {
+    ThreadTrace& trace = threadTrace();
+    if (trace.name == name) return;
+    // The next event picks a ring of the new name
+    trace.release();
+    trace.name = name;
+}
+
+/**
+ * @brief Records a complete event on the calling thread's ring buffer.
+ *
+ * @param name Event name.
+ * @param category Event category.
+ * @param start Start of the event.
+ * @param end End of the event.
+ * @param argName Name of an integer argument shown with the event, or nullptr.
+ * @param arg Argument value.
+ */
+void traceComplete(const char* name, const char* category, chrono::steady_clock::time_point start,
+                   chrono::steady_clock::time_point end, const char* argName, long long arg) {
+    ThreadTrace& trace = threadTrace();
+    TraceBuffer* buffer = trace.buffer != nullptr ? trace.buffer : trace.acquire();
+    unsigned long long head = buffer->head.load(memory_order_relaxed);
+    TraceEvent& event = buffer->events[head & (traceCapacity - 1)];
+    event.name = name;
+    event.category = category;
+    event.argName = argName;
+    event.arg = arg;
+    event.start = chrono::duration_cast<chrono::nanoseconds>(start.time_since_epoch()).count();
+    event.duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    buffer->head.store(head + 1, memory_order_release);
+}
+
+/**
+ * @brief Writes the recorded events as Chrome trace JSON.
+ *
+ * Timestamps are microseconds since startTrace(); each ring becomes one thread track.
+ *
+ * @param filename Output file.
+ * @return True if the file was written.
+ */
+bool writeChromeTrace(const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+
+    TraceRegistry& registry = traceRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* separator = "\n";
+    file << fixed << setprecision(3);
+    for (auto& buffer : registry.buffers) {
+        unsigned long long head = buffer->head.load(memory_order_acquire);
+        if (head == 0) continue;
+        file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+             << ",\"args\":{\"name\":" << jsonQuote(buffer->name.empty() ? "thread " + to_string(buffer->tid) : buffer->name) << "}}";
+        separator = ",\n";
+        for (unsigned long long k = head - min(head, traceCapacity); k < head; k++) {
+            const TraceEvent& event = buffer->events[k & (traceCapacity - 1)];
+            file << separator << "{\"name\":" << jsonQuote(event.name) << ",\"cat\":" << jsonQuote(event.category)
+                 << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"ts\":" << (event.start - registry.epoch) / 1000.0 << ",\"dur\":" << event.duration / 1000.0;
+            if (event.argName != nullptr) {
+                file << ",\"args\":{" << jsonQuote(event.argName) << ":" << event.arg << "}";
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
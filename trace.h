@@ -0,0 +1,147 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+using namespace std;
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * Scoped trace events written as Chrome trace JSON (open the file in Perfetto or chrome://tracing).
+ *
+ * Every thread records into its own fixed-size ring buffer, so recording takes no lock and never
+ * allocates after the thread's first event; when a ring is full the oldest events are overwritten.
+ * While tracing is off a scope costs one relaxed atomic load. Solver phases (preprocess, solve,
+ * reconstruct) are emitted by SolverStatsRecorder, so they need a build with KNAPSACK_STATS on.
+ */
+
+/**
+ * @struct TraceEvent
+ * @brief One complete ("X") event. Names must be string literals or otherwise outlive the trace.
+ */
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    const char* argName;  ///< Name of the single integer argument, or nullptr
+    long long arg;
+    long long start;      ///< steady_clock nanoseconds
+    long long duration;   ///< Nanoseconds
+};
+
+/**
+ * @brief The flag TraceScope checks before recording.
+ */
+atomic<bool>& traceFlag();
+
+/**
+ * @brief Whether events are being recorded.
+ */
+inline bool traceEnabled() { return traceFlag().load(memory_order_relaxed); }
+
+/**
+ * @brief Starts recording, discarding the events of any previous trace.
+ */
+void startTrace();
+
+/**
+ * @brief Stops recording; the events stay available to writeChromeTrace().
+ */
+void stopTrace();
+
+/**
+ * @brief Names the calling thread in the trace (the default is "thread N").
+ */
+void setTraceThreadName(const string& name);
+
+/**
+ * @brief Records a complete event on the calling thread's ring buffer.
+ *
+ * @param name Event name.
+ * @param category Event category.
+ * @param start Start of the event.
+ * @param end End of the event.
+ * @param argName Name of an integer argument shown with the event, or nullptr.
+ * @param arg Argument value.
+ */
+void traceComplete(const char* name, const char* category, chrono::steady_clock::time_point start,
+                   chrono::steady_clock::time_point end, const char* argName = nullptr, long long arg = 0);
+
+/**
+ * @brief Writes the recorded events as Chrome trace JSON.
+ *
+ * Call it once the traced threads are idle; a thread still recording may tear its newest events.
+ *
+ * @param filename Output file.
+ * @return True if the file was written.
+ */
+bool writeChromeTrace(const string& filename);
+
+/**
+ * @class TraceScope
+ * @brief Records an event spanning the lifetime of the scope, if tracing was on when it began.
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category, const char* argName = nullptr, long long arg = 0)
+        : name(name), category(category), argName(argName), arg(arg), active(traceEnabled()) {
+        if (active) start = chrono::steady_clock::now();
+    }
+    ~TraceScope() {
+        if (active) traceComplete(name, category, start, chrono::steady_clock::now(), argName, arg);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    const char* argName;
+    long long arg;
+    bool active;
+    chrono::steady_clock::time_point start;
+};
+
+/**
+ * @class TraceBlocks
+ * @brief Splits a long loop into one event per block of iterations (DP rows, search nodes).
+ *
+ * Call step() with the 0-based iteration index at the top of every iteration and finish() after
+ * the loop (or let the destructor do it); each block becomes an event whose argument "first" is
+ * the block's first index.
+ */
+class TraceBlocks {
+public:
+    TraceBlocks(const char* name, const char* category, unsigned long long blockSize)
+        : name(name), category(category), blockSize(blockSize), active(traceEnabled()) {}
+    ~TraceBlocks() { finish(); }
+    TraceBlocks(const TraceBlocks&) = delete;
+    TraceBlocks& operator=(const TraceBlocks&) = delete;
+
+    void step(unsigned long long index) {
+        if (!active || index % blockSize != 0) return;
+        auto now = chrono::steady_clock::now();
+        if (open) traceComplete(name, category, start, now, "first", first);
+        open = true;
+        first = index;
+        start = now;
+    }
+
+    /**
+     * @brief Records the block in progress; later steps start a new one.
+     */
+    void finish() {
+        if (open) traceComplete(name, category, start, chrono::steady_clock::now(), "first", first);
+        open = false;
+    }
+
+private:
+    const char* name;
+    const char* category;
+    unsigned long long blockSize;
+    bool active;
+    bool open = false;
+    unsigned long long first = 0;
+    chrono::steady_clock::time_point start;
+};
+
+#endif //TRACE_H
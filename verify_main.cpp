@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "arguments.h"
+#include "dataset.h"
+#include "data_loader.h"
+#include "batch.h"
+#include "generator.h"
+#include "solvers.h"
+
+using namespace std;
+
+/**
+ * @brief Solvers that return the canonical optimum: highest profit, then fewest pallets, then the
+ * lowest sum of pallet indices. Other exact solvers are only checked on profit.
+ */
+static const set<string> canonicalSolvers = {"bf", "dp", "dp-static", "dp-vector", "mitm", "dp-sparse", "ilp", "portfolio"};
+
+/**
+ * @brief Solvers too slow for the randomized cross-check (they run for a fixed time).
+ */
+static const set<string> timedSolvers = {"ga", "sa"};
+
+/**
+ * @brief Tie-breaking key of a selection: profit, number of pallets and sum of 0-based indices.
+ */
+struct Selection {
+    unsigned long long profit = 0;
+    unsigned long long weight = 0;
+    unsigned long long count = 0;
+    unsigned long long sumIds = 0;
+    vector<unsigned int> ids;   ///< Selected 0-based indices, ascending
+
+    bool sameKey(const Selection& other) const {
+        return profit == other.profit && count == other.count && sumIds == other.sumIds;
+    }
+};
+
+/**
+ * @brief Outcome of reading an OptimalSolution file.
+ */
+enum class ReferenceFile { Missing, Read, Malformed };
+
+/**
+ * @brief Strips the spaces and tabs around a field.
+ */
+static string trim(const string& field) {
+    size_t first = field.find_first_not_of(" \t\r");
+    if (first == string::npos) return "";
+    return field.substr(first, field.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Reads an OptimalSolution file ("id, weight, profit" per line, 1-based IDs).
+ *
+ * @return Missing if the file cannot be opened, Malformed if a line is not three non-negative
+ * integers with a positive ID (a broken file must not abort the whole check).
+ */
+static ReferenceFile readReference(const string& filename, Selection& reference) {
+    ifstream file(filename);
+    if (!file.is_open()) return ReferenceFile::Missing;
+    string line;
+    while (getline(file, line)) {
+        if (trim(line).empty()) continue;
+        stringstream ss(line);
+        string id, weight, profit, rest;
+        getline(ss, id, ',');
+        getline(ss, weight, ',');
+        getline(ss, profit, ',');
+        unsigned int index, pallet, value;
+        if (getline(ss, rest) || !parseCount(trim(id), index) || index == 0 ||
+            !parseCount(trim(weight), pallet) || !parseCount(trim(profit), value)) {
+            return ReferenceFile::Malformed;
+        }
+        index--;
+        reference.ids.push_back(index);
+        reference.weight += pallet;
+        reference.profit += value;
+        reference.count++;
+        reference.sumIds += index;
+    }
+    sort(reference.ids.begin(), reference.ids.end());
+    return ReferenceFile::Read;
+}
+
+/**
+ * @brief Runs a solver in a child process and collects its selection.
+ *
+ * The child sends back the returned profit and one byte per pallet; it is killed by SIGALRM
+ * after the timeout, so one slow solver/instance pair cannot stall the whole check.
+ *
+ * @param returned Output: the profit the solver returned (checked against its selection).
+ * @param timedOut Output: true if the child was killed (the selection is then empty).
+ */
+static Selection runSolver(const SolverInfo& solver, vector<unsigned int> values, vector<unsigned int> weights,
+                           unsigned int maxWeight, unsigned int timeout, unsigned int& returned, bool& timedOut) {
+    unsigned int n = values.size();
+    vector<char> used(n, 0);
+    Selection selection;
+    returned = 0;
+    timedOut = false;
+
+    int fds[2];
+    if (pipe(fds) != 0) return selection;
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(timeout);
+        unsigned int profit = solver.solve(values.data(), weights.data(), n, maxWeight, reinterpret_cast<bool*>(used.data()));
+        bool ok = write(fds[1], &profit, sizeof(profit)) == sizeof(profit);
+        for (size_t sent = 0; ok && sent < n;) {
+            ssize_t k = write(fds[1], used.data() + sent, n - sent);
+            ok = k > 0;
+            sent += max<ssize_t>(k, 0);
+        }
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    vector<char> message(sizeof(returned) + n);
+    size_t got = 0;
+    while (pid > 0 && got < message.size()) {
+        ssize_t k = read(fds[0], message.data() + got, message.size() - got);
+        if (k <= 0) break;
+        got += k;
+    }
+    close(fds[0]);
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    if (got < message.size()) {
+        timedOut = pid > 0 && WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM;
+        returned = UINT_MAX;
+        return selection;
+    }
+    memcpy(&returned, message.data(), sizeof(returned));
+
+    for (unsigned int i = 0; i < n; i++) {
+        if (!message[sizeof(returned) + i]) continue;
+        selection.ids.push_back(i);
+        selection.profit += values[i];
+        selection.weight += weights[i];
+        selection.count++;
+        selection.sumIds += i;
+    }
+    return selection;
+}
+
+/**
+ * @brief Formats a selection as "profit P, K pallets {ids}" with 1-based IDs.
+ */
+static string describe(const Selection& selection) {
+    ostringstream out;
+    out << "profit " << selection.profit << ", " << selection.count << " pallets {";
+    for (size_t k = 0; k < selection.ids.size(); k++) {
+        out << (k ? " " : "") << selection.ids[k] + 1;
+    }
+    out << "}";
+    return out.str();
+}
+
+/**
+ * @brief Checks one solver's answer against the reference and returns an empty string or the problem.
+ *
+ * Every answer must be feasible and return the profit of its own selection. Exact solvers must
+ * match the optimal profit, canonical ones also the tie-breaking key; heuristics must not beat
+ * the optimum and must keep their guarantee (1/2 for greedy, 0.9 for the FPTAS).
+ */
+static string check(const SolverInfo& solver, const Selection& got, unsigned int returned, const Selection& reference,
+                    unsigned int maxWeight) {
+    if (got.weight > maxWeight) return "overweight: " + to_string(got.weight) + " > " + to_string(maxWeight);
+    if (returned != got.profit) return "returned " + to_string(returned) + " but selected " + describe(got);
+    if (got.profit > reference.profit) return "beats the optimum: " + describe(got) + " vs " + describe(reference);
+    if (solver.exact) {
+        if (got.profit != reference.profit) return "expected " + describe(reference) + ", got " + describe(got);
+        if (canonicalSolvers.count(solver.name) && !got.sameKey(reference)) {
+            return "tie-break: expected " + describe(reference) + ", got " + describe(got);
+        }
+    } else if (solver.name == "greedy" && 2 * got.profit < reference.profit) {
+        return "below 1/2 of the optimum: " + describe(got);
+    } else if (solver.name == "fptas" && got.profit < 0.9 * reference.profit) {
+        return "below 0.9 of the optimum: " + describe(got);
+    }
+    return "";
+}
+
+/**
+ * @brief Entry point of knapsack_verify.
+ *
+ * Usage: knapsack_verify [--datasets DIR]... [--random N] [--seed S] [--timeout SECONDS]
+ *
+ * Every registered solver is run on every dataset and compared with its OptimalSolution_<id>.txt
+ * (or, where there is none, with brute force or dynamic programming). Then N random small
+ * instances of every generator family are solved by every fast solver and cross-checked against
+ * brute force. Every run is a child process killed after the timeout, which counts as skipped.
+ * Prints one line per failure or skip and a summary; the exit status is 1 on any failure.
+ */
+int main(int argc, char* argv[]) {
+    vector<string> directories = {"../datasets", "../datasets-extra"};
+    bool customDirectories = false;
+    unsigned int randomInstances = 200;
+    unsigned long long seed = 1;
+    unsigned int timeout = 20;
+    for (int i = 1; i < argc; i += 2) {
+        string option = argv[i];
+        if (option != "--datasets" && option != "--random" && option != "--seed" && option != "--timeout") {
+            cerr << "Unknown option: " << option << endl;
+            return 2;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[i + 1];
+        bool valid = true;
+        if (option == "--datasets") {
+            if (!customDirectories) directories.clear();
+            customDirectories = true;
+            directories.push_back(value);
+        } else if (option == "--random") {
+            valid = parseCount(value, randomInstances);
+        } else if (option == "--seed") {
+            valid = parseCount(value, ULLONG_MAX, seed);
+        } else {
+            valid = parseCount(value, timeout) && timeout > 0;
+        }
+        if (!valid) {
+            cerr << "Invalid value for " << option << ": " << value << endl;
+            return 2;
+        }
+    }
+
+    unsigned int checks = 0, failures = 0, skipped = 0;
+    auto report = [&](const string& instance, const string& solver, const string& problem) {
+        checks++;
+        if (problem.empty()) return;
+        failures++;
+        cout << "FAIL " << instance << " " << solver << ": " << problem << endl;
+    };
+    auto verify = [&](const string& instance, const SolverInfo& solver, const vector<unsigned int>& values,
+                      const vector<unsigned int>& weights, unsigned int maxWeight, const Selection& reference) {
+        unsigned int returned;
+        bool timedOut;
+        Selection got = runSolver(solver, values, weights, maxWeight, timeout, returned, timedOut);
+        if (timedOut) {
+            skipped++;
+            cout << "SKIP " << instance << " " << solver.name << ": no answer within " << timeout << " s" << endl;
+            return;
+        }
+        report(instance, solver.name, check(solver, got, returned, reference, maxWeight));
+    };
+
+    for (const string& directory : directories) {
+        string prefix = filesystem::path(directory).filename().string();
+        for (const BatchJob& job : discoverBatchJobs(directory)) {
+            vector<Pallet> pallets;
+            Truck truck;
+            string error;
+            if (!load_instance(job.palletsFile, job.truckFile, pallets, truck, &error)) {
+                cerr << error << endl;
+                continue;
+            }
+            unsigned int n = min<size_t>(truck.pallets, pallets.size());
+            unsigned int maxWeight = truck.capacity;
+            vector<unsigned int> values(n), weights(n);
+            for (unsigned int i = 0; i < n; i++) {
+                values[i] = pallets[i].profit;
+                weights[i] = pallets[i].weight;
+            }
+
+            string name = prefix + "/" + job.name;
+            Selection reference;
+            string referenceFile = (filesystem::path(directory) / ("OptimalSolution_" + job.name + ".txt")).string();
+            ReferenceFile read = readReference(referenceFile, reference);
+            if (read == ReferenceFile::Malformed) {
+                report(name, "reference", "malformed OptimalSolution file");
+                continue;
+            }
+            if (read == ReferenceFile::Missing) {
+                const SolverInfo* oracle = findSolver(n <= 25 ? "bf" : "dp");
+                if (!oracle->fits(values.data(), weights.data(), n, maxWeight)) oracle = findSolver("ilp");
+                unsigned int returned;
+                bool timedOut;
+                reference = runSolver(*oracle, values, weights, maxWeight, timeout, returned, timedOut);
+                if (timedOut || returned == UINT_MAX) {
+                    skipped++;
+                    cout << "SKIP " << name << ": no reference solution" << endl;
+                    continue;
+                }
+            } else if (reference.weight > maxWeight) {
+                report(name, "reference", "overweight reference solution");
+                continue;
+            } else if (!reference.ids.empty() && reference.ids.back() >= n) {
+                report(name, "reference", "pallet ID out of range");
+                continue;
+            }
+
+            for (const SolverInfo& solver : knapsackSolvers()) {
+                if (solver.fits(values.data(), weights.data(), n, maxWeight)) verify(name, solver, values, weights, maxWeight, reference);
+            }
+        }
+    }
+
+    const SolverInfo* oracle = findSolver("bf");
+    mt19937_64 rng(seed);
+    for (unsigned int run = 0; run < randomInstances; run++) {
+        GeneratorOptions options;
+        options.family = generatorFamilies()[run % generatorFamilies().size()];
+        options.n = 1 + rng() % 18;
+        options.range = 2 + rng() % 40;
+        options.seed = rng();
+        options.capacityRatio = 0.1 + (rng() % 80) / 100.0;
+        vector<unsigned int> values, weights;
+        unsigned int maxWeight = generateInstance(options, weights, values);
+
+        string name = "random-" + to_string(run) + "-" + options.family;
+        unsigned int returned;
+        bool timedOut;
+        Selection reference = runSolver(*oracle, values, weights, maxWeight, timeout, returned, timedOut);
+        for (const SolverInfo& solver : knapsackSolvers()) {
+            if (timedSolvers.count(solver.name) || !solver.fits(values.data(), weights.data(), options.n, maxWeight)) continue;
+            verify(name, solver, values, weights, maxWeight, reference);
+        }
+    }
+
+    cout << checks - failures << "/" << checks << " checks passed, " << skipped << " skipped" << endl;
+    return failures == 0 ? 0 : 1;
+}